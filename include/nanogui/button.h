@@ -171,7 +171,7 @@ protected:
     std::vector<Button *> mButtonGroup;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Button)
 };
 
 NAMESPACE_END(nanogui)
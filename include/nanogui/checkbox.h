@@ -122,7 +122,7 @@ protected:
     std::function<void(bool)> mCallback;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(CheckBox)
 };
 
 NAMESPACE_END(nanogui)
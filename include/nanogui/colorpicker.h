@@ -121,7 +121,7 @@ protected:
     Button *mResetButton;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ColorPicker)
 };
 
 NAMESPACE_END(nanogui)
@@ -108,7 +108,7 @@ protected:
     std::function<void(const Color &)> mCallback;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ColorWheel)
 };
 
 NAMESPACE_END(nanogui)
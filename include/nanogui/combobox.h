@@ -85,7 +85,7 @@ protected:
     int mSelectedIndex;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ComboBox)
 };
 
 NAMESPACE_END(nanogui)
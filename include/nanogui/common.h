@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <array>
 #include <vector>
+#include <functional>
 
 /* Set to 1 to draw boxes around widgets */
 //#define NANOGUI_SHOW_WIDGET_BOUNDS 1
@@ -371,10 +372,15 @@ class CheckBox;
 class ColorWheel;
 class ColorPicker;
 class ComboBox;
+class Console;
+class DataColumn;
+class DataGrid;
+class EventRecorder;
 class GLFramebuffer;
 class GLShader;
 class GridLayout;
 class GroupLayout;
+class Heatmap;
 class ImagePanel;
 class ImageView;
 class Label;
@@ -385,15 +391,19 @@ class Popup;
 class PopupButton;
 class ProgressBar;
 class Screen;
+class ScreenLock;
 class Serializer;
 class Slider;
 class StackedWidget;
 class TabHeader;
 class TabWidget;
 class TextBox;
+class TextEditor;
 class GLCanvas;
+class PlotCanvas;
 class Theme;
 class ToolButton;
+class Validator;
 class VScrollPanel;
 class Widget;
 class Window;
@@ -419,11 +429,19 @@ extern NANOGUI_EXPORT void shutdown();
 /**
  * \brief Enter the application main loop
  *
+ * Each iteration first runs expired timers and the tasks submitted via \ref
+ * async(), which is also where coroutines (see \ref spawn()) waiting for a
+ * delay, a background job, or the next frame are resumed. Both run while
+ * holding a \ref ScreenLock. Input events are then dispatched to each screen
+ * under the lock of that screen, and all visible screens are redrawn.
+ *
  * \param refresh
  *     NanoGUI issues a redraw call whenever an keyboard/mouse/.. event is
- *     received. In the absence of any external events, it enforces a redraw
- *     once every ``refresh`` milliseconds. To disable the refresh timer,
- *     specify a negative value here.
+ *     received, a timer expires (see \ref addTimer()) or a widget requests
+ *     another animation frame (see \ref scheduleRedraw()). In the absence of
+ *     any of these, it enforces a redraw once every ``refresh`` milliseconds.
+ *     To disable the refresh timer, specify zero or a negative value here;
+ *     an idle application then does not wake up at all.
  *
  * \param detach
  *     This parameter only exists in the Python bindings. When the active
@@ -457,9 +475,101 @@ extern NANOGUI_EXPORT void mainloop(int refresh = 50);
 /// Request the application main loop to terminate (e.g. if you detached mainloop).
 extern NANOGUI_EXPORT void leave();
 
+/**
+ * \brief Limit the rate at which the main loop redraws
+ *
+ * After an input event wakes up the main loop, further events arriving
+ * before the next frame is due are collected and coalesced (see
+ * \ref Screen::setEventCoalescing()) instead of triggering one redraw each.
+ *
+ * \param fps
+ *     The target frame rate. A negative value selects the refresh rate of
+ *     the primary monitor, and ``0`` (the default) disables frame pacing.
+ */
+extern NANOGUI_EXPORT void setFrameRateLimit(float fps);
+
+/// Return the frame rate limit of the main loop (see \ref setFrameRateLimit())
+extern NANOGUI_EXPORT float frameRateLimit();
+
+/**
+ * \brief Render each \ref Screen on a thread of its own
+ *
+ * By default, the main loop draws all screens one after the other, so that
+ * waiting for the vertical sync of one window delays all others. When this
+ * option is enabled, each screen renders and swaps buffers on a separate
+ * thread with vsync enabled (see \ref Screen::startRenderThread()), while
+ * events are still dispatched on the main thread. Screens that are created
+ * while the option is active share textures, buffers and shader programs
+ * with the first screen, hence it should be enabled before creating them.
+ */
+extern NANOGUI_EXPORT void setThreadedRendering(bool value);
+
+/// Return whether screens are rendered on separate threads (see \ref setThreadedRendering())
+extern NANOGUI_EXPORT bool threadedRendering();
+
+/**
+ * \brief Register a callback that runs on the main loop thread after a delay
+ *
+ * The main loop sleeps until the earliest pending timer (or input event), so
+ * timers are the preferred way to implement periodic updates. Callbacks run
+ * while holding a \ref ScreenLock, hence they may modify widgets even when
+ * threaded rendering is enabled. This function is thread-safe.
+ *
+ * \param delay
+ *     Time until the callback runs (in seconds)
+ *
+ * \param callback
+ *     The function to invoke. A redraw of all screens follows immediately.
+ *
+ * \param repeat
+ *     Should the callback be invoked periodically every \c delay seconds?
+ *     The period is at least one millisecond.
+ *
+ * \return
+ *     An identifier that can be passed to \ref removeTimer()
+ */
+extern NANOGUI_EXPORT int addTimer(double delay, const std::function<void()> &callback,
+                                   bool repeat = false);
+
+/// Cancel a timer previously registered using \ref addTimer()
+extern NANOGUI_EXPORT void removeTimer(int id);
+
+/**
+ * \brief Request that the main loop redraws within \c delay seconds
+ *
+ * Widgets that animate (e.g. a fading tooltip) call this function from their
+ * draw method to receive another frame. Requests are merged, and only the
+ * earliest deadline is kept until the next frame is drawn. This function is
+ * thread-safe.
+ */
+extern NANOGUI_EXPORT void scheduleRedraw(double delay = 0.0);
+
 /// Return whether or not a main loop is currently active
 extern NANOGUI_EXPORT bool active();
 
+/**
+ * \brief Return the time (in seconds) seen by interaction logic such as
+ * double-click detection and tooltip delays
+ *
+ * This is the GLFW timer, unless another clock was installed using \ref
+ * setTimeSource().
+ */
+extern NANOGUI_EXPORT double getTime();
+
+/**
+ * \brief Replace the clock returned by \ref getTime()
+ *
+ * \ref EventRecorder::replay() uses this to present recorded timestamps to
+ * the widgets, which makes replayed interactions deterministic. An empty
+ * function restores the GLFW timer. Must be called on the main loop thread.
+ *
+ * Rendering threads call \ref getTime() as well, so the clock must be
+ * thread-safe. It is invoked while holding a lock that this function also
+ * acquires: once it returns, the previous clock is no longer in use. The
+ * clock must therefore be cheap and must not call \ref setTimeSource().
+ */
+extern NANOGUI_EXPORT void setTimeSource(const std::function<double()> &source);
+
 /**
  * \brief Open a native file open/save dialog.
  *
@@ -521,7 +631,15 @@ extern NANOGUI_EXPORT std::array<char, 8> utf8(int c);
 extern NANOGUI_EXPORT std::vector<std::pair<int, std::string>>
     loadImageDirectory(NVGcontext *ctx, const std::string &path);
 
-/// Convenience function for instanting a PNG icon from the application's data segment (via bin2c)
+/**
+ * \brief Convenience function for instantiating a PNG icon from the
+ * application's data segment
+ *
+ * Expects the arrays \c name_png and \c name_png_size that
+ * <tt>resources/bin2c.cmake</tt> generates for \c name.png. The library's
+ * own resources are instead compressed by <tt>resources/respack.cpp</tt>
+ * (LZ4) and accessed via \ref resource().
+ */
 #define nvgImageIcon(ctx, name) nanogui::__nanogui_get_image(ctx, #name, name##_png, name##_png_size)
 
 /// Helper function used by nvgImageIcon
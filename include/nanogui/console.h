@@ -0,0 +1,162 @@
+/*
+    nanogui/console.h -- Scrolling log view that accepts lines from any thread
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Console console.h nanogui/console.h
+ *
+ * \brief Scrolling view of the most recent lines of a log
+ *
+ * \ref append() may be called from any thread at a high rate: it pushes the
+ * line onto a lock-free list and returns. The next \ref draw() moves pending
+ * lines into a ring buffer that holds at most \ref capacity() lines (older
+ * lines are discarded) and wraps only these new lines. Drawing then lays out
+ * the rows in view, so its cost does not depend on the number of lines.
+ *
+ * While the console isn't drawn (e.g. when it is hidden), at most \ref
+ * capacity() lines are kept pending: once that many have accumulated, \ref
+ * append() discards them, and the next \ref flush() adds a line reporting
+ * how many lines were dropped.
+ *
+ * A \ref filter() restricts the view to lines containing a given string.
+ * Changing it re-scans the buffer on a background worker thread (see \ref
+ * background()); the view switches over once the scan has finished, and
+ * lines arriving in the meantime are checked as they come in.
+ *
+ * While scrolled to the bottom, the view follows new lines.
+ */
+class NANOGUI_EXPORT Console : public Widget {
+public:
+    Console(Widget *parent, size_t capacity = 10000);
+    virtual ~Console();
+
+    /// Append text; line breaks start new lines (thread-safe, lock-free)
+    void append(const std::string &text);
+
+    /// Remove all lines
+    void clear();
+
+    /// Return the maximum number of lines kept
+    size_t capacity() const { return mRing.size(); }
+    /// Set the maximum number of lines kept (discards the oldest lines if needed)
+    void setCapacity(size_t capacity);
+
+    /// Return the number of lines in the buffer (excluding those not drawn yet)
+    size_t lineCount() const { return mCount; }
+    /// Return the number of lines that pass the filter
+    size_t visibleLineCount() const { return mView.size(); }
+    /// Return the text of a line in the buffer (0 is the oldest)
+    const std::string &line(size_t index) const { return *entry(mFirstSeq + index).text; }
+
+    /// Return the filter string (empty: show all lines)
+    const std::string &filter() const { return mFilter; }
+    /// Show only lines that contain the given string
+    void setFilter(const std::string &filter);
+    /// Is a filter scan running on a worker thread?
+    bool filterPending() const { return mFilterPending; }
+
+    /// Move all pending lines into the buffer (called by \ref draw())
+    void flush();
+
+    /// Set the \ref Theme used to draw this widget
+    virtual void setTheme(Theme *theme) override;
+
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual void draw(NVGcontext* ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// A line that was appended but not yet moved into the ring buffer
+    struct PendingLine {
+        std::string text;
+        PendingLine *next;
+    };
+
+    struct Entry {
+        std::shared_ptr<const std::string> text;
+        int rows = 0;       /* Wrapped rows (0: not measured yet) */
+        bool match = true;  /* Passes the current filter */
+    };
+
+    /// A line in view; 'row' is its first row, counted since the view was built
+    struct ViewItem {
+        uint64_t seq;
+        uint64_t row;
+    };
+
+    /// Result of a filter scan, written by the worker thread
+    struct FilterResult {
+        std::atomic<bool> ready { false };
+        uint64_t endSeq = 0;               /* Lines before this one were scanned */
+        std::vector<uint64_t> matches;     /* Sequence numbers of matching lines */
+    };
+
+    Entry &entry(uint64_t seq) { return mRing[(mFirst + (size_t) (seq - mFirstSeq)) % mRing.size()]; }
+    const Entry &entry(uint64_t seq) const { return mRing[(mFirst + (size_t) (seq - mFirstSeq)) % mRing.size()]; }
+
+    /// Delete a list of pending lines and return their number
+    static size_t deleteLines(PendingLine *line);
+    /// Add a line to the ring buffer, discarding the oldest line if full
+    void push(std::string &&text);
+    /// Does a line pass the current filter?
+    bool matches(const std::string &text) const;
+    /// Rebuild the view from the 'match' flags of all entries
+    void rebuildView();
+    /// Apply the result of a finished filter scan
+    void applyFilterResult();
+    /// Assign rows to the view items that don't have one yet
+    void measureView(NVGcontext *ctx);
+    /// Return the first row of the view
+    uint64_t firstRow() const { return mView.empty() ? mRowEnd : mView.front().row; }
+    /// Return the largest valid value of 'mScrollRow'
+    double maxScrollRow() const;
+    /// Return the index of the measured view item containing the given row
+    size_t itemAtRow(double row) const;
+
+protected:
+    std::atomic<PendingLine *> mPending;
+    std::atomic<size_t> mPendingCount;     /* Lines in 'mPending' (approximately) */
+    std::atomic<size_t> mPendingLimit;     /* Copy of capacity() for append() */
+    std::atomic<uint64_t> mDropped;        /* Pending lines discarded by append() */
+
+    std::vector<Entry> mRing;
+    size_t mFirst, mCount;
+    uint64_t mFirstSeq;           /* Sequence number of the oldest line */
+
+    std::deque<ViewItem> mView;
+    size_t mViewMeasured;         /* Number of leading view items with a row */
+    uint64_t mRowEnd;             /* Row following the last measured item */
+
+    std::string mFilter;
+    bool mFilterPending;
+    std::shared_ptr<FilterResult> mFilterResult;
+
+    float mWrapWidth;
+    float mLineHeight;
+    double mScrollRow;            /* Topmost visible row (fractional) */
+    bool mFollow;
+    bool mDragScrollbar;
+};
+
+NAMESPACE_END(nanogui)
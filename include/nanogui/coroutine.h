@@ -0,0 +1,126 @@
+/*
+    nanogui/coroutine.h -- Cooperative tasks that run on the main loop thread
+    and suspend while waiting for background jobs, timers, or frames
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/taskqueue.h>
+#include <exception>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \brief Run a function on a pool of background worker threads
+ *
+ * The pool is created on first use and has one thread per hardware thread.
+ * Jobs must not touch the widget tree; use \ref nanogui::async() to hand
+ * results back to the main loop, or \ref awaitWorker() from a coroutine.
+ * This function is thread-safe.
+ */
+extern NANOGUI_EXPORT void background(const std::function<void()> &job);
+
+/**
+ * \brief Start a coroutine on the main loop thread
+ *
+ * The function \c func starts running immediately on a stack of its own,
+ * until it suspends itself using one of the <tt>await*()</tt> functions
+ * below. At that point, \ref spawn() returns, and the main loop resumes the
+ * coroutine once the awaited event has happened. Event handlers can thus
+ * run long operations (file parsing, solver runs, ...) step by step without
+ * ever stalling event handling and redraws:
+ *
+ * \code
+ * button->setCallback([label] {
+ *     spawn([label] {
+ *         label->setCaption("Loading..");
+ *         Mesh mesh = awaitWorker([] { return loadMesh("bunny.obj"); });
+ *         label->setCaption(std::to_string(mesh.size()) + " triangles");
+ *     });
+ * });
+ * \endcode
+ *
+ * The coroutine always runs while holding a \ref ScreenLock, hence it may
+ * modify widgets even when threaded rendering is enabled. Exceptions derived
+ * from \c std::exception that escape \c func are reported on \c stderr;
+ * other exceptions are re-thrown by the code that resumed the coroutine
+ * (i.e. \ref spawn() or the main loop). Must be called on the main loop
+ * thread (or before the main loop starts).
+ *
+ * \param stackSize
+ *     Size of the coroutine's stack in bytes (0 selects the default of
+ *     1-2 MiB). Note that the stack cannot grow.
+ */
+extern NANOGUI_EXPORT void spawn(const std::function<void()> &func, size_t stackSize = 0);
+
+/// Is the calling code running within a coroutine started by \ref spawn()?
+extern NANOGUI_EXPORT bool inCoroutine();
+
+/**
+ * \brief Suspend the current coroutine until \c resume is called
+ *
+ * This is the building block of the other <tt>await*()</tt> functions.
+ * \c schedule receives a function that resumes the coroutine; it must be
+ * invoked exactly once, on the main loop thread (e.g. from a timer, or via
+ * \ref nanogui::async()). Throws ``std::runtime_error`` when not called
+ * within a coroutine.
+ */
+extern NANOGUI_EXPORT void awaitCallback(
+    const std::function<void(const std::function<void()> &resume)> &schedule);
+
+/// Suspend the current coroutine until the beginning of the next frame
+extern NANOGUI_EXPORT void awaitNextFrame();
+
+/// Suspend the current coroutine for (at least) the given number of seconds
+extern NANOGUI_EXPORT void awaitDelay(double seconds);
+
+NAMESPACE_BEGIN(detail)
+template <typename T> struct WorkerResult {
+    std::unique_ptr<T> value;
+    template <typename Func> void run(Func &func) { value.reset(new T(func())); }
+    T get() { return std::move(*value); }
+};
+
+template <> struct WorkerResult<void> {
+    template <typename Func> void run(Func &func) { func(); }
+    void get() { }
+};
+NAMESPACE_END(detail)
+
+/**
+ * \brief Run \c func on a background thread (see \ref background()) and
+ * suspend the current coroutine until it has finished
+ *
+ * Returns the result of \c func, or re-throws the exception it raised.
+ */
+template <typename Func> auto awaitWorker(Func func) -> decltype(func()) {
+    detail::WorkerResult<decltype(func())> result;
+    std::exception_ptr error;
+
+    /* The coroutine's stack (and thus 'result') stays alive while suspended */
+    awaitCallback([&](const std::function<void()> &resume) {
+        background([&, resume] {
+            try {
+                result.run(func);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            async(resume);
+        });
+    });
+
+    if (error)
+        std::rethrow_exception(error);
+    return result.get();
+}
+
+NAMESPACE_END(nanogui)
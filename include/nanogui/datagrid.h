@@ -0,0 +1,322 @@
+/*
+    nanogui/datagrid.h -- Table view of large columnar data sets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+#include <nanogui/numeric.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class DataColumn datagrid.h nanogui/datagrid.h
+ *
+ * \brief A column of values shown by a \ref DataGrid
+ *
+ * Columns are shared with the worker threads that sort and filter a \ref
+ * DataGrid, hence they are held by \c std::shared_ptr rather than \ref ref,
+ * and their values must not change while the grid uses them (call \ref
+ * DataGrid::refresh() after modifying them).
+ */
+class NANOGUI_EXPORT DataColumn {
+public:
+    virtual ~DataColumn() = default;
+
+    /// Return the number of rows
+    virtual size_t size() const = 0;
+
+    /// Are the values numbers? (they are then aligned to the right)
+    virtual bool numeric() const { return false; }
+
+    /**
+     * \brief Return the text of a cell and store its length in \c length
+     *
+     * Implementations may format the value into \c buffer, which holds
+     * \ref NumberBufferSize bytes, and return it.
+     */
+    virtual const char *text(size_t row, char *buffer, size_t &length) const = 0;
+
+    /// Does the text of a cell contain the given string?
+    virtual bool contains(size_t row, const std::string &needle) const;
+
+    /// Sort row indices by value; equal values are ordered by row index
+    virtual void sort(uint32_t *begin, uint32_t *end, bool ascending) const = 0;
+
+    /// Merge two consecutive ranges of row indices sorted by \ref sort()
+    virtual void merge(uint32_t *begin, uint32_t *middle, uint32_t *end, bool ascending) const = 0;
+};
+
+NAMESPACE_BEGIN(detail)
+
+template <typename T>
+const char *column_text(const T &value, char *buffer, size_t &length, const char *, std::true_type /* integral */) {
+    length = formatNumber(buffer, value);
+    return buffer;
+}
+
+template <typename T>
+const char *column_text(const T &value, char *buffer, size_t &length, const char *format, std::false_type /* floating point */) {
+    length = formatNumber(buffer, NumberBufferSize, (double) value, format);
+    return buffer;
+}
+
+inline const char *column_text(const std::string &value, char *, size_t &length, const char *) {
+    length = value.size();
+    return value.data();
+}
+
+template <typename T>
+const char *column_text(const T &value, char *buffer, size_t &length, const char *format) {
+    return column_text(value, buffer, length, format, std::is_integral<T>());
+}
+
+/* Missing values (NaNs) are placed last regardless of the sort direction */
+template <typename T> bool column_missing(const T &value, std::true_type /* floating point */) { return std::isnan(value); }
+template <typename T> bool column_missing(const T &, std::false_type) { return false; }
+template <typename T> bool column_missing(const T &value) {
+    return column_missing(value, std::is_floating_point<T>());
+}
+
+NAMESPACE_END(detail)
+
+/**
+ * \class ArrayColumn datagrid.h nanogui/datagrid.h
+ *
+ * \brief A \ref DataColumn backed by a contiguous array of values
+ *
+ * Supported value types are the arithmetic types and \c std::string. The
+ * column either owns its values, or is a view of an array owned by the
+ * caller. A view holds a reference to an owner object that keeps the array
+ * alive: worker threads of a \ref DataGrid may still be sorting the column
+ * after it was replaced or the grid was destroyed.
+ */
+template <typename T> class ArrayColumn : public DataColumn {
+public:
+    /**
+     * \brief Create a view of an array owned by the caller (nothing is copied)
+     *
+     * \c owner is kept alive as long as the column, and must keep \c data
+     * valid and unmodified, e.g. a \c std::shared_ptr to the container.
+     */
+    ArrayColumn(const T *data, size_t size, std::shared_ptr<const void> owner)
+        : mOwner(std::move(owner)), mData(data), mSize(size) { }
+
+    /// Create a column that owns its values
+    ArrayColumn(std::vector<T> values)
+        : mValues(std::move(values)), mData(mValues.data()), mSize(mValues.size()) { }
+
+    /// Return the value of a row
+    const T &operator[](size_t row) const { return mData[row]; }
+    /// Return a pointer to the values
+    const T *data() const { return mData; }
+
+    /// Return the \c printf()-style format of floating point values
+    const std::string &format() const { return mFormat; }
+    /// Set the \c printf()-style format of floating point values
+    void setFormat(const std::string &format) { mFormat = format; }
+
+    virtual size_t size() const override { return mSize; }
+
+    virtual bool numeric() const override { return std::is_arithmetic<T>::value; }
+
+    virtual const char *text(size_t row, char *buffer, size_t &length) const override {
+        return detail::column_text(mData[row], buffer, length, mFormat.c_str());
+    }
+
+    virtual bool contains(size_t row, const std::string &needle) const override {
+        char buffer[NumberBufferSize];
+        size_t length;
+        const char *str = detail::column_text(mData[row], buffer, length, mFormat.c_str());
+        return std::search(str, str + length, needle.begin(), needle.end()) != str + length;
+    }
+
+    virtual void sort(uint32_t *begin, uint32_t *end, bool ascending) const override {
+        std::sort(begin, end, Compare{ mData, ascending });
+    }
+
+    virtual void merge(uint32_t *begin, uint32_t *middle, uint32_t *end, bool ascending) const override {
+        std::inplace_merge(begin, middle, end, Compare{ mData, ascending });
+    }
+
+protected:
+    struct Compare {
+        const T *data;
+        bool ascending;
+
+        bool operator()(uint32_t a, uint32_t b) const {
+            const T &va = data[a], &vb = data[b];
+            bool ma = detail::column_missing(va), mb = detail::column_missing(vb);
+            if (ma != mb)
+                return mb;
+            if (!ma && va < vb)
+                return ascending;
+            if (!ma && vb < va)
+                return !ascending;
+            return a < b;
+        }
+    };
+
+    std::vector<T> mValues;
+    std::shared_ptr<const void> mOwner;
+    const T *mData;
+    size_t mSize;
+    std::string mFormat = "%.6g";
+};
+
+/**
+ * \class DataGrid datagrid.h nanogui/datagrid.h
+ *
+ * \brief Scrollable table of \ref DataColumn instances with millions of rows
+ *
+ * Only the cells in view are formatted and drawn, so the cost of a frame
+ * does not depend on the number of rows. Column widths are measured once
+ * from the caption and the first rows of each column and then cached.
+ *
+ * Clicking a caption sorts the rows by that column (clicking again reverses
+ * the order), and \ref setFilter() shows only rows containing a string.
+ * Both run on the worker threads of \ref background(): the rows are split
+ * into chunks that are filtered and sorted in parallel, and the last chunk
+ * to finish merges them. The previous order stays on screen until the new
+ * one replaces it in a single step; requests that are superseded before they
+ * finish are abandoned.
+ *
+ * Rows are identified by their index in the columns, which must fit into 32
+ * bits. The grid shows as many rows as its shortest column has.
+ */
+class NANOGUI_EXPORT DataGrid : public Widget {
+public:
+    DataGrid(Widget *parent);
+    virtual ~DataGrid();
+
+    /// Return the number of columns
+    size_t columnCount() const { return mColumns.size(); }
+    /// Add a column with the given caption
+    void addColumn(const std::string &caption, const std::shared_ptr<const DataColumn> &column);
+    /// Replace the data of a column (re-applies the sort order and filter)
+    void setColumn(size_t index, const std::shared_ptr<const DataColumn> &column);
+    /// Return the data of a column
+    const std::shared_ptr<const DataColumn> &column(size_t index) const { return mColumns[index].data; }
+    /// Return the caption of a column
+    const std::string &caption(size_t index) const { return mColumns[index].caption; }
+    /// Remove all columns
+    void clearColumns();
+
+    /// Return the fixed width of a column (0: measured automatically)
+    int columnWidth(size_t index) const { return mColumns[index].fixedWidth; }
+    /// Set a fixed width for a column (0: measure automatically)
+    void setColumnWidth(size_t index, int width);
+
+    /// Return the number of rows of the data
+    size_t rowCount() const;
+    /// Return the number of rows that are shown (i.e. pass the filter)
+    size_t visibleRowCount() const { return mOrder ? mOrder->rows.size() : rowCount(); }
+    /// Return the data row shown at the given position
+    size_t visibleRow(size_t index) const { return mOrder ? mOrder->rows[index] : index; }
+
+    /// Return the column by which rows are sorted (-1: unsorted)
+    int sortColumn() const { return mSortColumn; }
+    /// Are rows sorted in ascending order?
+    bool sortAscending() const { return mSortAscending; }
+    /// Sort rows by a column (-1: show rows in their original order)
+    void setSortColumn(int column, bool ascending = true);
+
+    /// Return the filter string (empty: show all rows)
+    const std::string &filter() const { return mFilter; }
+    /// Return the column searched by the filter (-1: all columns)
+    int filterColumn() const { return mFilterColumn; }
+    /// Show only rows where a column (-1: any column) contains the given string
+    void setFilter(const std::string &filter, int column = -1);
+
+    /// Is a sort or filter operation running on the worker threads?
+    bool updatePending() const { return mUpdatePending; }
+    /// Apply the results of a finished sort or filter operation (called by \ref draw())
+    void applyUpdate();
+    /// Re-apply the sort order and filter after the column values have changed
+    void refresh();
+
+    /// Return the selected data row (-1: none)
+    int selectedRow() const { return mSelectedRow; }
+    /// Select a data row (-1: none)
+    void setSelectedRow(int row) { mSelectedRow = row; }
+
+    /// The callback that is invoked when the user selects a row
+    const std::function<void(int)> &callback() const { return mCallback; }
+    /// Sets the callback that is invoked when the user selects a row
+    void setCallback(const std::function<void(int)> &callback) { mCallback = callback; }
+
+    /// Set the \ref Theme used to draw this widget
+    virtual void setTheme(Theme *theme) override;
+
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual void draw(NVGcontext* ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    struct Column {
+        std::string caption;
+        std::shared_ptr<const DataColumn> data;
+        int fixedWidth = 0;
+        int width = 0;      /* Cached width (0: not measured yet) */
+    };
+
+    /// Rows that pass the filter, in the order in which they are shown
+    struct Order {
+        uint64_t generation;
+        std::vector<uint32_t> rows;
+    };
+
+    /// Shared with the worker threads, which may outlive the widget
+    struct Mailbox {
+        std::atomic<uint64_t> generation { 0 };
+        std::shared_ptr<Order> result;  /* Accessed with std::atomic_load/store */
+    };
+
+    /// Measure the columns that don't have a cached width
+    void measureColumns(NVGcontext *ctx);
+    /// Return the height of the caption bar and of each row
+    int rowHeight() const { return (int) std::round(fontSize() * 1.4f); }
+    /// Return the total width of all columns
+    int contentWidth() const { return mColumnOffset.empty() ? 0 : mColumnOffset.back(); }
+    /// Return the size of the area showing the rows
+    Vector2i bodySize() const;
+    /// Clamp the scroll offsets to the valid range
+    void clampScroll();
+
+protected:
+    std::vector<Column> mColumns;
+    std::vector<int> mColumnOffset;    /* Left edge of every column, followed by the total width */
+
+    std::shared_ptr<const Order> mOrder;  /* Null: all rows in their original order */
+    std::shared_ptr<Mailbox> mMailbox;
+    bool mUpdatePending;
+
+    int mSortColumn;
+    bool mSortAscending;
+    std::string mFilter;
+    int mFilterColumn;
+
+    Vector2f mScroll;                  /* Scroll offset in pixels */
+    int mDragScrollbar;                /* 0: none, 1: vertical, 2: horizontal */
+    int mSelectedRow;
+    std::function<void(int)> mCallback;
+};
+
+NAMESPACE_END(nanogui)
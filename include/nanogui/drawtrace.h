@@ -0,0 +1,153 @@
+/*
+    nanogui/drawtrace.h -- Recording and replay of the command stream that
+    NanoVG sends to its rendering backend
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <memory>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class DrawTrace drawtrace.h nanogui/drawtrace.h
+ *
+ * \brief Captured NanoVG command stream of one frame
+ *
+ * While a capture is active, the rendering callbacks of a NanoVG context
+ * are intercepted, and every fill, stroke, triangle batch and texture update
+ * is recorded in its tessellated form before being forwarded to the original
+ * backend. The resulting trace no longer depends on the widget tree: it can
+ * be saved to a compact binary file (using \ref Serializer) and replayed
+ * against any NanoVG backend, e.g. the OpenGL backend of a \ref Screen or a
+ * \ref SoftwareRenderer. This makes frame-time regressions reproducible
+ * outside of the application that produced them (see the
+ * ``nanogui_replay_bench`` target and \ref Screen::recordFrame()).
+ *
+ * Textures that were created before the capture started are recorded by
+ * size only; they are replayed with placeholder contents, which does not
+ * affect the cost of drawing them.
+ */
+class NANOGUI_EXPORT DrawTrace {
+public:
+    /// Timings of one call to \ref replay() (in seconds)
+    struct Timing {
+        /// CPU time spent in the backend's fill/stroke/triangle callbacks
+        double submit = 0;
+        /// CPU time spent in the backend's flush callback
+        double flush = 0;
+    };
+
+    DrawTrace();
+    ~DrawTrace();
+
+    /**
+     * \brief Start recording the commands sent to the backend of \c ctx
+     *
+     * Clears the trace. Call this before <tt>nvgBeginFrame()</tt>.
+     * \c size and \c pixelRatio describe the frame and are used for replay.
+     */
+    void beginCapture(NVGcontext *ctx, const Vector2i &size, float pixelRatio);
+
+    /// Stop recording and restore the original backend of the context (after <tt>nvgEndFrame()</tt>)
+    void endCapture();
+
+    /// Is a capture in progress?
+    bool capturing() const { return (bool) mCapture; }
+
+    /// Write the trace to a file
+    void save(const std::string &filename) const;
+
+    /// Load a trace from a file written by \ref save()
+    void load(const std::string &filename);
+
+    /**
+     * \brief Send the recorded commands of one frame to the backend of \c ctx
+     *
+     * Textures are created in the backend on first use and reused by
+     * subsequent calls until \ref release() is called or the trace is
+     * replayed against a different context. The caller is responsible for
+     * clearing and presenting the framebuffer.
+     */
+    Timing replay(NVGcontext *ctx);
+
+    /**
+     * \brief Delete the textures that \ref replay() created in the backend
+     *
+     * Also done by the destructor, hence a trace that was replayed must be
+     * released or destroyed before the NanoVG context.
+     */
+    void release();
+
+    /// Return the size of the recorded frame in logical pixels
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the ratio of framebuffer pixels to logical pixels of the recorded frame
+    float pixelRatio() const { return mPixelRatio; }
+
+    /// Return the number of recorded draw calls (fills, strokes and triangle batches)
+    size_t callCount() const;
+
+    /// Return the number of recorded vertices
+    size_t vertexCount() const { return mVertices.size() / 4; }
+
+    /**
+     * \brief Return the CPU time of the captured frame that was spent outside
+     * of the backend (in seconds)
+     *
+     * This is the time taken by widget drawing code and by NanoVG's path
+     * flattening and tessellation.
+     */
+    double tessellationTime() const { return mTessellationTime; }
+
+    /// Return the CPU time of the captured frame that was spent in the backend's draw callbacks
+    double submitTime() const { return mSubmitTime; }
+
+    /// Return the CPU time of the captured frame that was spent in the backend's flush callback
+    double flushTime() const { return mFlushTime; }
+
+protected:
+    struct Capture;
+    friend struct Capture;
+
+    std::unique_ptr<Capture> mCapture;
+    Vector2i mSize;
+    float mPixelRatio;
+
+    /* Textures: id, type, width, height, flags, has contents (6 values each) */
+    std::vector<int32_t> mTextures;
+    std::vector<uint8_t> mTextureData;
+
+    /* Commands: 8 integers and 32 floats each (see drawtrace.cpp) */
+    std::vector<int32_t> mCallInts;
+    std::vector<float> mCallFloats;
+
+    /* Paths: closed, nbevel, nfill, nstroke, winding, convex (6 values each) */
+    std::vector<int32_t> mPaths;
+
+    /* Vertices: x, y, u, v */
+    std::vector<float> mVertices;
+
+    /* Packed pixels of texture updates */
+    std::vector<uint8_t> mUpdateData;
+
+    double mTessellationTime, mSubmitTime, mFlushTime;
+
+    /* State of the last replay() */
+    NVGcontext *mReplayContext;
+    std::vector<int> mReplayTextures;
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,122 @@
+/*
+    nanogui/eventrecorder.h -- Recording and deterministic replay of the
+    input events received by a Screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class EventRecorder eventrecorder.h nanogui/eventrecorder.h
+ *
+ * \brief Records the input events of a \ref Screen and replays them
+ *
+ * While recording, every cursor, mouse button, key, character and scroll
+ * event that GLFW delivers to the screen is stored along with a timestamp
+ * (before events are coalesced, see \ref Screen::setEventCoalescing()).
+ * Recordings can be saved to a file and replayed later, either at the
+ * recorded pace or as fast as possible. During replay, \ref getTime()
+ * returns the recorded timestamps (offset to lie after all timestamps taken
+ * before the replay), so that double clicks, drag thresholds and tooltip
+ * delays behave exactly as in the original session. This makes
+ * it possible to benchmark dragging, scrolling and typing scenarios
+ * without user interaction:
+ *
+ * \code
+ * EventRecorder recorder;
+ * recorder.load("drag_window.events");
+ * EventRecorder::Statistics stats = recorder.replay(screen);
+ * std::cout << "p99 dispatch latency: " << stats.p99 * 1000 << " ms" << std::endl;
+ * \endcode
+ */
+class NANOGUI_EXPORT EventRecorder {
+public:
+    /// Types of recorded events (the arguments of the matching GLFW callback)
+    enum class EventType {
+        CursorPos = 0, ///< x, y
+        MouseButton,   ///< button, action, modifiers
+        Key,           ///< key, scancode, action, modifiers
+        Char,          ///< codepoint
+        Scroll         ///< x, y
+    };
+
+    /// A recorded input event
+    struct Event {
+        EventType type;
+        /// Time since the start of the recording (in seconds)
+        double time;
+        double x, y;
+        int arg[4];
+    };
+
+    /// Dispatch latencies of one call to \ref replay() (in seconds)
+    struct Statistics {
+        size_t count = 0;
+        double total = 0, mean = 0, median = 0, p90 = 0, p99 = 0, max = 0;
+    };
+
+    EventRecorder();
+    ~EventRecorder();
+
+    /// Discard all recorded events and start recording the events received by \c screen
+    void start(Screen *screen);
+
+    /// Stop recording
+    void stop();
+
+    /// Is a recording in progress?
+    bool recording() const { return mScreen != nullptr; }
+
+    /// Append an event to the recording (called by \ref Screen)
+    void record(EventType type, double x, double y, int arg0 = 0, int arg1 = 0,
+                int arg2 = 0, int arg3 = 0);
+
+    /// Return the recorded events
+    const std::vector<Event> &events() const { return mEvents; }
+
+    /// Write the recorded events to a file
+    void save(const std::string &filename) const;
+
+    /// Load events from a file written by \ref save()
+    void load(const std::string &filename);
+
+    /**
+     * \brief Feed the recorded events to the event handlers of \c screen
+     *
+     * Events are dispatched directly (bypassing the event queue) with a
+     * fixed clock source (see \ref setTimeSource()), and the time taken by
+     * each dispatch is measured.
+     *
+     * \param realTime
+     *     When set, events are delivered at the recorded pace, and the screen
+     *     is redrawn while waiting for the next event. Otherwise, events are
+     *     delivered back to back without drawing.
+     *
+     * Must be called on the main loop thread while no rendering thread is
+     * active (see \ref Screen::startRenderThread()).
+     */
+    Statistics replay(Screen *screen, bool realTime = false);
+
+    /// Return the dispatch latency of each event of the last call to \ref replay()
+    const std::vector<double> &latencies() const { return mLatencies; }
+
+protected:
+    Screen *mScreen;
+    double mStartTime;
+    std::vector<Event> mEvents;
+    std::vector<double> mLatencies;
+};
+
+NAMESPACE_END(nanogui)
@@ -330,7 +330,7 @@ public:
     bool value() const { return checked(); }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 /**
@@ -359,7 +359,7 @@ public:
     void setEditable(bool e) { setEnabled(e); }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 /**
@@ -374,7 +374,7 @@ public:
     FormWidget(Widget *p) : IntBox<T>(p) { this->setAlignment(TextBox::Alignment::Right); }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 /**
@@ -389,7 +389,7 @@ public:
     FormWidget(Widget *p) : FloatBox<T>(p) { this->setAlignment(TextBox::Alignment::Right); }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 /**
@@ -406,7 +406,7 @@ public:
     }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 /**
@@ -427,7 +427,7 @@ public:
     Color value() const { return color(); }
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FormWidget)
 };
 
 NAMESPACE_END(detail)
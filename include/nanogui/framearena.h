@@ -0,0 +1,142 @@
+/*
+    nanogui/framearena.h -- Per-frame bump allocation of transient data and
+    counters for heap allocations made while drawing a frame
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class FrameArena framearena.h nanogui/framearena.h
+ *
+ * \brief Bump allocator for data that only lives until the end of the
+ * current frame
+ *
+ * Each thread owns an arena (see \ref FrameArena::thread()). Allocations
+ * simply advance a pointer into a preallocated block and are never freed
+ * individually; instead, the whole arena is rewound by \ref reset(), which
+ * the main loop does at the start of every iteration, and a rendering
+ * thread (see \ref Screen::startRenderThread()) before every frame. When a
+ * frame needs more memory than the arena holds, additional blocks are
+ * allocated from the heap and merged into a single larger block by the
+ * next call to \ref reset(). Once the arena has grown to the peak usage of
+ * a frame, steady-state frames therefore do not touch the heap at all.
+ *
+ * Memory obtained from the arena must not be kept beyond the end of the
+ * frame. Applications that draw without calling \ref mainloop() should call
+ * \ref reset() once per frame themselves.
+ */
+class NANOGUI_EXPORT FrameArena {
+public:
+    /// Size of the initial block (in bytes)
+    static const size_t BlockSize = 65536;
+
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /// Allocate \c size bytes with the given alignment (a power of two)
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t offset = (mOffset + align - 1) & ~(align - 1);
+        if (offset + size > mCapacity)
+            return allocateOverflow(size, align);
+        mOffset = offset + size;
+        return mData + offset;
+    }
+
+    /// Release all allocations of the current frame
+    void reset();
+
+    /// Return the number of bytes allocated since the last \ref reset()
+    size_t used() const { return mOffset + mOverflowUsed; }
+
+    /// Return the size of the arena's primary block (in bytes)
+    size_t capacity() const { return mCapacity; }
+
+    /// Return the arena of the calling thread
+    static FrameArena &thread();
+
+protected:
+    void *allocateOverflow(size_t size, size_t align);
+
+protected:
+    char *mData;
+    size_t mCapacity;
+    size_t mOffset;
+    /// Blocks allocated after the primary block ran out of space
+    std::vector<std::pair<char *, size_t>> mOverflow;
+    /// Offset into the last overflow block
+    size_t mOverflowOffset;
+    /// Bytes allocated from overflow blocks since the last \ref reset()
+    size_t mOverflowUsed;
+};
+
+/**
+ * \class FrameAllocator framearena.h nanogui/framearena.h
+ *
+ * \brief Standard library allocator that obtains memory from the calling
+ * thread's \ref FrameArena (see \ref frame_string and \ref frame_vector)
+ */
+template <typename T> class FrameAllocator {
+public:
+    typedef T value_type;
+
+    FrameAllocator() = default;
+    template <typename U> FrameAllocator(const FrameAllocator<U> &) { }
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(FrameArena::thread().allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /* Memory is reclaimed when the arena is reset */
+    void deallocate(T *, size_t) { }
+
+    template <typename U> bool operator==(const FrameAllocator<U> &) const { return true; }
+    template <typename U> bool operator!=(const FrameAllocator<U> &) const { return false; }
+};
+
+/// String whose storage is released at the end of the frame
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> frame_string;
+
+/// Vector whose storage is released at the end of the frame
+template <typename T> using frame_vector = std::vector<T, FrameAllocator<T>>;
+
+/// Heap allocation counters of a thread (see \ref allocationStats())
+struct AllocationStats {
+    uint64_t allocations = 0;   ///< Number of calls to <tt>operator new</tt>
+    uint64_t deallocations = 0; ///< Number of calls to <tt>operator delete</tt>
+    uint64_t bytes = 0;         ///< Total number of bytes requested
+};
+
+/**
+ * \brief Was NanoGUI compiled with allocation tracking?
+ *
+ * Counting heap allocations requires replacing the global <tt>operator
+ * new</tt> and <tt>operator delete</tt>, which is only done when the CMake
+ * option ``NANOGUI_TRACK_ALLOCATIONS`` is enabled. Otherwise, all counters
+ * remain zero. (On Windows, only allocations made from within the NanoGUI
+ * library itself are counted when it is built as a DLL.)
+ */
+extern NANOGUI_EXPORT bool allocationTracking();
+
+/// Return the heap allocations made by the calling thread so far
+extern NANOGUI_EXPORT AllocationStats allocationStats();
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,89 @@
+/*
+    nanogui/gapbuffer.h -- Text storage with cheap insertion and removal
+    near the editing position
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class GapBuffer gapbuffer.h nanogui/gapbuffer.h
+ *
+ * \brief Stores text in a single array with an unused "gap" at the
+ * editing position
+ *
+ * Insertions and removals at the gap take time proportional to the size of
+ * the edit rather than to the size of the text. Moving the gap costs time
+ * proportional to the distance it moves, which is small for the typical
+ * pattern of many edits near the cursor. Used by \ref TextEditor.
+ */
+class NANOGUI_EXPORT GapBuffer {
+public:
+    GapBuffer();
+
+    /// Return the number of bytes of text
+    size_t size() const { return mData.size() - (mGapEnd - mGapBegin); }
+
+    /// Is the buffer empty?
+    bool empty() const { return size() == 0; }
+
+    /// Return the byte at the given position
+    char operator[](size_t pos) const {
+        return mData[pos < mGapBegin ? pos : pos + (mGapEnd - mGapBegin)];
+    }
+
+    /// Insert text at the given position
+    void insert(size_t pos, const char *str, size_t length);
+
+    /// Insert text at the given position
+    void insert(size_t pos, const std::string &str) { insert(pos, str.data(), str.size()); }
+
+    /// Remove \c length bytes starting at the given position
+    void erase(size_t pos, size_t length);
+
+    /// Replace the entire contents
+    void assign(const std::string &str);
+
+    /// Return a copy of the bytes in the range <tt>[begin, end)</tt>
+    std::string substr(size_t begin, size_t end) const;
+
+    /// Return a copy of the entire text
+    std::string str() const { return substr(0, size()); }
+
+    /**
+     * \brief Return a pointer to the bytes in the range <tt>[begin, end)</tt>
+     *
+     * If the range contains the gap, the gap is moved out of the way first.
+     * The pointer remains valid until the next modification.
+     */
+    const char *data(size_t begin, size_t end);
+
+    /// Return the index of the first occurrence of 'c' at or after 'pos' (or \ref size())
+    size_t find(char c, size_t pos) const;
+
+protected:
+    /// Move the gap to the given text position
+    void moveGap(size_t pos);
+
+    /// Make sure that the gap can hold at least 'length' bytes
+    void reserveGap(size_t length);
+
+protected:
+    std::vector<char> mData;
+    size_t mGapBegin, mGapEnd;
+};
+
+NAMESPACE_END(nanogui)
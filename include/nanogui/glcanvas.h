@@ -87,7 +87,7 @@ protected:
     bool mDrawBorder;
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(GLCanvas)
 };
 
 NAMESPACE_END(nanogui)
@@ -57,7 +57,7 @@ protected:
     Color mBackgroundColor, mForegroundColor, mTextColor;
     VectorXf mValues;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Graph)
 };
 
 NAMESPACE_END(nanogui)
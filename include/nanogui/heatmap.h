@@ -0,0 +1,114 @@
+/*
+    nanogui/heatmap.h -- Scrolling heatmap / spectrogram of streamed data
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/imageview.h>
+#include <cstdint>
+#include <deque>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Heatmap heatmap.h nanogui/heatmap.h
+ *
+ * \brief Heatmap of a stream of columns, e.g. the spectrogram of a signal
+ *
+ * The widget shows the last \ref columns() columns of \ref rows() values
+ * each, the newest one on the right. The values are kept in a single-channel
+ * floating point texture that is used as a ring buffer: \ref appendColumn()
+ * only overwrites the oldest column, and the next frame uploads the columns
+ * appended since the previous one with \c glTexSubImage2D(). The fragment
+ * shader of the \ref ImageView rotates the ring so that it appears to
+ * scroll, normalizes the values and maps them to colors with a lookup
+ * texture, so that a new column never costs more than its own upload.
+ *
+ * Values are normalized by the range set with \ref setRange(), or by the
+ * minimum and maximum of the columns in view, which are tracked
+ * incrementally as columns are appended and scroll out. NaN values and
+ * columns that have not been filled yet are transparent.
+ *
+ * Row 0 is shown at the bottom. Panning, zooming and the pixel information
+ * overlay work as in \ref ImageView.
+ */
+class NANOGUI_EXPORT Heatmap : public ImageView {
+public:
+    /// Built-in color maps
+    enum class Colormap {
+        Grayscale = 0,
+        Viridis,
+        Inferno
+    };
+
+    /// Create a heatmap showing \c columns columns of \c rows values (at least one each)
+    Heatmap(Widget *parent, int columns, int rows);
+    virtual ~Heatmap();
+
+    /// The heatmap owns its texture: throws \c std::runtime_error
+    virtual void bindImage(GLuint imageId) override;
+
+    /// Return the number of columns in view
+    int columns() const { return mColumns; }
+    /// Return the number of values per column
+    int rows() const { return mRows; }
+    /// Return the number of columns appended since the last \ref clear()
+    uint64_t columnCount() const { return mCount; }
+
+    /// Append a column of \ref rows() values; the oldest column scrolls out
+    void appendColumn(const float *values);
+    /// Remove all columns
+    void clear();
+    /// Return a value (column 0 is the oldest column in view)
+    float value(int column, int row) const;
+
+    /// Is the range of values computed from the columns in view?
+    bool autoRange() const { return mAutoRange; }
+    /// Compute the range of values from the columns in view
+    void setAutoRange(bool autoRange) { mAutoRange = autoRange; }
+    /// Return the values mapped to the first and last color of the color map
+    std::pair<float, float> range() const;
+    /// Set the values mapped to the first and last color (disables \ref autoRange())
+    void setRange(float min, float max);
+
+    /// Use one of the built-in color maps
+    void setColormap(Colormap colormap);
+    /// Use a color map interpolating between the given colors (at least two)
+    void setColormap(const std::vector<Color> &colors);
+
+    virtual void draw(NVGcontext *ctx) override;
+
+protected:
+    Heatmap(Widget *parent, int columns, int rows, GLuint texture);
+
+    /// Copy the columns appended since the last frame to the texture
+    void upload();
+
+protected:
+    int mColumns, mRows;
+    GLuint mTexture, mColormap;
+
+    /* Copy of the texture: row-major, with row 0 of the heatmap last */
+    std::vector<float> mValues;
+    uint64_t mCount;                 /* Columns appended; column 'i' is stored at 'i % mColumns' */
+    uint64_t mUploaded;              /* Columns copied to the texture */
+    bool mUploadAll;                 /* Copy all of 'mValues' at the next frame */
+    std::vector<uint8_t> mColormapData;
+    bool mColormapDirty;
+
+    /* Sliding window extrema: (column, value) pairs with increasing values
+       (mMinimum) or decreasing values (mMaximum), oldest column first */
+    std::deque<std::pair<uint64_t, float>> mMinimum, mMaximum;
+    bool mAutoRange;
+    float mRangeMin, mRangeMax;
+};
+
+NAMESPACE_END(nanogui)
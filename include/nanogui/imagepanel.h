@@ -49,7 +49,7 @@ protected:
     int mMargin;
     int mMouseIndex;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ImagePanel)
 };
 
 NAMESPACE_END(nanogui)
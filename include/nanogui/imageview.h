@@ -30,7 +30,7 @@ public:
     ImageView(Widget* parent, GLuint imageID);
     ~ImageView();
 
-    void bindImage(GLuint imageId);
+    virtual void bindImage(GLuint imageId);
 
     GLShader& imageShader() { return mShader; }
 
@@ -132,6 +132,13 @@ public:
     void performLayout(NVGcontext* ctx) override;
     void draw(NVGcontext* ctx) override;
 
+protected:
+    /**
+     * Used by derived widgets that display the image with their own fragment shader.
+     * The shader receives the texture coordinates as \c uv and the image as \c image.
+     */
+    ImageView(Widget* parent, GLuint imageID, const char* fragmentShader);
+
 private:
     // Helper image methods.
     void updateImageParameters();
@@ -168,7 +175,7 @@ private:
     std::function<std::pair<std::string, Color>(const Vector2i&)> mPixelInfoCallback;
     float mFontScaleFactor = 0.2f;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ImageView)
 };
 
 NAMESPACE_END(nanogui)
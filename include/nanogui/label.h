@@ -60,7 +60,7 @@ protected:
     std::string mFont;
     Color mColor;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Label)
 };
 
 NAMESPACE_END(nanogui)
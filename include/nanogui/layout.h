@@ -348,7 +348,7 @@ protected:
     /// The margin around this GridLayout.
     int mMargin;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(GridLayout)
 };
 
 /**
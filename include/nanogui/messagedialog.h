@@ -44,7 +44,7 @@ protected:
     std::function<void(int)> mCallback;
     Label *mMessageLabel;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(MessageDialog)
 };
 
 NAMESPACE_END(nanogui)
@@ -12,9 +12,16 @@
 #pragma once
 
 #include <nanogui/common.h>
+#include <nanogui/taskqueue.h>
+#include <nanogui/coroutine.h>
+#include <nanogui/tracing.h>
+#include <nanogui/framearena.h>
+#include <nanogui/objectarena.h>
 #include <nanogui/widget.h>
 #include <nanogui/screen.h>
+#include <nanogui/zorder.h>
 #include <nanogui/theme.h>
+#include <nanogui/resources.h>
 #include <nanogui/window.h>
 #include <nanogui/layout.h>
 #include <nanogui/label.h>
@@ -27,10 +34,17 @@
 #include <nanogui/progressbar.h>
 #include <nanogui/entypo.h>
 #include <nanogui/messagedialog.h>
+#include <nanogui/validator.h>
+#include <nanogui/numeric.h>
 #include <nanogui/textbox.h>
+#include <nanogui/gapbuffer.h>
+#include <nanogui/texteditor.h>
+#include <nanogui/console.h>
+#include <nanogui/datagrid.h>
 #include <nanogui/slider.h>
 #include <nanogui/imagepanel.h>
 #include <nanogui/imageview.h>
+#include <nanogui/heatmap.h>
 #include <nanogui/vscrollpanel.h>
 #include <nanogui/colorwheel.h>
 #include <nanogui/graph.h>
@@ -39,3 +53,7 @@
 #include <nanogui/tabheader.h>
 #include <nanogui/tabwidget.h>
 #include <nanogui/glcanvas.h>
+#include <nanogui/plotcanvas.h>
+#include <nanogui/softwarerenderer.h>
+#include <nanogui/drawtrace.h>
+#include <nanogui/eventrecorder.h>
@@ -0,0 +1,130 @@
+/*
+    nanogui/numeric.h -- Locale-independent conversion between numbers and
+    their textual representation
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+NAMESPACE_BEGIN(nanogui)
+
+NAMESPACE_BEGIN(detail)
+
+template <typename T> bool is_negative(T value, std::true_type) { return value < 0; }
+template <typename T> bool is_negative(T, std::false_type) { return false; }
+
+template <typename T>
+bool parse_number(const char *it, const char *end, T &value, std::true_type /* integral */) {
+    typedef unsigned long long Unsigned;
+    while (it != end && (*it == ' ' || *it == '\t'))
+        ++it;
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+'))
+        negative = *it++ == '-';
+
+    /* Out-of-range values are clamped to the representable range */
+    const Unsigned limit = negative ? (Unsigned) 0 - (Unsigned) std::numeric_limits<T>::lowest()
+                                    : (Unsigned) std::numeric_limits<T>::max();
+    const char *start = it;
+    Unsigned result = 0;
+    bool overflow = false;
+    for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+        unsigned digit = (unsigned) (*it - '0');
+        if (overflow || digit > limit || result > (limit - digit) / 10)
+            overflow = true;
+        else
+            result = result * 10 + digit;
+    }
+    if (it == start)
+        return false;
+    if (overflow)
+        result = limit;
+    value = (T) (negative ? (Unsigned) 0 - result : result);
+    return true;
+}
+
+NANOGUI_EXPORT bool parse_double(const char *it, const char *end, double &value);
+
+template <typename T>
+bool parse_number(const char *it, const char *end, T &value, std::false_type /* floating point */) {
+    double result;
+    if (!parse_double(it, end, result))
+        return false;
+    value = (T) result;
+    return true;
+}
+
+NAMESPACE_END(detail)
+
+/// Sufficient buffer size for \ref formatNumber()
+static const size_t NumberBufferSize = 32;
+
+/**
+ * \brief Parse the number at the beginning of a character range
+ *
+ * Unlike \c std::stod() and stream extraction, the conversion does not depend
+ * on the global locale and does not allocate memory. Leading blanks and
+ * trailing characters are ignored. Returns \c false (leaving \c value
+ * unchanged) if the range does not start with a number.
+ */
+template <typename T> bool parseNumber(const char *begin, const char *end, T &value) {
+    static_assert(std::is_arithmetic<T>::value, "parseNumber(): expected a numeric type!");
+    return detail::parse_number(begin, end, value, std::is_integral<T>());
+}
+
+/// Parse the number at the beginning of a string (see \ref parseNumber())
+template <typename T> bool parseNumber(const std::string &str, T &value) {
+    return parseNumber(str.data(), str.data() + str.size(), value);
+}
+
+/**
+ * \brief Write the decimal representation of an integer to a buffer of at
+ * least \ref NumberBufferSize bytes and return its length
+ *
+ * The output is not null-terminated.
+ */
+template <typename T> size_t formatNumber(char *buffer, T value) {
+    static_assert(std::is_integral<T>::value, "formatNumber(): expected an integral type!");
+    typedef unsigned long long Unsigned;
+    bool negative = detail::is_negative(value, std::is_signed<T>());
+    Unsigned magnitude = negative ? (Unsigned) 0 - (Unsigned) value : (Unsigned) value;
+
+    char digits[NumberBufferSize], *ptr = digits + NumberBufferSize;
+    do {
+        *--ptr = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative)
+        *--ptr = '-';
+
+    size_t length = (size_t) (digits + NumberBufferSize - ptr);
+    for (size_t i = 0; i < length; ++i)
+        buffer[i] = ptr[i];
+    return length;
+}
+
+/**
+ * \brief Format a floating point value according to a \c printf()-style
+ * format string, always using '.' as the decimal separator
+ *
+ * Formats of the form <tt>%.Ng</tt> (as used by \ref FloatBox) with a
+ * precision of up to 15 digits are handled by a fast path that produces
+ * exactly the same output as \c printf(). Other formats and rare values
+ * that need exact decimal rounding fall back to \c snprintf(). The result
+ * is null-terminated; its length is returned.
+ */
+NANOGUI_EXPORT size_t formatNumber(char *buffer, size_t size, double value, const char *format);
+
+NAMESPACE_END(nanogui)
@@ -13,28 +13,79 @@
 #pragma once
 
 #include <nanogui/common.h>
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#if defined(NANOGUI_NONATOMIC_REFCOUNT)
+#  include <thread>
+#endif
 
 NAMESPACE_BEGIN(nanogui)
 
+class ObjectArena;
+
+/**
+ * \brief Declares the allocation functions of a class derived from \ref Object
+ *
+ * This is the counterpart of \c EIGEN_MAKE_ALIGNED_OPERATOR_NEW for objects:
+ * memory is aligned to \c alignof(T), but at least to \c
+ * EIGEN_MAX_ALIGN_BYTES of the translation unit that uses the macro, and
+ * comes from the active \ref ObjectArena, if any. Subclasses inherit the
+ * allocation functions of their base class, so only classes with fixed-size
+ * Eigen members that need a larger alignment than their base (e.g. \c
+ * Matrix4d with AVX when the base was compiled without it) have to use the
+ * macro. Using \c EIGEN_MAKE_ALIGNED_OPERATOR_NEW instead is also correct,
+ * but such objects are always allocated from the heap.
+ */
+#define NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(T)                                   \
+    static void *operator new(size_t size) {                                  \
+        return ::nanogui::Object::allocateObject(                             \
+            size, std::max(alignof(T), (size_t) EIGEN_MAX_ALIGN_BYTES));       \
+    }                                                                          \
+    static void operator delete(void *ptr, size_t size) noexcept {            \
+        ::nanogui::Object::deallocateObject(                                  \
+            ptr, size, std::max(alignof(T), (size_t) EIGEN_MAX_ALIGN_BYTES));  \
+    }                                                                          \
+    static void *operator new[](size_t size) {                                \
+        return ::nanogui::Object::allocateObject(                             \
+            size, std::max(alignof(T), (size_t) EIGEN_MAX_ALIGN_BYTES));       \
+    }                                                                          \
+    static void operator delete[](void *ptr, size_t size) noexcept {          \
+        ::nanogui::Object::deallocateObject(                                  \
+            ptr, size, std::max(alignof(T), (size_t) EIGEN_MAX_ALIGN_BYTES));  \
+    }                                                                          \
+    static void *operator new(size_t, void *ptr) noexcept { return ptr; }     \
+    static void operator delete(void *, void *) noexcept { }
+
 /**
  * \class Object object.h nanogui/object.h
  *
  * \brief Reference counted object base class.
+ *
+ * Reference counts are atomic by default, so that references can be
+ * passed between threads (e.g. to a rendering thread, or to tasks submitted
+ * via \ref Screen::post()). Applications that only ever touch NanoGUI
+ * objects from the main thread can enable the CMake option
+ * ``NANOGUI_NONATOMIC_REFCOUNT`` to avoid the cost of atomic operations
+ * when references are copied. Debug builds then abort when a reference
+ * count is modified on a thread other than the one that created the object.
  */
 class NANOGUI_EXPORT Object {
 public:
     /// Default constructor
-    Object() { }
+    Object();
 
     /// Copy constructor
-    Object(const Object &) : m_refCount(0) {}
+    Object(const Object &);
 
     /// Return the current reference count
     int getRefCount() const { return m_refCount; };
 
     /// Increase the object's reference count by one
-    void incRef() const { ++m_refCount; }
+    void incRef() const {
+        checkThread();
+        ++m_refCount;
+    }
 
     /** \brief Decrease the reference count of
      * the object and possibly deallocate it.
@@ -43,13 +94,56 @@ public:
      * the reference count reaches zero.
      */
     void decRef(bool dealloc = true) const noexcept;
+
+    /**
+     * \brief Allocate memory for an object of the given size and alignment
+     *
+     * Objects are allocated from the active \ref ObjectArena of the calling
+     * thread if there is one (see \ref ObjectArena::Scope), and from the
+     * heap otherwise. Called by the <tt>operator new</tt> that \ref
+     * NANOGUI_MAKE_ALIGNED_OPERATOR_NEW adds to a class.
+     */
+    static void *allocateObject(size_t size, size_t alignment);
+
+    /**
+     * \brief Release the memory of an object of the given size (returns it to
+     * its arena, if any)
+     *
+     * Arena objects are recognized by a flag that the \ref Object destructor
+     * hands over to this function, which immediately follows it. Memory from
+     * the heap is thus released without any lookup or locking.
+     */
+    static void deallocateObject(void *ptr, size_t size, size_t alignment) noexcept;
+
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Object)
 protected:
     /** \brief Virtual protected deconstructor.
      * (Will only be called by \ref ref)
      */
     virtual ~Object();
 private:
+    /* Does the object lie in the memory of an ObjectArena? (occupies
+       padding next to the reference count) */
+    bool m_inArena;
+#if defined(NANOGUI_NONATOMIC_REFCOUNT)
+    /* Plain counter (CMake option NANOGUI_NONATOMIC_REFCOUNT): references
+       must only be created and released on the thread that created the
+       object, which debug builds verify. The owner is also recorded in
+       release builds so that the layout of Object does not depend on
+       NDEBUG, which may differ between the library and the application. */
+    mutable int m_refCount = 0;
+    std::thread::id m_owner = std::this_thread::get_id();
+    void checkThread() const {
+#  if !defined(NDEBUG)
+        if (m_owner != std::this_thread::get_id())
+            threadError();
+#  endif
+    }
+    [[noreturn]] void threadError() const;
+#else
     mutable std::atomic<int> m_refCount { 0 };
+    void checkThread() const { }
+#endif
 };
 
 /**
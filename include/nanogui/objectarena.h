@@ -0,0 +1,119 @@
+/*
+    nanogui/objectarena.h -- Bulk allocation of widgets, layouts and other
+    reference counted objects
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ObjectArena objectarena.h nanogui/objectarena.h
+ *
+ * \brief Allocates the objects of a widget subtree from large contiguous
+ * chunks of memory
+ *
+ * While a \ref Scope is active, every \ref Object created with \c new on the
+ * same thread (widgets, layouts, themes, ...) is placed into the arena
+ * instead of being allocated individually from the heap. This turns the
+ * construction of large panels into pointer increments, keeps the widgets
+ * of a subtree close together in memory, and replaces thousands of calls
+ * to \c free() during teardown with the release of a few chunks:
+ *
+ * \code
+ * ref<ObjectArena> arena = new ObjectArena();
+ * {
+ *     ObjectArena::Scope scope(arena);
+ *     Window *window = new Window(screen, "Inspector");
+ *     for (int i = 0; i < 50000; ++i)
+ *         new Label(window, "Item " + std::to_string(i));
+ * }
+ * \endcode
+ *
+ * Objects are still destroyed individually by their reference counts. Each
+ * of them holds a reference to the arena, so the chunks are released in
+ * bulk once the last object is gone and no other references remain (the
+ * \c arena variable above can simply be dropped). The memory of objects
+ * that are destroyed earlier is not reused. Objects are aligned as declared
+ * with \ref NANOGUI_MAKE_ALIGNED_OPERATOR_NEW; classes that use \c
+ * EIGEN_MAKE_ALIGNED_OPERATOR_NEW instead are allocated from the heap.
+ *
+ * Arenas are not thread-safe: objects should be allocated from one thread
+ * at a time, which is the case for widgets created on the main thread.
+ * They may be destroyed on any thread.
+ */
+class NANOGUI_EXPORT ObjectArena : public Object {
+public:
+    /**
+     * \class Scope objectarena.h nanogui/objectarena.h
+     *
+     * \brief Directs the allocation of objects on the calling thread to an
+     * arena for the lifetime of the scope object (scopes can be nested)
+     */
+    class NANOGUI_EXPORT Scope {
+    public:
+        explicit Scope(ObjectArena *arena);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    protected:
+        ObjectArena *mPrevious;
+    };
+
+    /// Create an arena that allocates chunks of \c chunkSize bytes
+    explicit ObjectArena(size_t chunkSize = 256 * 1024);
+
+    /// Return the arena used by \c new on the calling thread (if any)
+    static ObjectArena *current();
+
+    /// Return the number of objects allocated from this arena that are still alive
+    size_t objectCount() const { return mObjectCount; }
+
+    /// Return the number of bytes handed out to objects so far
+    size_t bytesAllocated() const { return mBytesAllocated; }
+
+    /// Return the total size of the chunks held by the arena (in bytes)
+    size_t capacity() const { return mCapacity; }
+
+    /// Does \c ptr point into one of the chunks of this arena?
+    bool contains(const void *ptr) const;
+
+    /**
+     * \brief Allocate memory for an object (called by \ref
+     * Object::allocateObject())
+     *
+     * The memory is preceded by a pointer to the arena, which \ref
+     * Object::deallocateObject() uses to return it.
+     */
+    void *allocate(size_t size, size_t alignment);
+
+    /// Account for a destroyed object (called by \ref Object::deallocateObject())
+    void release();
+
+protected:
+    /// Release all chunks
+    virtual ~ObjectArena();
+
+protected:
+    std::vector<char *> mChunks;
+    std::vector<size_t> mChunkSizes;
+    char *mCursor, *mEnd;
+    size_t mChunkSize;
+    size_t mBytesAllocated;
+    size_t mCapacity;
+    std::atomic<size_t> mObjectCount;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,156 @@
+/*
+    nanogui/plotcanvas.h -- GPU-accelerated plot of large time series
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/glcanvas.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class PlotCanvas plotcanvas.h nanogui/plotcanvas.h
+ *
+ * \brief Plot of one or more series with millions of points, drawn by the GPU
+ *
+ * Unlike \ref Graph, which builds NanoVG paths on the CPU every frame, the
+ * points of each series are kept in OpenGL buffers. \ref append() only
+ * uploads the new points (using \c glBufferSubData()) at the next frame.
+ * Lines and point markers are drawn with instancing: every segment or marker
+ * is an instance of a quad that the vertex shader places from the segment
+ * end points, applying the pan and zoom transformation on the GPU.
+ *
+ * Each series also maintains a min/max decimation pyramid: every level
+ * halves the number of points of the previous one while keeping the
+ * extrema of each group of points. Drawing picks the coarsest level that
+ * still has about two points per pixel and draws only the points in view,
+ * so that a zoomed-out view of tens of millions of points costs about as
+ * much as a view of a few thousands.
+ *
+ * The points of a series must be appended in order of increasing \c x
+ * (otherwise the whole series is drawn). Coordinates are stored in single
+ * precision, relative to the first \c x value of the plot.
+ *
+ * Dragging with the left mouse button pans, the scroll wheel zooms the \c x
+ * axis around the cursor and the right mouse button fits the view to the
+ * data again.
+ */
+class NANOGUI_EXPORT PlotCanvas : public GLCanvas {
+public:
+    /// How the points of a series are drawn
+    enum class Style {
+        Lines = 1,
+        Points = 2,
+        LinesAndPoints = 3
+    };
+
+    PlotCanvas(Widget *parent);
+    virtual ~PlotCanvas();
+
+    /// Add a series and return its index
+    size_t addSeries(const std::string &name, const Color &color, Style style = Style::Lines);
+    /// Return the number of series
+    size_t seriesCount() const { return mSeries.size(); }
+    /// Remove all points of a series
+    void clearSeries(size_t index);
+
+    /// Append a point to a series
+    void append(size_t index, double x, float y) { append(index, &x, &y, 1); }
+    /// Append points to a series (NaN values are skipped)
+    void append(size_t index, const double *x, const float *y, size_t count);
+    /// Return the number of points of a series
+    size_t pointCount(size_t index) const { return mSeries[index].levels[0].points.size(); }
+
+    const std::string &seriesName(size_t index) const { return mSeries[index].name; }
+    void setSeriesName(size_t index, const std::string &name) { mSeries[index].name = name; }
+    const Color &seriesColor(size_t index) const { return mSeries[index].color; }
+    void setSeriesColor(size_t index, const Color &color) { mSeries[index].color = color; }
+    Style seriesStyle(size_t index) const { return mSeries[index].style; }
+    void setSeriesStyle(size_t index, Style style) { mSeries[index].style = style; }
+
+    /// Return the width of lines in pixels
+    float lineWidth() const { return mLineWidth; }
+    /// Set the width of lines in pixels
+    void setLineWidth(float width) { mLineWidth = width; }
+    /// Return the diameter of point markers in pixels
+    float pointSize() const { return mPointSize; }
+    /// Set the diameter of point markers in pixels
+    void setPointSize(float size) { mPointSize = size; }
+
+    /// Return the visible range of \c x values
+    std::pair<double, double> xRange() const { return { mXMin, mXMax }; }
+    /// Return the visible range of \c y values
+    std::pair<double, double> yRange() const { return { mYMin, mYMax }; }
+    /// Set the visible range (disables \ref autoFit()); empty ranges are widened, and non-finite ones rejected
+    void setRange(double xmin, double xmax, double ymin, double ymax);
+
+    /// Does the view follow the data as it arrives?
+    bool autoFit() const { return mAutoFit; }
+    /// Fit the view to the data now and whenever points are appended
+    void setAutoFit(bool autoFit) { mAutoFit = autoFit; }
+
+    /// Return the decimation level used by the last frame for a series (0: all points)
+    int drawnLevel(size_t index) const { return mSeries[index].drawnLevel; }
+    /// Return the number of points drawn by the last frame for a series
+    size_t drawnPointCount(size_t index) const { return mSeries[index].drawnPoints; }
+
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void drawGL() override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Points of a series at one level of the decimation pyramid, and their copy on the GPU
+    struct Level {
+        std::vector<Vector2f> points;
+        size_t uploaded = 0;    /* Number of points copied to 'buffer' */
+        size_t capacity = 0;    /* Size of 'buffer' in points */
+        GLuint buffer = 0;
+    };
+
+    struct Series {
+        std::string name;
+        Color color;
+        Style style;
+        std::vector<Level> levels;  /* Level 0 holds all points */
+        Level tail;                 /* Points not covered by the level being drawn */
+        bool sorted = true;         /* Are the x values nondecreasing? */
+        float xMin, xMax, yMin, yMax;
+        int drawnLevel = 0;
+        size_t drawnPoints = 0;
+    };
+
+    /// Add the new complete groups of a level to the next one
+    void decimate(Series &series, size_t level);
+    /// Copy new points of a level to the GPU
+    void upload(Level &level);
+    /// Draw 'count' points starting at 'first' with the current shader
+    void drawPoints(Level &level, size_t first, size_t count, bool lines);
+    /// Fit the view to the data
+    void fit();
+
+protected:
+    std::vector<Series, Eigen::aligned_allocator<Series>> mSeries;
+    std::vector<GLuint> mReleasedBuffers;  /* Deleted by the next drawGL() */
+    GLShader mLineShader, mPointShader;
+    bool mShadersReady;
+
+    double mOrigin;              /* Subtracted from x values before storing them */
+    bool mHasOrigin;
+    double mXMin, mXMax, mYMin, mYMax;
+    bool mAutoFit;
+    float mLineWidth, mPointSize;
+};
+
+NAMESPACE_END(nanogui)
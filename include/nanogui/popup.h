@@ -51,6 +51,8 @@ public:
     Window *parentWindow() { return mParentWindow; }
     /// Return the parent window of the popup
     const Window *parentWindow() const { return mParentWindow; }
+    /// Set the parent window of the popup (raises the popup above it)
+    void setParentWindow(Window *parentWindow);
 
     /// Invoke the associated layout generator to properly place child widgets, if any
     virtual void performLayout(NVGcontext *ctx) override;
@@ -70,7 +72,7 @@ protected:
     int mAnchorHeight;
     Side mSide;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Popup)
 };
 
 NAMESPACE_END(nanogui)
@@ -52,7 +52,7 @@ protected:
     Popup *mPopup;
     int mChevronIcon;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(PopupButton)
 };
 
 NAMESPACE_END(nanogui)
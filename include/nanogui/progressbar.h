@@ -26,7 +26,13 @@ public:
     ProgressBar(Widget *parent);
 
     float value() { return mValue; }
-    void setValue(float value) { mValue = value; }
+    void setValue(float value) {
+        if (value != mValue) {
+            mValue = value;
+            /* Animations set the value at a high rate: coalesce to one frame interval */
+            scheduleRedraw(1.0 / 60.0);
+        }
+    }
 
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext* ctx) override;
@@ -36,7 +42,7 @@ public:
 protected:
     float mValue;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ProgressBar)
 };
 
 NAMESPACE_END(nanogui)
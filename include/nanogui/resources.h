@@ -0,0 +1,55 @@
+/*
+    nanogui/resources.h -- Access to resource files (fonts, etc.) that are
+    embedded into the NanoGUI library in compressed form
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <string>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \brief Return the contents of an embedded resource file
+ *
+ * All TrueType files in the ``resources`` directory are compressed at build time and
+ * linked into the library. The first request for a resource decompresses it
+ * into a buffer that remains valid (and is reused by subsequent requests)
+ * until the application terminates. This function is thread-safe.
+ *
+ * \param name
+ *     Identifier derived from the file name, e.g. ``"roboto_regular_ttf"``
+ *     for ``resources/Roboto-Regular.ttf``.
+ *
+ * \param size
+ *     Receives the size of the (decompressed) resource in bytes.
+ *
+ * \return
+ *     A pointer to the decompressed data. Throws ``std::runtime_error`` if no
+ *     resource with the given name exists or if the data is corrupt.
+ */
+extern NANOGUI_EXPORT const uint8_t *resource(const std::string &name, uint32_t *size);
+
+/// Return the names of all embedded resources (without decompressing anything)
+extern NANOGUI_EXPORT std::vector<std::string> resourceNames();
+
+/**
+ * \brief Register an embedded font resource with a NanoVG context
+ *
+ * Returns the existing handle if a font with the name \c face is already
+ * known to \c ctx; the resource is only decompressed when this is not the
+ * case. Returns ``-1`` on failure.
+ */
+extern NANOGUI_EXPORT int createFontResource(NVGcontext *ctx, const char *face,
+                                             const std::string &name);
+
+NAMESPACE_END(nanogui)
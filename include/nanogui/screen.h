@@ -15,6 +15,11 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/taskqueue.h>
+#include <nanogui/tracing.h>
+#include <nanogui/framearena.h>
+#include <nanogui/zorder.h>
+#include <memory>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -27,6 +32,8 @@ NAMESPACE_BEGIN(nanogui)
 class NANOGUI_EXPORT Screen : public Widget {
     friend class Widget;
     friend class Window;
+    friend class Popup;
+    friend class EventRecorder;
 public:
     /**
      * Create a new Screen instance
@@ -138,13 +145,137 @@ public:
     /// Return a pointer to the underlying nanoVG draw context
     NVGcontext *nvgContext() { return mNVGContext; }
 
+    /**
+     * \brief Should input events be queued and dispatched once per frame?
+     *
+     * When enabled (the default), the GLFW callbacks installed by this
+     * \ref Screen only record events. Runs of consecutive cursor motion and
+     * scroll events are merged, and the resulting queue is dispatched to the
+     * widget tree by \ref processEvents() at the beginning of the next frame.
+     * Disable this to dispatch every event from within the GLFW callback.
+     */
+    void setEventCoalescing(bool value);
+    /// Return whether input events are queued and coalesced (see \ref setEventCoalescing())
+    bool eventCoalescing() const { return mEventCoalescing; }
+
+    /// Dispatch all queued input events and posted tasks (called by \ref drawAll() and the main loop)
+    void processEvents();
+
+    /**
+     * \brief Run a function on the main loop thread before the next frame
+     *
+     * Like \ref nanogui::async(), but the task is executed by \ref
+     * processEvents() of this screen, i.e. while holding the lock that
+     * protects the widget tree from the screen's rendering thread (see
+     * \ref startRenderThread()). This function is thread-safe.
+     */
+    void post(const std::function<void()> &func);
+
+    /// Are tasks waiting to be executed by \ref processEvents()?
+    bool hasPendingTasks() const { return !mTaskQueue.empty(); }
+
+    /// Return depth and latency statistics of the tasks submitted via \ref post()
+    TaskQueue::Statistics taskStatistics() const { return mTaskQueue.statistics(); }
+
+    /**
+     * \brief Render this screen on a thread of its own
+     *
+     * The rendering thread enables vsync and calls \ref drawAll() whenever
+     * \ref requestFrame() is invoked. Input events are still received and
+     * dispatched on the main thread; a per-screen lock keeps event dispatch
+     * and drawing of the widget tree apart, while swapping buffers does not
+     * block other screens. The main loop calls this function for all
+     * screens when threaded rendering is enabled (see \ref
+     * nanogui::setThreadedRendering()). Must be called on the main thread.
+     *
+     * The OpenGL context is then only current on the rendering thread while
+     * it draws and swaps buffers, and on the main thread while the widget
+     * lock is held (see \ref lockWidgets()). Event handlers, timers, and
+     * tasks run under this lock, but any other code on the main thread that
+     * creates or destroys widgets which own OpenGL objects (e.g. \ref
+     * ImageView or \ref GLCanvas), or that calls OpenGL directly, must hold
+     * it too, e.g. via \ref ScreenLock.
+     */
+    void startRenderThread();
+
+    /// Stop the rendering thread and make the context current on the calling (main) thread
+    void stopRenderThread();
+
+    /// Is a rendering thread active? (see \ref startRenderThread())
+    bool renderThreadActive() const { return (bool) mRenderThread; }
+
+    /// Ask the rendering thread to draw a new frame and return immediately (main thread only)
+    void requestFrame();
+
+    /**
+     * \brief Keep the rendering thread away from the widget tree until \ref
+     * unlockWidgets() is called
+     *
+     * The outermost call also waits until the rendering thread has
+     * finished swapping buffers and makes the screen's OpenGL context
+     * current on the calling thread; the matching \ref unlockWidgets()
+     * restores the context that was current before. Calls nest, and do
+     * nothing when the screen has no rendering thread (see \ref
+     * startRenderThread()). Main thread only.
+     */
+    void lockWidgets();
+
+    /// Undo a call to \ref lockWidgets()
+    void unlockWidgets();
+
+    /**
+     * \brief Save the NanoVG commands of the next frame to a file
+     *
+     * The command stream of the next call to \ref drawWidgets() is captured
+     * using \ref DrawTrace and written to \c filename, e.g. for analysis
+     * with the ``nanogui_replay_bench`` tool. Must be called on the main
+     * thread from an event handler or a task submitted via \ref post().
+     */
+    void recordFrame(const std::string &filename);
+
+    /**
+     * \brief Forward all input events received from GLFW to an \ref EventRecorder
+     *
+     * Usually called by \ref EventRecorder::start(); pass \c nullptr to stop.
+     */
+    void setEventRecorder(EventRecorder *recorder) { mEventRecorder = recorder; }
+
+    /// Return the \ref EventRecorder that receives this screen's input events (if any)
+    EventRecorder *eventRecorder() const { return mEventRecorder; }
+
+    /**
+     * \brief Return the heap allocations made by the last call to \ref drawAll()
+     *
+     * This includes dispatching the queued input events and posted tasks,
+     * which \ref drawAll() does first. Only available when allocation
+     * tracking was compiled in (see \ref allocationTracking()). Events that
+     * are dispatched immediately (see \ref setEventCoalescing()) are not
+     * counted. With a rendering thread, events are dispatched on the main
+     * thread, and only the allocations made while drawing are counted.
+     */
+    AllocationStats frameAllocations() const;
+
+    /// Return the number of widgets that were skipped by the last frame because they were clipped away (see \ref Widget::draw())
+    size_t culledWidgets() const { return mCulledWidgets; }
+
     void setShutdownGLFWOnDestruct(bool v) { mShutdownGLFWOnDestruct = v; }
     bool shutdownGLFWOnDestruct() { return mShutdownGLFWOnDestruct; }
 
+    using Widget::addChild;
+    using Widget::removeChild;
+
+    /// Add a child widget; windows are placed above all other windows of layer 0
+    virtual void addChild(int index, Widget *widget) override;
+
+    /// Remove a child widget (and stop tracking its stacking order)
+    virtual void removeChild(int index) override;
+
     using Widget::performLayout;
 
     /// Compute the layout of all widgets
     void performLayout() {
+        NANOGUI_TRACE_SCOPE("Screen::performLayout");
+        loadThemeFonts();
         Widget::performLayout(mNVGContext);
     }
 
@@ -182,8 +313,61 @@ public:
     void disposeWindow(Window *window);
     void centerWindow(Window *window);
     void moveWindowToFront(Window *window);
+
+    /**
+     * \brief Assign a window and its popups to a layer
+     *
+     * Windows in higher layers (e.g. tool palettes) always stay above the
+     * windows of lower layers, regardless of focus. All windows start in
+     * layer 0. The window and its popups are raised above the other windows
+     * of their new layer.
+     */
+    void setWindowLayer(Window *window, int layer);
     void drawWidgets();
 
+protected:
+    /// An input event recorded by the GLFW callbacks (see \ref setEventCoalescing())
+    struct QueuedEvent {
+        enum Type { CursorPos, MouseButton, Key, Char, Drop, Scroll } type;
+        double x = 0, y = 0;
+        int arg[4] = { 0, 0, 0, 0 };
+        std::vector<std::string> filenames;
+    };
+
+    /// Record an event, merging it with the previous one if possible
+    void queueEvent(QueuedEvent::Type type, double x, double y, int arg0 = 0,
+                    int arg1 = 0, int arg2 = 0, int arg3 = 0);
+
+    /// Forward a recorded event to the matching ``*CallbackEvent`` function
+    void dispatchEvent(const QueuedEvent &event);
+
+    /// Start tracking the stacking order of a window child in \ref mZOrder
+    void trackWindow(Window *window);
+
+    /// Attach a popup to the window that owns it and raise it above that window
+    void setPopupOwner(Popup *popup, Window *owner);
+
+    /**
+     * \brief Move the children of a window group to the place that \ref
+     * mZOrder assigns to it
+     *
+     * The group (a window and its popups) must be contiguous in \ref mZOrder,
+     * which is the case after \ref ZOrder::raise(). Other children, including
+     * widgets that aren't windows, keep their order.
+     */
+    void restackWindow(Window *window);
+
+    /// Register the fonts of the theme with the NanoVG context, once per theme
+    void loadThemeFonts();
+
+    /// Query the window and framebuffer size from GLFW (main thread only)
+    void updateWindowSize();
+
+    /// Mark the input events dispatched so far as waiting for the next buffer swap (tracing only)
+    void tracePresentInput();
+
+    struct RenderThread;
+
 protected:
     GLFWwindow *mGLFWWindow;
     NVGcontext *mNVGContext;
@@ -203,8 +387,50 @@ protected:
     bool mShutdownGLFWOnDestruct;
     bool mFullscreen;
     std::function<void(Vector2i)> mResizeCallback;
+    bool mEventCoalescing;
+    ZOrder mZOrder;
+    std::vector<QueuedEvent> mEventQueue;
+    TaskQueue mTaskQueue;
+    std::unique_ptr<RenderThread> mRenderThread;
+    std::string mTraceFilename;
+    ref<Theme> mFontTheme;        /* Theme whose fonts were registered with mNVGContext */
+    EventRecorder *mEventRecorder;
+#if defined(NANOGUI_TRACING)
+    /* Time of the earliest input that was not dispatched/presented yet (see tracing.h) */
+    uint64_t mTraceInputStart = 0;
+    std::atomic<uint64_t> mTracePresentStart { 0 };
+#endif
+    /* Allocations of the last frame (see frameAllocations()) */
+    std::atomic<uint64_t> mFrameAllocations, mFrameDeallocations, mFrameAllocatedBytes;
+    std::atomic<size_t> mCulledWidgets;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Screen)
+};
+
+/**
+ * \brief Keeps the rendering threads of all screens away from their widget
+ * trees while the lock exists (see \ref Screen::lockWidgets())
+ *
+ * The main loop holds this lock while it runs timers and the tasks submitted
+ * via \ref async(), so that code running on the main loop thread may modify
+ * any widget even when threaded rendering is enabled (see \ref
+ * setThreadedRendering()). Main thread only.
+ *
+ * The screens' OpenGL contexts are made current one after the other, hence
+ * the context of the last screen remains current. With several screens,
+ * call <tt>glfwMakeContextCurrent(screen->glfwWindow())</tt> before creating
+ * or destroying widgets that own OpenGL objects on another screen.
+ */
+class NANOGUI_EXPORT ScreenLock {
+public:
+    ScreenLock();
+    ~ScreenLock();
+
+    ScreenLock(const ScreenLock &) = delete;
+    ScreenLock &operator=(const ScreenLock &) = delete;
+
+private:
+    std::vector<ref<Screen>> mScreens;
 };
 
 NAMESPACE_END(nanogui)
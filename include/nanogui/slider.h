@@ -58,7 +58,7 @@ protected:
     std::pair<float, float> mHighlightedRange;
     Color mHighlightColor;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Slider)
 };
 
 NAMESPACE_END(nanogui)
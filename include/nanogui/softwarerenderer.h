@@ -0,0 +1,123 @@
+/*
+    nanogui/softwarerenderer.h -- NanoVG backend which rasterizes on the CPU
+    into a memory framebuffer
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class SoftwareRenderer softwarerenderer.h nanogui/softwarerenderer.h
+ *
+ * \brief NanoVG rendering backend that does not require an OpenGL driver.
+ *
+ * The renderer implements the NanoVG render callbacks with a scanline
+ * rasterizer that follows the semantics of the OpenGL backend (stencil-based
+ * concave fills, anti-aliased fringes, gradients, image patterns and
+ * scissoring). Draw calls are recorded until the end of the frame; the
+ * framebuffer is then split into tiles that are rasterized in parallel on the
+ * worker threads of \ref nanogui::background(). Pixels are blended with SSE2
+ * or NEON instructions where available.
+ *
+ * This makes it possible to draw widget trees on machines without a GPU (e.g.
+ * for automated tests or thin clients), and to compare the cost of NanoVG's
+ * tessellation against the actual rasterization. Widgets that issue OpenGL
+ * calls themselves (\ref GLCanvas, \ref ImageView) are not supported.
+ *
+ * \code
+ * SoftwareRenderer renderer(Vector2i(800, 600));
+ * ref<Theme> theme = new Theme(renderer.nvgContext());
+ * ref<Window> window = new Window(nullptr, "Headless");
+ * window->setTheme(theme);
+ * ...
+ * window->performLayout(renderer.nvgContext());
+ * renderer.render(window, Color(0.3f, 1.f));
+ * const uint8_t *pixels = renderer.data();
+ * \endcode
+ */
+class NANOGUI_EXPORT SoftwareRenderer {
+public:
+    /**
+     * \brief Create a renderer along with its NanoVG context
+     *
+     * \param size
+     *     Size of the framebuffer in logical (unscaled) pixels
+     *
+     * \param pixelRatio
+     *     Ratio of framebuffer pixels to logical pixels
+     *
+     * \param threadCount
+     *     Number of threads that rasterize tiles concurrently. The default
+     *     value of zero uses all worker threads.
+     *
+     * \param antialias
+     *     Render anti-aliased edges? (equivalent to the \c NVG_ANTIALIAS
+     *     flag of the OpenGL backend)
+     */
+    SoftwareRenderer(const Vector2i &size, float pixelRatio = 1.f,
+                     int threadCount = 0, bool antialias = true);
+    ~SoftwareRenderer();
+
+    /// Return the NanoVG context that draws into this renderer
+    NVGcontext *nvgContext() { return mNVGContext; }
+
+    /// Resize the framebuffer (its contents are undefined afterwards)
+    void setSize(const Vector2i &size, float pixelRatio = 1.f);
+    /// Return the size of the framebuffer in logical pixels
+    const Vector2i &size() const { return mSize; }
+    /// Return the size of the framebuffer in actual pixels
+    const Vector2i &fbSize() const { return mFBSize; }
+    /// Return the ratio of framebuffer pixels to logical pixels
+    float pixelRatio() const { return mPixelRatio; }
+
+    /// Set the number of threads that rasterize tiles (0: all worker threads)
+    void setThreadCount(int threadCount);
+    /// Return the number of threads that rasterize tiles (0: all worker threads)
+    int threadCount() const { return mThreadCount; }
+
+    /// Fill the framebuffer with the given color
+    void clear(const Color &color);
+
+    /**
+     * \brief Clear the framebuffer and draw a widget and its children
+     *
+     * Registers the fonts of \c widget's theme with the renderer's NanoVG
+     * context if necessary. Tooltips and the contents of OpenGL-based widgets
+     * are not drawn.
+     */
+    void render(Widget *widget, const Color &background);
+
+    /// Return the framebuffer (top-down rows of premultiplied RGBA8 values)
+    const uint8_t *data() const;
+
+    /// Return the time spent rasterizing the last frame (in seconds)
+    double rasterTime() const;
+
+    /// Write the framebuffer to an uncompressed TGA file (for debugging)
+    void downloadTGA(const std::string &filename) const;
+
+protected:
+    struct Backend;
+
+    std::unique_ptr<Backend> mBackend;
+    NVGcontext *mNVGContext;
+    Vector2i mSize, mFBSize;
+    float mPixelRatio;
+    int mThreadCount;
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+NAMESPACE_END(nanogui)
@@ -38,7 +38,7 @@ public:
 private:
     int mSelectedIndex = -1;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(StackedWidget)
 };
 
 NAMESPACE_END(nanogui)
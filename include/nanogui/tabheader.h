@@ -175,7 +175,7 @@ private:
 
     std::string mFont;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(TabHeader)
 };
 
 NAMESPACE_END(nanogui)
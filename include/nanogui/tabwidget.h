@@ -96,7 +96,7 @@ private:
     StackedWidget* mContent;
     std::function<void(int)> mCallback;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(TabWidget)
 };
 
 NAMESPACE_END(nanogui)
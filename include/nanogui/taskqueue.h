@@ -0,0 +1,115 @@
+/*
+    nanogui/taskqueue.h -- Lock-free queue for handing work from arbitrary
+    threads to the main loop
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <functional>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TaskQueue taskqueue.h nanogui/taskqueue.h
+ *
+ * \brief Multiple-producer, single-consumer queue of callbacks.
+ *
+ * Any number of threads may \ref push() tasks concurrently without taking a
+ * lock (the implementation is an intrusive linked list after Dmitry Vyukov).
+ * A single consumer thread --- normally the main loop --- executes them in
+ * batches via \ref run(). The queue also keeps track of its depth and of the
+ * time tasks spend waiting, which is useful to verify that producers don't
+ * outpace the user interface.
+ */
+class NANOGUI_EXPORT TaskQueue {
+public:
+    /// Statistics reported by \ref TaskQueue::statistics()
+    struct Statistics {
+        uint64_t pushed = 0;         ///< Total number of tasks pushed so far
+        uint64_t executed = 0;       ///< Total number of tasks executed so far
+        size_t depth = 0;            ///< Number of tasks currently waiting
+        size_t peakDepth = 0;        ///< Largest number of tasks waiting at once
+        size_t lastBatch = 0;        ///< Number of tasks executed by the last \ref run()
+        double lastLatency = 0;      ///< Largest waiting time in the last batch (seconds)
+        double maxLatency = 0;       ///< Largest waiting time observed so far (seconds)
+        double meanLatency = 0;      ///< Average waiting time of all executed tasks (seconds)
+    };
+
+    TaskQueue();
+    ~TaskQueue();
+
+    /**
+     * \brief Append a task to the queue (thread-safe, lock-free)
+     *
+     * \return
+     *     ``true`` if the queue was empty before. Callers use this to wake up
+     *     the consumer only once per batch.
+     */
+    bool push(const std::function<void()> &task);
+
+    /**
+     * \brief Execute the tasks that are currently queued (consumer thread only)
+     *
+     * Tasks pushed while the batch is running (e.g. by the tasks themselves)
+     * are deferred to the next call.
+     *
+     * \return The number of executed tasks.
+     */
+    size_t run();
+
+    /// Return the number of waiting tasks (approximate while producers are active)
+    size_t size() const { return mSize.load(std::memory_order_relaxed); }
+
+    /// Return whether no tasks are waiting
+    bool empty() const { return size() == 0; }
+
+    /// Return queue depth and latency statistics (consumer thread only)
+    Statistics statistics() const;
+
+protected:
+    struct Node;
+
+    /// Remove the oldest task from the queue, or return \c nullptr
+    Node *pop();
+
+    void pushNode(Node *node);
+
+protected:
+    std::atomic<Node *> mHead;
+    Node *mTail;
+    Node *mStub;
+    std::atomic<size_t> mSize;
+    std::atomic<size_t> mPeakSize;
+    std::atomic<uint64_t> mPushed;
+    uint64_t mExecuted;
+    size_t mLastBatch;
+    double mLastLatency, mMaxLatency, mTotalLatency;
+};
+
+/**
+ * \brief Run a function on the main loop thread
+ *
+ * This is the thread-safe way to modify the widget tree from a worker
+ * thread. The call returns immediately; if the main loop is waiting for
+ * events, it is woken up, and all tasks queued since the previous frame are
+ * executed in one batch before the next frame is drawn, while holding a
+ * \ref ScreenLock (so that rendering threads don't draw the widgets being
+ * modified). Tasks submitted before the main loop starts run at the
+ * beginning of the first frame.
+ */
+extern NANOGUI_EXPORT void async(const std::function<void()> &func);
+
+/// Return depth and latency statistics of the queue used by \ref async()
+extern NANOGUI_EXPORT TaskQueue::Statistics asyncStatistics();
+
+NAMESPACE_END(nanogui)
@@ -17,6 +17,8 @@
 
 #include <nanogui/compat.h>
 #include <nanogui/widget.h>
+#include <nanogui/validator.h>
+#include <nanogui/numeric.h>
 #include <sstream>
 
 NAMESPACE_BEGIN(nanogui)
@@ -66,7 +68,10 @@ public:
     /// Return the underlying regular expression specifying valid formats
     const std::string &format() const { return mFormat; }
     /// Specify a regular expression specifying valid formats
-    void setFormat(const std::string &format) { mFormat = format; }
+    void setFormat(const std::string &format);
+
+    /// Return the validator compiled from the format (\c nullptr accepts all inputs)
+    const Validator *validator() const { return mValidator.get(); }
 
     /// Set the \ref Theme used to draw this widget
     virtual void setTheme(Theme *theme) override;
@@ -90,6 +95,7 @@ public:
     virtual bool load(Serializer &s) override;
 protected:
     bool checkFormat(const std::string& input,const std::string& format);
+    void updateValidity();
     bool copySelection();
     void pasteFromClipboard();
     bool deleteSelection();
@@ -114,6 +120,7 @@ protected:
     Alignment mAlignment;
     std::string mUnits;
     std::string mFormat;
+    ref<Validator> mValidator;
     int mUnitsImage;
     std::function<bool(const std::string& str)> mCallback;
     bool mValidFormat;
@@ -127,7 +134,7 @@ protected:
     float mTextOffset;
     double mLastClick;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(TextBox)
 };
 
 /**
@@ -151,23 +158,22 @@ public:
     }
 
     Scalar value() const {
-        std::istringstream iss(TextBox::value());
         Scalar value = 0;
-        iss >> value;
+        parseNumber(TextBox::value(), value);
         return value;
     }
 
     void setValue(Scalar value) {
         Scalar clampedValue = std::min(std::max(value, mMinValue),mMaxValue);
-        TextBox::setValue(std::to_string(clampedValue));
+        char buffer[NumberBufferSize];
+        TextBox::setValue(std::string(buffer, formatNumber(buffer, clampedValue)));
     }
 
     void setCallback(const std::function<void(Scalar)> &cb) {
         TextBox::setCallback(
             [cb, this](const std::string &str) {
-                std::istringstream iss(str);
                 Scalar value = 0;
-                iss >> value;
+                parseNumber(str, value);
                 setValue(value);
                 cb(value);
                 return true;
@@ -240,7 +246,7 @@ private:
     Scalar mValueIncrement;
     Scalar mMinValue, mMaxValue;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(IntBox)
 };
 
 /**
@@ -268,19 +274,22 @@ public:
     void numberFormat(const std::string &format) { mNumberFormat = format; }
 
     Scalar value() const {
-        return (Scalar) std::stod(TextBox::value());
+        Scalar value = 0;
+        parseNumber(TextBox::value(), value);
+        return value;
     }
 
     void setValue(Scalar value) {
         Scalar clampedValue = std::min(std::max(value, mMinValue),mMaxValue);
         char buffer[50];
-        NANOGUI_SNPRINTF(buffer, 50, mNumberFormat.c_str(), clampedValue);
+        formatNumber(buffer, 50, (double) clampedValue, mNumberFormat.c_str());
         TextBox::setValue(buffer);
     }
 
     void setCallback(const std::function<void(Scalar)> &cb) {
         TextBox::setCallback([cb, this](const std::string &str) {
-            Scalar scalar = (Scalar) std::stod(str);
+            Scalar scalar = 0;
+            parseNumber(str, scalar);
             setValue(scalar);
             cb(scalar);
             return true;
@@ -354,7 +363,7 @@ private:
     Scalar mValueIncrement;
     Scalar mMinValue, mMaxValue;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(FloatBox)
 };
 
 NAMESPACE_END(nanogui)
@@ -0,0 +1,164 @@
+/*
+    nanogui/texteditor.h -- Multi-line text editor for large documents
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+#include <nanogui/gapbuffer.h>
+#include <nanogui/framearena.h>
+
+struct NVGtextRow;
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextEditor texteditor.h nanogui/texteditor.h
+ *
+ * \brief Multi-line text editor that stays responsive with documents of
+ * several megabytes
+ *
+ * The text is stored in a \ref GapBuffer along with an index of line
+ * starts, so that an edit only touches the affected lines. Lines are wrapped
+ * to the width of the widget. The number of rows of each line is cached and
+ * measured only once the line comes into view (lines that were never
+ * measured count as a single row), and drawing lays out and renders only the
+ * visible rows. Selection, keyboard shortcuts and clipboard handling follow
+ * \ref TextBox.
+ *
+ * Positions are byte offsets into the UTF-8 encoded text.
+ */
+class NANOGUI_EXPORT TextEditor : public Widget {
+public:
+    TextEditor(Widget *parent, const std::string &text = "");
+
+    bool editable() const { return mEditable; }
+    void setEditable(bool editable);
+
+    /// Return a copy of the text
+    std::string text() const { return mBuffer.str(); }
+    /// Replace the text (resets the cursor, selection and scroll position)
+    void setText(const std::string &text);
+
+    /// Return the size of the text in bytes
+    size_t textSize() const { return mBuffer.size(); }
+
+    /// Return the number of lines
+    size_t lineCount() const { return mLineStart.size(); }
+    /// Return the byte offset at which a line starts
+    size_t lineStart(size_t index) const { return mLineStart[index]; }
+    /// Return the contents of a line (without the line break)
+    std::string line(size_t index) const { return mBuffer.substr(mLineStart[index], lineEnd(index)); }
+
+    /// Insert text at the given byte offset
+    void insert(size_t pos, const std::string &str);
+    /// Remove \c length bytes starting at the given byte offset
+    void erase(size_t pos, size_t length);
+
+    /// Return the byte offset of the cursor
+    size_t cursorPosition() const { return mCursorPos; }
+    /// Move the cursor and clear the selection
+    void setCursorPosition(size_t pos);
+
+    /// Select the range <tt>[begin, end)</tt> and place the cursor at its end
+    void select(size_t begin, size_t end);
+    /// Return the selected text
+    std::string selectedText() const;
+
+    /// The callback that is invoked whenever the user modifies the text
+    const std::function<void()> &callback() const { return mCallback; }
+    /// Sets the callback that is invoked whenever the user modifies the text
+    void setCallback(const std::function<void()> &callback) { mCallback = callback; }
+
+    /// Set the \ref Theme used to draw this widget
+    virtual void setTheme(Theme *theme) override;
+
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual bool keyboardEvent(int key, int scancode, int action, int modifiers) override;
+    virtual bool keyboardCharacterEvent(unsigned int codepoint) override;
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual void draw(NVGcontext* ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    typedef frame_vector<NVGtextRow> RowVector;
+
+    /// Return the line containing the given byte offset
+    size_t lineOf(size_t pos) const;
+    /// Return the byte offset of the end of a line (excluding the line break)
+    size_t lineEnd(size_t index) const;
+
+    /// Insert text and update the line index
+    void insertText(size_t pos, const char *str, size_t length);
+    /// Remove text and update the line index
+    void eraseText(size_t pos, size_t length);
+
+    bool hasSelection() const { return mSelectionPos != NoSelection; }
+    bool copySelection();
+    void pasteFromClipboard();
+    bool deleteSelection();
+
+    /// Move the cursor, optionally extending the selection
+    void moveCursor(size_t pos, bool select);
+    /// Return the start of the UTF-8 character preceding 'pos'
+    size_t previousCharacter(size_t pos) const;
+    /// Return the start of the UTF-8 character following 'pos'
+    size_t nextCharacter(size_t pos) const;
+    /// Notify the callback and keep the cursor in view after an edit
+    void modified();
+
+    /// Mark the row offsets of the lines after 'index' as stale
+    void invalidateRows(size_t index) { mRowOffsetValid = std::min(mRowOffsetValid, index + 1); }
+    /// Bring the cumulative row offsets up to date
+    void updateRowOffsets();
+    /// Return the line containing the given (global) row
+    size_t lineAtRow(int row) const;
+    /// Wrap a line into rows; returns a pointer to the start of its text
+    const char *layoutLine(NVGcontext *ctx, size_t index, RowVector &rows);
+    /// Return the row of a line that contains the given character
+    size_t rowIndex(const RowVector &rows, const char *ptr) const;
+    /// Return the byte offset closest to a position in a (global) row
+    size_t positionAt(NVGcontext *ctx, int row, float x, RowVector &rows);
+
+protected:
+    static const size_t NoSelection = (size_t) -1;
+
+    GapBuffer mBuffer;
+    std::vector<size_t> mLineStart;  /* Byte offset of every line */
+    std::vector<int> mLineRows;      /* Rows per line (0: not measured yet) */
+    std::vector<int> mRowOffset;     /* Rows preceding every line */
+    size_t mRowOffsetValid;          /* Number of up-to-date entries in 'mRowOffset' */
+    float mWrapWidth;
+
+    bool mEditable;
+    size_t mCursorPos;
+    size_t mSelectionPos;
+    int mPendingRows;                /* Vertical cursor motion, resolved when drawing */
+    float mPreferredX;               /* Column kept during vertical motion (-1: none) */
+    bool mScrollToCursor;
+
+    float mScroll;                   /* Vertical scroll offset in pixels */
+    float mLineHeight;
+    float mContentHeight;
+    bool mDragScrollbar;
+
+    Vector2i mMouseDownPos;
+    Vector2i mMouseDragPos;
+    int mMouseDownModifier;
+    double mLastClick;
+    std::function<void()> mCallback;
+};
+
+NAMESPACE_END(nanogui)
@@ -30,13 +30,22 @@ class NANOGUI_EXPORT Theme : public Object {
 public:
     Theme(NVGcontext *ctx);
 
-    /* Fonts */
-    /// The standard font face (default: ``"sans"`` from ``resources/roboto_regular.ttf``).
-    int mFontNormal;
-    /// The bold font face (default: ``"sans-bold"`` from ``resources/roboto_regular.ttf``).
-    int mFontBold;
-    /// The icon font face (default: ``"icons"`` from ``resources/entypo.ttf``).
-    int mFontIcons;
+    /**
+     * \brief Register the fonts used by this theme with a NanoVG context
+     *
+     * Fonts are embedded into the library in compressed form. To keep startup
+     * fast, they are only decompressed and registered when the first layout
+     * or draw pass needs them (\ref Screen calls this function automatically),
+     * and faces that already exist in \c ctx are reused. Call this function
+     * explicitly before measuring text with a context that isn't managed by a
+     * \ref Screen. Subclasses can override it to register additional fonts.
+     *
+     * The faces are called ``"sans"``, ``"sans-bold"`` and ``"icons"``. A
+     * theme may be shared by screens, each of which has its own context
+     * (and possibly its own rendering thread), so the font ids are not
+     * stored in the theme: use \c nvgFindFont() to look them up in a context.
+     */
+    virtual void loadFonts(NVGcontext *ctx);
     /**
      * The amount of scaling that is applied to each icon to fit the size of
      * NanoGUI widgets.  The default value is ``0.77f``, setting to e.g. higher
@@ -228,7 +237,7 @@ protected:
     virtual ~Theme() { };
 
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Theme)
 };
 
 NAMESPACE_END(nanogui)
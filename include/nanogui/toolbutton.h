@@ -30,7 +30,7 @@ public:
         setFixedSize(Vector2i(25, 25));
     }
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(ToolButton)
 };
 
 NAMESPACE_END(nanogui)
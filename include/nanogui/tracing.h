@@ -0,0 +1,110 @@
+/*
+    nanogui/tracing.h -- Lightweight timeline tracing of the event and
+    rendering path with export to the Chrome/Perfetto trace format
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * \def NANOGUI_TRACE_SCOPE(name)
+ *
+ * Record the time spent until the end of the enclosing scope as an event
+ * named \c name (a string literal) on the calling thread's timeline.
+ *
+ * The markers are only compiled when \c NANOGUI_TRACING is defined (CMake
+ * option ``NANOGUI_ENABLE_TRACING``); otherwise, they expand to nothing.
+ * When compiled, they record events while \ref nanogui::setTracing() is
+ * enabled and cost a single relaxed atomic load otherwise.
+ */
+#if defined(NANOGUI_TRACING)
+#  define NANOGUI_TRACE_CONCAT_(a, b) a##b
+#  define NANOGUI_TRACE_CONCAT(a, b) NANOGUI_TRACE_CONCAT_(a, b)
+#  define NANOGUI_TRACE_SCOPE(name) \
+       ::nanogui::TraceScope NANOGUI_TRACE_CONCAT(__nanogui_trace_scope_, __LINE__)(name)
+#  define NANOGUI_TRACE_INSTANT(name) \
+       do { if (::nanogui::tracing()) ::nanogui::traceInstant(name); } while (0)
+#else
+#  define NANOGUI_TRACE_SCOPE(name) do { } while (0)
+#  define NANOGUI_TRACE_INSTANT(name) do { } while (0)
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+NAMESPACE_BEGIN(detail)
+extern NANOGUI_EXPORT std::atomic<bool> tracing_active;
+NAMESPACE_END(detail)
+
+/**
+ * \brief Start or stop recording trace events
+ *
+ * Each thread records into a lock-free ring buffer of its own that holds the
+ * most recent 16384 events. Recording is disabled by default. Apart from the
+ * markers placed with \ref NANOGUI_TRACE_SCOPE, NanoGUI records the
+ * latency from the first input event that a frame responds to until the
+ * buffers of that frame were swapped ("input-to-photon").
+ */
+extern NANOGUI_EXPORT void setTracing(bool enabled);
+
+/// Are trace events being recorded? (see \ref setTracing())
+inline bool tracing() { return detail::tracing_active.load(std::memory_order_relaxed); }
+
+/// Return the current time of the clock used for trace events (in nanoseconds)
+extern NANOGUI_EXPORT uint64_t traceTimestamp();
+
+/// Record an event on the calling thread's timeline (timestamps from \ref traceTimestamp())
+extern NANOGUI_EXPORT void traceEvent(const char *name, uint64_t start, uint64_t end);
+
+/// Record an instantaneous event on the calling thread's timeline
+extern NANOGUI_EXPORT void traceInstant(const char *name);
+
+/// Set the name under which the calling thread appears in exported traces
+extern NANOGUI_EXPORT void setTraceThreadName(const std::string &name);
+
+/// Discard all recorded events
+extern NANOGUI_EXPORT void clearTrace();
+
+/**
+ * \brief Write the recorded events to a JSON file in the Chrome trace event
+ * format, which can be opened with ``chrome://tracing`` or the Perfetto UI
+ *
+ * Recording should be stopped first; events that are recorded while the file
+ * is written may be missing or incomplete.
+ */
+extern NANOGUI_EXPORT void saveTrace(const std::string &filename);
+
+/**
+ * \class TraceScope tracing.h nanogui/tracing.h
+ *
+ * \brief Records the lifetime of the object as a trace event (see \ref NANOGUI_TRACE_SCOPE)
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name)
+        : mName(name), mStart(tracing() ? traceTimestamp() : 0) { }
+
+    ~TraceScope() {
+        if (mStart)
+            traceEvent(mName, mStart, traceTimestamp());
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+protected:
+    const char *mName;
+    uint64_t mStart;
+};
+
+NAMESPACE_END(nanogui)
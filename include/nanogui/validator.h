@@ -0,0 +1,49 @@
+/*
+    nanogui/validator.h -- Shared, precompiled validators for the input
+    formats of text boxes
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <string>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Validator validator.h nanogui/validator.h
+ *
+ * \brief Checks whether the contents of a \ref TextBox match its format
+ *
+ * Validators are immutable and can be shared by any number of text boxes.
+ * \ref fromFormat() compiles each distinct regular expression only once and
+ * returns hand-written scanners for the integer and floating point formats
+ * installed by \ref IntBox and \ref FloatBox, which avoids the regular
+ * expression engine altogether for the most common fields.
+ */
+class NANOGUI_EXPORT Validator : public Object {
+public:
+    /// Return \c true if the given input is acceptable
+    virtual bool validate(const std::string &input) const = 0;
+
+    /**
+     * \brief Return the (shared) validator for a regular expression
+     *
+     * An empty format yields \c nullptr, which accepts all inputs. Throws
+     * \c std::regex_error if the expression is invalid.
+     */
+    static ref<Validator> fromFormat(const std::string &format);
+
+    /// Return the number of regular expressions compiled so far
+    static size_t compiledCount();
+};
+
+NAMESPACE_END(nanogui)
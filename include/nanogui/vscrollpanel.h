@@ -44,7 +44,7 @@ protected:
     float mScroll;
     bool mUpdateLayout;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(VScrollPanel)
 };
 
 NAMESPACE_END(nanogui)
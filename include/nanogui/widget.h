@@ -31,6 +31,21 @@ enum class Cursor;// do not put a docstring, this is already documented
  */
 class NANOGUI_EXPORT Widget : public Object {
 public:
+    /**
+     * \brief Built-in widget classes that layouts and event handlers need to
+     * recognize (see \ref hasKind())
+     *
+     * Checking these flags replaces calls to \c dynamic_cast in code that
+     * runs for every widget during layout and event dispatch. Derived
+     * classes inherit the flags of their base classes.
+     */
+    enum Kind {
+        WindowKind = (1 << 0), ///< \ref Window and derived classes
+        PopupKind  = (1 << 1), ///< \ref Popup and derived classes
+        ScreenKind = (1 << 2), ///< \ref Screen and derived classes
+        LabelKind  = (1 << 3)  ///< \ref Label and derived classes
+    };
+
     /// Construct a new widget with the given parent widget
     Widget(Widget *parent);
 
@@ -39,7 +54,13 @@ public:
     /// Return the parent widget
     const Widget *parent() const { return mParent; }
     /// Set the parent widget
-    void setParent(Widget *parent) { mParent = parent; }
+    void setParent(Widget *parent) {
+        mParent = parent;
+        updateAncestors();
+    }
+
+    /// Is this widget an instance of the given built-in class? (see \ref Kind)
+    bool hasKind(Kind kind) const { return (mKind & kind) != 0; }
 
     /// Return the used \ref Layout generator
     Layout *layout() { return mLayout; }
@@ -58,12 +79,25 @@ public:
     /// Return the position relative to the parent widget
     const Vector2i &position() const { return mPos; }
     /// Set the position relative to the parent widget
-    void setPosition(const Vector2i &pos) { mPos = pos; }
+    void setPosition(const Vector2i &pos) {
+        /* Scroll panels re-apply their offset every frame; keep the cached
+           absolute positions of the subtree when nothing moved */
+        if (pos == mPos)
+            return;
+        mPos = pos;
+        invalidateAbsolutePosition();
+    }
 
-    /// Return the absolute position on screen
+    /**
+     * \brief Return the absolute position on screen
+     *
+     * The result is cached and only recomputed after the position of the
+     * widget or of one of its ancestors has changed.
+     */
     Vector2i absolutePosition() const {
-        return mParent ?
-            (parent()->absolutePosition() + mPos) : mPos;
+        if (mAbsolutePosDirty)
+            updateAbsolutePosition();
+        return mAbsolutePos;
     }
 
     /// Return the size of the widget
@@ -140,7 +174,7 @@ public:
     void addChild(Widget *widget);
 
     /// Remove a child widget by index
-    void removeChild(int index);
+    virtual void removeChild(int index);
 
     /// Remove a child widget by value
     void removeChild(const Widget *widget);
@@ -160,10 +194,10 @@ public:
         return new WidgetClass(this, args...);
     }
 
-    /// Walk up the hierarchy and return the parent window
+    /// Return the parent window (or the widget itself if it is a \ref Window)
     Window *window();
 
-    /// Walk up the hierarchy and return the parent screen
+    /// Return the parent screen (or the widget itself if it is a \ref Screen)
     Screen *screen();
 
     /// Associate this widget with an ID value (optional)
@@ -249,9 +283,19 @@ public:
     /// Invoke the associated layout generator to properly place child widgets, if any
     virtual void performLayout(NVGcontext *ctx);
 
-    /// Draw the widget (and all child widgets)
+    /**
+     * \brief Draw the widget (and all child widgets)
+     *
+     * Children that lie entirely outside of the area visible through the
+     * current widget (e.g. the rows of a long list inside a \ref
+     * VScrollPanel that are scrolled out of view) are skipped along with
+     * their descendants.
+     */
     virtual void draw(NVGcontext *ctx);
 
+    /// Return the number of children that \ref draw() skipped on the calling thread so far
+    static size_t culledCount();
+
     /// Save the state of the widget into the given \ref Serializer instance
     virtual void save(Serializer &s) const;
 
@@ -274,12 +318,41 @@ protected:
      */
     inline float icon_scale() const { return mTheme->mIconScale * mIconExtraScale; }
 
+    /// Recompute the cached ancestor window and screen of this widget and its descendants
+    void updateAncestors();
+
+    /**
+     * \brief Mark the cached absolute position of this widget and its
+     * descendants as outdated
+     *
+     * Must be called by derived classes that modify \ref mPos directly.
+     * Once a widget is marked, so are all of its descendants, which makes
+     * repeated calls (e.g. while a layout repositions a whole subtree) cheap.
+     */
+    void invalidateAbsolutePosition() {
+        if (!mAbsolutePosDirty)
+            invalidateAbsolutePositionRecursive();
+    }
+
+    void invalidateAbsolutePositionRecursive();
+
+    /// Recompute the cached absolute position (see \ref absolutePosition())
+    void updateAbsolutePosition() const;
+
 protected:
     Widget *mParent;
+    /// Combination of \ref Kind flags (set by the constructors of derived classes)
+    int mKind;
+    /// Nearest \ref Window and \ref Screen among the ancestors (maintained by \ref setParent())
+    Window *mAncestorWindow;
+    Screen *mAncestorScreen;
     ref<Theme> mTheme;
     ref<Layout> mLayout;
     std::string mId;
     Vector2i mPos, mSize, mFixedSize;
+    /// Cached result of \ref absolutePosition(), valid unless \ref mAbsolutePosDirty is set
+    mutable Vector2i mAbsolutePos;
+    mutable bool mAbsolutePosDirty;
     std::vector<Widget *> mChildren;
 
     /**
@@ -336,7 +409,7 @@ protected:
     float mIconExtraScale;
     Cursor mCursor;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Widget)
 };
 
 NAMESPACE_END(nanogui)
@@ -68,7 +68,7 @@ protected:
     bool mModal;
     bool mDrag;
 public:
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    NANOGUI_MAKE_ALIGNED_OPERATOR_NEW(Window)
 };
 
 NAMESPACE_END(nanogui)
@@ -0,0 +1,101 @@
+/*
+    nanogui/zorder.h -- Stacking order of the windows and popups of a screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ZOrder zorder.h nanogui/zorder.h
+ *
+ * \brief Stacking order of a set of windows, used by \ref Screen
+ *
+ * Every window belongs to a layer (0 by default); windows in higher layers
+ * always stay above those in lower layers. Within a layer, windows are
+ * ordered by the time at which they were last raised. Popups are attached
+ * to the window that owns them (see \ref setOwner()) and are kept directly
+ * above it: raising a window also raises all of its popups and their
+ * nested popups, preserving their relative order.
+ *
+ * Raising a window that has \c k popups takes <tt>O(k log n)</tt> time. The
+ * structure only stores pointers and never dereferences them, so stale
+ * entries are harmless until \ref remove() is called.
+ */
+class NANOGUI_EXPORT ZOrder {
+public:
+    ZOrder();
+
+    /// Start tracking a window (above all other windows of layer 0)
+    void insert(Window *window);
+
+    /// Stop tracking a window; its popups become independent windows
+    void remove(Window *window);
+
+    /// Is the given window being tracked?
+    bool contains(const Window *window) const { return mEntries.count(window) != 0; }
+
+    /// Return the number of tracked windows
+    size_t size() const { return mEntries.size(); }
+
+    /// Attach a popup to the window that owns it (\c nullptr detaches it)
+    void setOwner(Window *popup, Window *owner);
+
+    /// Return the window owning a popup (or \c nullptr)
+    Window *owner(const Window *window) const;
+
+    /// Move a window and its popups to another layer
+    void setLayer(Window *window, int layer);
+
+    /// Return the layer of a window
+    int layer(const Window *window) const;
+
+    /// Move a window and its popups above all other windows of its layer
+    void raise(Window *window);
+
+    /// Return a window followed by its popups and their nested popups (back to front)
+    std::vector<Window *> group(Window *window) const;
+
+    /// Return the window directly above the given one (or \c nullptr)
+    Window *above(const Window *window) const;
+
+    /// Return the tracked windows from back to front
+    std::vector<Window *> windows() const;
+
+protected:
+    typedef std::pair<int, uint64_t> Key; /* (layer, raise counter) */
+
+    struct Entry {
+        Key key;
+        Window *owner = nullptr;
+        std::vector<Window *> popups;
+    };
+
+    /// Assign a new key to an entry
+    void reorder(Window *window, Entry &entry, Key key);
+
+    /// Append a window and its popups (bottom to top) to 'result'
+    void collect(Window *window, std::vector<Window *> &result) const;
+
+protected:
+    std::unordered_map<const Window *, Entry> mEntries;
+    std::map<Key, Window *> mOrder;
+    uint64_t mCounter;
+};
+
+NAMESPACE_END(nanogui)
@@ -32,6 +32,7 @@ void register_basics(py::module &m) {
         .def("anchorHeight", &Popup::anchorHeight, D(Popup, anchorHeight))
         .def("setAnchorHeight", &Popup::setAnchorHeight, D(Popup, setAnchorHeight))
         .def("parentWindow", (Window*(Popup::*)(void)) &Popup::parentWindow, D(Popup, parentWindow))
+        .def("setParentWindow", &Popup::setParentWindow, D(Popup, setParentWindow))
         .def("side", &Popup::side, D(Popup, side))
         .def("setSide", &Popup::setSide, D(Popup, setSide));
 
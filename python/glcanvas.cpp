@@ -12,6 +12,8 @@ public:
     }
 };
 
+DECLARE_WIDGET(PlotCanvas);
+
 void register_glcanvas(py::module &m) {
     py::class_<GLCanvas, Widget, ref<GLCanvas>, PyGLCanvas> glcanvas(m, "GLCanvas", D(GLCanvas));
     glcanvas
@@ -21,6 +23,42 @@ void register_glcanvas(py::module &m) {
         .def("drawBorder", &GLCanvas::drawBorder, D(GLCanvas, drawBorder))
         .def("setDrawBorder", &GLCanvas::setDrawBorder, D(GLCanvas, setDrawBorder))
         .def("drawGL", &GLCanvas::drawGL, D(GLCanvas, drawGL));
+
+    py::class_<PlotCanvas, GLCanvas, ref<PlotCanvas>, PyPlotCanvas> plot(m, "PlotCanvas");
+
+    py::enum_<PlotCanvas::Style>(plot, "Style")
+        .value("Lines", PlotCanvas::Style::Lines)
+        .value("Points", PlotCanvas::Style::Points)
+        .value("LinesAndPoints", PlotCanvas::Style::LinesAndPoints);
+
+    plot
+        .def(py::init<Widget *>(), py::arg("parent"))
+        .def("addSeries", &PlotCanvas::addSeries, py::arg("name"), py::arg("color"),
+             py::arg("style") = PlotCanvas::Style::Lines)
+        .def("seriesCount", &PlotCanvas::seriesCount)
+        .def("clearSeries", &PlotCanvas::clearSeries)
+        .def("append", (void (PlotCanvas::*)(size_t, double, float)) &PlotCanvas::append)
+        .def("append", [](PlotCanvas &p, size_t index, const std::vector<double> &x, const std::vector<float> &y) {
+            if (x.size() != y.size())
+                throw std::runtime_error("PlotCanvas.append(): x and y must have the same size!");
+            p.append(index, x.data(), y.data(), x.size());
+        })
+        .def("pointCount", &PlotCanvas::pointCount)
+        .def("seriesName", &PlotCanvas::seriesName)
+        .def("setSeriesName", &PlotCanvas::setSeriesName)
+        .def("seriesColor", &PlotCanvas::seriesColor)
+        .def("setSeriesColor", &PlotCanvas::setSeriesColor)
+        .def("seriesStyle", &PlotCanvas::seriesStyle)
+        .def("setSeriesStyle", &PlotCanvas::setSeriesStyle)
+        .def("lineWidth", &PlotCanvas::lineWidth)
+        .def("setLineWidth", &PlotCanvas::setLineWidth)
+        .def("pointSize", &PlotCanvas::pointSize)
+        .def("setPointSize", &PlotCanvas::setPointSize)
+        .def("xRange", &PlotCanvas::xRange)
+        .def("yRange", &PlotCanvas::yRange)
+        .def("setRange", &PlotCanvas::setRange)
+        .def("autoFit", &PlotCanvas::autoFit)
+        .def("setAutoFit", &PlotCanvas::setAutoFit);
 }
 
 #endif
@@ -208,6 +208,60 @@ PYBIND11_PLUGIN(nanogui) {
 
     m.def("leave", &nanogui::leave, D(leave));
     m.def("active", &nanogui::active, D(active));
+    m.def("setFrameRateLimit", &nanogui::setFrameRateLimit);
+    m.def("frameRateLimit", &nanogui::frameRateLimit);
+    m.def("setThreadedRendering", &nanogui::setThreadedRendering);
+    m.def("threadedRendering", &nanogui::threadedRendering);
+    m.def("addTimer", &nanogui::addTimer, py::arg("delay"), py::arg("callback"),
+          py::arg("repeat") = false);
+    m.def("removeTimer", &nanogui::removeTimer);
+    m.def("scheduleRedraw", &nanogui::scheduleRedraw, py::arg("delay") = 0.0);
+    /* 'async' is a reserved word in Python 3.7+ */
+    m.def("async_", &nanogui::async, py::arg("func"));
+    m.def("asyncStatistics", &nanogui::asyncStatistics);
+
+    py::class_<TaskQueue::Statistics>(m, "TaskQueueStatistics")
+        .def_readonly("pushed", &TaskQueue::Statistics::pushed)
+        .def_readonly("executed", &TaskQueue::Statistics::executed)
+        .def_readonly("depth", &TaskQueue::Statistics::depth)
+        .def_readonly("peakDepth", &TaskQueue::Statistics::peakDepth)
+        .def_readonly("lastBatch", &TaskQueue::Statistics::lastBatch)
+        .def_readonly("lastLatency", &TaskQueue::Statistics::lastLatency)
+        .def_readonly("maxLatency", &TaskQueue::Statistics::maxLatency)
+        .def_readonly("meanLatency", &TaskQueue::Statistics::meanLatency);
+    m.def("setTracing", &nanogui::setTracing, py::arg("enabled"));
+    m.def("tracing", &nanogui::tracing);
+    m.def("clearTrace", &nanogui::clearTrace);
+    m.def("saveTrace", &nanogui::saveTrace, py::arg("filename"));
+    m.def("getTime", &nanogui::getTime);
+    m.def("setTimeSource", &nanogui::setTimeSource, py::arg("source"));
+
+    py::class_<EventRecorder> eventRecorder(m, "EventRecorder");
+    eventRecorder
+        .def(py::init<>())
+        .def("start", &EventRecorder::start, py::arg("screen"))
+        .def("stop", &EventRecorder::stop)
+        .def("recording", &EventRecorder::recording)
+        .def("save", &EventRecorder::save, py::arg("filename"))
+        .def("load", &EventRecorder::load, py::arg("filename"))
+        .def("replay", &EventRecorder::replay, py::arg("screen"), py::arg("realTime") = false)
+        .def("latencies", &EventRecorder::latencies);
+
+    py::class_<EventRecorder::Statistics>(eventRecorder, "Statistics")
+        .def_readonly("count", &EventRecorder::Statistics::count)
+        .def_readonly("total", &EventRecorder::Statistics::total)
+        .def_readonly("mean", &EventRecorder::Statistics::mean)
+        .def_readonly("median", &EventRecorder::Statistics::median)
+        .def_readonly("p90", &EventRecorder::Statistics::p90)
+        .def_readonly("p99", &EventRecorder::Statistics::p99)
+        .def_readonly("max", &EventRecorder::Statistics::max);
+
+    m.def("allocationTracking", &nanogui::allocationTracking);
+    m.def("allocationStats", &nanogui::allocationStats);
+    py::class_<AllocationStats>(m, "AllocationStats")
+        .def_readonly("allocations", &AllocationStats::allocations)
+        .def_readonly("deallocations", &AllocationStats::deallocations)
+        .def_readonly("bytes", &AllocationStats::bytes);
     m.def("file_dialog", (std::string(*)(const std::vector<std::pair<std::string, std::string>> &, bool)) &nanogui::file_dialog, D(file_dialog));
     m.def("file_dialog", (std::vector<std::string>(*)(const std::vector<std::pair<std::string, std::string>> &, bool, bool)) &nanogui::file_dialog, D(file_dialog, 2));
     #if defined(__APPLE__)
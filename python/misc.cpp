@@ -6,7 +6,10 @@ DECLARE_WIDGET(ColorWheel);
 DECLARE_WIDGET(ColorPicker);
 DECLARE_WIDGET(Graph);
 DECLARE_WIDGET(ImageView);
+DECLARE_WIDGET(Heatmap);
 DECLARE_WIDGET(ImagePanel);
+DECLARE_WIDGET(Console);
+DECLARE_WIDGET(DataGrid);
 
 void register_misc(py::module &m) {
     py::class_<ColorWheel, Widget, ref<ColorWheel>, PyColorWheel>(m, "ColorWheel", D(ColorWheel))
@@ -80,12 +83,96 @@ void register_misc(py::module &m) {
         .def("pixelInfoVisible", &ImageView::pixelInfoVisible, D(ImageView, pixelInfoVisible))
         .def("helpersVisible", &ImageView::helpersVisible, D(ImageView, helpersVisible));
 
+    py::class_<Heatmap, ImageView, ref<Heatmap>, PyHeatmap> heatmap(m, "Heatmap");
+
+    py::enum_<Heatmap::Colormap>(heatmap, "Colormap")
+        .value("Grayscale", Heatmap::Colormap::Grayscale)
+        .value("Viridis", Heatmap::Colormap::Viridis)
+        .value("Inferno", Heatmap::Colormap::Inferno);
+
+    heatmap
+        .def(py::init<Widget *, int, int>(), py::arg("parent"), py::arg("columns"), py::arg("rows"))
+        .def("columns", &Heatmap::columns)
+        .def("rows", &Heatmap::rows)
+        .def("columnCount", &Heatmap::columnCount)
+        .def("appendColumn", [](Heatmap &h, const std::vector<float> &values) {
+            if (values.size() != (size_t) h.rows())
+                throw std::runtime_error("Heatmap.appendColumn(): expected one value per row!");
+            h.appendColumn(values.data());
+        })
+        .def("clear", &Heatmap::clear)
+        .def("value", &Heatmap::value)
+        .def("autoRange", &Heatmap::autoRange)
+        .def("setAutoRange", &Heatmap::setAutoRange)
+        .def("range", &Heatmap::range)
+        .def("setRange", &Heatmap::setRange)
+        .def("setColormap", (void (Heatmap::*)(Heatmap::Colormap)) &Heatmap::setColormap)
+        .def("setColormap", (void (Heatmap::*)(const std::vector<Color> &)) &Heatmap::setColormap);
+
     py::class_<ImagePanel, Widget, ref<ImagePanel>, PyImagePanel>(m, "ImagePanel", D(ImagePanel))
         .def(py::init<Widget *>(), py::arg("parent"), D(ImagePanel, ImagePanel))
         .def("images", &ImagePanel::images, D(ImagePanel, images))
         .def("setImages", &ImagePanel::setImages, D(ImagePanel, setImages))
         .def("callback", &ImagePanel::callback, D(ImagePanel, callback))
         .def("setCallback", &ImagePanel::setCallback, D(ImagePanel, setCallback));
+
+    py::class_<Console, Widget, ref<Console>, PyConsole>(m, "Console")
+        .def(py::init<Widget *, size_t>(), py::arg("parent"), py::arg("capacity") = 10000)
+        .def("append", &Console::append)
+        .def("clear", &Console::clear)
+        .def("capacity", &Console::capacity)
+        .def("setCapacity", &Console::setCapacity)
+        .def("lineCount", &Console::lineCount)
+        .def("visibleLineCount", &Console::visibleLineCount)
+        .def("line", &Console::line)
+        .def("filter", &Console::filter)
+        .def("setFilter", &Console::setFilter)
+        .def("filterPending", &Console::filterPending)
+        .def("flush", &Console::flush);
+
+    py::class_<DataColumn, std::shared_ptr<DataColumn>>(m, "DataColumn")
+        .def("size", &DataColumn::size)
+        .def("numeric", &DataColumn::numeric);
+
+    py::class_<ArrayColumn<double>, DataColumn, std::shared_ptr<ArrayColumn<double>>>(m, "FloatColumn")
+        .def(py::init<std::vector<double>>())
+        .def("format", &ArrayColumn<double>::format)
+        .def("setFormat", &ArrayColumn<double>::setFormat);
+
+    py::class_<ArrayColumn<int64_t>, DataColumn, std::shared_ptr<ArrayColumn<int64_t>>>(m, "IntColumn")
+        .def(py::init<std::vector<int64_t>>());
+
+    py::class_<ArrayColumn<std::string>, DataColumn, std::shared_ptr<ArrayColumn<std::string>>>(m, "StringColumn")
+        .def(py::init<std::vector<std::string>>());
+
+    py::class_<DataGrid, Widget, ref<DataGrid>, PyDataGrid>(m, "DataGrid")
+        .def(py::init<Widget *>(), py::arg("parent"))
+        .def("columnCount", &DataGrid::columnCount)
+        .def("addColumn", [](DataGrid &g, const std::string &caption, std::shared_ptr<DataColumn> column) {
+            g.addColumn(caption, column);
+        })
+        .def("setColumn", [](DataGrid &g, size_t index, std::shared_ptr<DataColumn> column) {
+            g.setColumn(index, column);
+        })
+        .def("caption", &DataGrid::caption)
+        .def("clearColumns", &DataGrid::clearColumns)
+        .def("columnWidth", &DataGrid::columnWidth)
+        .def("setColumnWidth", &DataGrid::setColumnWidth)
+        .def("rowCount", &DataGrid::rowCount)
+        .def("visibleRowCount", &DataGrid::visibleRowCount)
+        .def("visibleRow", &DataGrid::visibleRow)
+        .def("sortColumn", &DataGrid::sortColumn)
+        .def("sortAscending", &DataGrid::sortAscending)
+        .def("setSortColumn", &DataGrid::setSortColumn, py::arg("column"), py::arg("ascending") = true)
+        .def("filter", &DataGrid::filter)
+        .def("filterColumn", &DataGrid::filterColumn)
+        .def("setFilter", &DataGrid::setFilter, py::arg("filter"), py::arg("column") = -1)
+        .def("updatePending", &DataGrid::updatePending)
+        .def("refresh", &DataGrid::refresh)
+        .def("selectedRow", &DataGrid::selectedRow)
+        .def("setSelectedRow", &DataGrid::setSelectedRow)
+        .def("callback", &DataGrid::callback)
+        .def("setCallback", &DataGrid::setCallback);
 }
 
 #endif
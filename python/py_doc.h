@@ -2270,6 +2270,8 @@ static const char *__doc_nanogui_Popup_setAnchorPos =
 R"doc(Return the anchor position in the parent window; the placement of the
 popup is relative to it)doc";
 
+static const char *__doc_nanogui_Popup_setParentWindow = R"doc(Set the parent window of the popup (raises the popup above it))doc";
+
 static const char *__doc_nanogui_Popup_setSide = R"doc(Set the side of the parent window at which popup will appear)doc";
 
 static const char *__doc_nanogui_Popup_side = R"doc(Return the side of the parent window at which popup will appear)doc";
@@ -3125,18 +3127,6 @@ static const char *__doc_nanogui_Theme_mDropShadow =
 R"doc(The color of the drop shadow drawn behind widgets (default:
 intensity=``0``, alpha=``128``; see nanogui::Color::Color(int,int)).)doc";
 
-static const char *__doc_nanogui_Theme_mFontBold =
-R"doc(The bold font face (default: ``"sans-bold"`` from
-``resources/roboto_regular.ttf``).)doc";
-
-static const char *__doc_nanogui_Theme_mFontIcons =
-R"doc(The icon font face (default: ``"icons"`` from
-``resources/entypo.ttf``).)doc";
-
-static const char *__doc_nanogui_Theme_mFontNormal =
-R"doc(The standard font face (default: ``"sans"`` from
-``resources/roboto_regular.ttf``).)doc";
-
 static const char *__doc_nanogui_Theme_mIconColor = R"doc(The icon color (default: nanogui::Theme::mTextColor).)doc";
 
 static const char *__doc_nanogui_Theme_mIconScale =
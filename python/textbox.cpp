@@ -6,6 +6,7 @@ typedef FloatBox<double> DoubleBox;
 typedef IntBox<int64_t> Int64Box;
 
 DECLARE_WIDGET(TextBox);
+DECLARE_WIDGET(TextEditor);
 DECLARE_WIDGET(DoubleBox);
 DECLARE_WIDGET(Int64Box);
 
@@ -38,6 +39,26 @@ void register_textbox(py::module &m) {
         .value("Center", TextBox::Alignment::Center)
         .value("Right", TextBox::Alignment::Right);
 
+    py::class_<TextEditor, Widget, ref<TextEditor>, PyTextEditor>(m, "TextEditor")
+        .def(py::init<Widget *, const std::string &>(), py::arg("parent"),
+            py::arg("text") = std::string(""))
+        .def("editable", &TextEditor::editable)
+        .def("setEditable", &TextEditor::setEditable)
+        .def("text", &TextEditor::text)
+        .def("setText", &TextEditor::setText)
+        .def("textSize", &TextEditor::textSize)
+        .def("lineCount", &TextEditor::lineCount)
+        .def("lineStart", &TextEditor::lineStart)
+        .def("line", &TextEditor::line)
+        .def("insert", &TextEditor::insert)
+        .def("erase", &TextEditor::erase)
+        .def("cursorPosition", &TextEditor::cursorPosition)
+        .def("setCursorPosition", &TextEditor::setCursorPosition)
+        .def("select", &TextEditor::select)
+        .def("selectedText", &TextEditor::selectedText)
+        .def("callback", &TextEditor::callback)
+        .def("setCallback", &TextEditor::setCallback);
+
     py::class_<Int64Box, TextBox, ref<Int64Box>, PyInt64Box>(m, "IntBox", D(IntBox))
         .def(py::init<Widget *, int64_t>(), py::arg("parent"), py::arg("value") = (int64_t) 0, D(IntBox, IntBox))
         .def("value", &Int64Box::value, D(IntBox, value))
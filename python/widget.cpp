@@ -114,6 +114,16 @@ void register_widget(py::module &m) {
         .def("dropEvent", &Screen::dropEvent, D(Screen, dropEvent))
         .def("mousePos", &Screen::mousePos, D(Screen, mousePos))
         .def("pixelRatio", &Screen::pixelRatio, D(Screen, pixelRatio))
+        .def("eventCoalescing", &Screen::eventCoalescing)
+        .def("setEventCoalescing", &Screen::setEventCoalescing)
+        .def("processEvents", &Screen::processEvents)
+        .def("post", &Screen::post, py::arg("func"))
+        .def("hasPendingTasks", &Screen::hasPendingTasks)
+        .def("taskStatistics", &Screen::taskStatistics)
+        .def("recordFrame", &Screen::recordFrame, py::arg("filename"))
+        .def("frameAllocations", &Screen::frameAllocations)
+        .def("culledWidgets", &Screen::culledWidgets)
+        .def("setWindowLayer", &Screen::setWindowLayer, py::arg("window"), py::arg("layer"))
         .def("glfwWindow", &Screen::glfwWindow, D(Screen, glfwWindow),
                 py::return_value_policy::reference)
         .def("nvgContext", &Screen::nvgContext, D(Screen, nvgContext),
@@ -0,0 +1,236 @@
+/*
+    resources/respack.cpp -- Build-time helper which compresses resource
+    files (fonts, etc.) and embeds them into the NanoGUI library
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+
+    Usage: respack <output.cpp> <output.h> <output.bin> <incbin|array> <input files..>
+
+    All inputs are compressed using the LZ4 block format and concatenated
+    into a single blob. When 'incbin' mode is requested, the generated C++
+    file pulls in the blob via an assembler '.incbin' directive, which avoids
+    having to parse a huge initializer list. Otherwise, the compressed data is
+    written out as a (much smaller than before) array initializer.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> read_file(const std::string &filename) {
+    std::ifstream is(filename, std::ios::binary);
+    if (!is)
+        throw std::runtime_error("Could not open \"" + filename + "\"!");
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(is)),
+                                std::istreambuf_iterator<char>());
+}
+
+/* Write an LZ4-style length extension (runs of 255 followed by a remainder) */
+static void write_length(std::vector<uint8_t> &out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back((uint8_t) length);
+}
+
+static void write_sequence(std::vector<uint8_t> &out, const uint8_t *literals,
+                           size_t nLiterals, size_t offset, size_t matchLength) {
+    bool last = matchLength == 0;
+    size_t ml = last ? 0 : matchLength - 4;
+    uint8_t token = (uint8_t) ((std::min<size_t>(nLiterals, 15) << 4) |
+                               std::min<size_t>(ml, 15));
+    out.push_back(token);
+    if (nLiterals >= 15)
+        write_length(out, nLiterals - 15);
+    out.insert(out.end(), literals, literals + nLiterals);
+    if (last)
+        return;
+    out.push_back((uint8_t) (offset & 0xFF));
+    out.push_back((uint8_t) (offset >> 8));
+    if (ml >= 15)
+        write_length(out, ml - 15);
+}
+
+/* Greedy single-pass LZ4 block compressor (64 KiB window, 4-byte hash chains) */
+static std::vector<uint8_t> compress(const std::vector<uint8_t> &in) {
+    const size_t hashBits = 16, minMatch = 4, maxOffset = 65535, lastLiterals = 5;
+    const size_t n = in.size();
+    std::vector<uint8_t> out;
+    std::vector<int64_t> head(size_t(1) << hashBits, -1);
+    std::vector<int64_t> prev(n, -1);
+
+    auto hash = [&](size_t i) {
+        uint32_t v;
+        memcpy(&v, &in[i], 4);
+        return (v * 2654435761u) >> (32 - hashBits);
+    };
+
+    size_t anchor = 0, i = 0;
+    while (n >= lastLiterals + minMatch && i + lastLiterals + minMatch <= n) {
+        uint32_t h = hash(i);
+        size_t bestLength = 0, bestPos = 0;
+        int chain = 0;
+        for (int64_t cand = head[h]; cand >= 0 && i - (size_t) cand <= maxOffset && chain < 64;
+             cand = prev[(size_t) cand], ++chain) {
+            size_t length = 0, limit = n - lastLiterals - i;
+            while (length < limit && in[(size_t) cand + length] == in[i + length])
+                ++length;
+            if (length > bestLength) {
+                bestLength = length;
+                bestPos = (size_t) cand;
+            }
+        }
+        prev[i] = head[h];
+        head[h] = (int64_t) i;
+
+        if (bestLength < minMatch) {
+            ++i;
+            continue;
+        }
+
+        write_sequence(out, &in[anchor], i - anchor, i - bestPos, bestLength);
+        for (size_t j = i + 1; j < i + bestLength && j + minMatch <= n; ++j) {
+            uint32_t hj = hash(j);
+            prev[j] = head[hj];
+            head[hj] = (int64_t) j;
+        }
+        i += bestLength;
+        anchor = i;
+    }
+    write_sequence(out, in.data() + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+/* Turn a file name into a C identifier: "Roboto-Bold.ttf" -> "roboto_bold_ttf" */
+static std::string identifier(const std::string &path) {
+    std::string name = path.substr(path.find_last_of("/\\") + 1);
+    for (char &c : name) {
+        if (c == '.' || c == ' ' || c == '-')
+            c = '_';
+        c = (char) tolower(c);
+    }
+    return name;
+}
+
+static std::string escape(const std::string &str) {
+    std::string result;
+    for (char c : str) {
+        if (c == '\\' || c == '"')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        std::cerr << "Syntax: respack <output.cpp> <output.h> <output.bin> <incbin|array> <input files..>" << std::endl;
+        return -1;
+    }
+
+    std::string outputC = argv[1], outputH = argv[2], outputBin = argv[3];
+    bool incbin = strcmp(argv[4], "incbin") == 0;
+
+    struct Entry { std::string name; size_t offset, compressedSize, size; };
+    std::vector<Entry> entries;
+    std::vector<uint8_t> blob;
+
+    try {
+        for (int i = 5; i < argc; ++i) {
+            std::vector<uint8_t> data = read_file(argv[i]);
+            std::vector<uint8_t> compressed = compress(data);
+            entries.push_back(Entry{ identifier(argv[i]), blob.size(),
+                                     compressed.size(), data.size() });
+            blob.insert(blob.end(), compressed.begin(), compressed.end());
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "respack: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::ofstream bin(outputBin, std::ios::binary);
+    bin.write((const char *) blob.data(), (std::streamsize) blob.size());
+    bin.close();
+
+    std::ofstream h(outputH);
+    h << "/* Autogenerated by respack */\n\n"
+      << "#pragma once\n"
+      << "#include <stdint.h>\n\n"
+      << "struct nanogui_resource {\n"
+      << "    const char *name;\n"
+      << "    const uint8_t *data;\n"
+      << "    uint32_t compressed_size;\n"
+      << "    uint32_t size;\n"
+      << "};\n\n"
+      << "extern const nanogui_resource nanogui_resources[];\n"
+      << "extern const uint32_t nanogui_resources_count;\n";
+    h.close();
+
+    std::ofstream c(outputC);
+    c << "/* Autogenerated by respack */\n\n"
+      << "#include \"nanogui_resources.h\"\n\n";
+
+    if (incbin) {
+        c << "#if defined(__APPLE__)\n"
+          << "#  define NANOGUI_RESOURCE_SYMBOL \"_nanogui_resource_blob\"\n"
+          << "#  define NANOGUI_RESOURCE_SECTION \"__DATA,__const\"\n"
+          << "#  define NANOGUI_RESOURCE_VISIBILITY \".private_extern \"\n"
+          << "#else\n"
+          << "#  define NANOGUI_RESOURCE_SYMBOL \"nanogui_resource_blob\"\n"
+          << "#  define NANOGUI_RESOURCE_SECTION \".rodata\"\n"
+          << "#  define NANOGUI_RESOURCE_VISIBILITY \".hidden \"\n"
+          << "#endif\n\n"
+          << "__asm__(\n"
+          << "    \".pushsection \" NANOGUI_RESOURCE_SECTION \"\\n\"\n"
+          << "    \".globl \" NANOGUI_RESOURCE_SYMBOL \"\\n\"\n"
+          << "    NANOGUI_RESOURCE_VISIBILITY NANOGUI_RESOURCE_SYMBOL \"\\n\"\n"
+          << "    \".balign 16\\n\"\n"
+          << "    NANOGUI_RESOURCE_SYMBOL \":\\n\"\n"
+          << "    \".incbin \\\"" << escape(escape(outputBin)) << "\\\"\\n\"\n"
+          << "    \".byte 0\\n\"\n"
+          << "    \".popsection\\n\"\n"
+          << ");\n\n"
+          << "extern \"C\" const uint8_t nanogui_resource_blob[];\n\n";
+    } else {
+        c << "static const uint8_t nanogui_resource_blob[] = {";
+        for (size_t i = 0; i < blob.size(); ++i) {
+            if (i % 16 == 0)
+                c << "\n    ";
+            char buf[8];
+            snprintf(buf, sizeof(buf), "0x%02x,", blob[i]);
+            c << buf;
+        }
+        c << "\n    0x00\n};\n\n";
+    }
+
+    c << "const nanogui_resource nanogui_resources[] = {\n";
+    for (const Entry &e : entries)
+        c << "    { \"" << e.name << "\", nanogui_resource_blob + " << e.offset
+          << ", " << e.compressedSize << "u, " << e.size << "u },\n";
+    if (entries.empty())
+        c << "    { nullptr, nullptr, 0u, 0u }\n";
+    c << "};\n\n"
+      << "const uint32_t nanogui_resources_count = " << entries.size() << "u;\n";
+    c.close();
+
+    if (!bin || !h || !c) {
+        std::cerr << "respack: could not write output files!" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
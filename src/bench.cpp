@@ -0,0 +1,424 @@
+/*
+    src/bench.cpp -- Synthetic workloads that measure the performance of
+    widget tree construction, layout, event dispatch, serialization, form
+    updates, headless drawing, data grid sorting and plot decimation. Results
+    are printed as a table and can be written to a JSON file for tracking
+    regressions across commits.
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/widget.h>
+#include <nanogui/window.h>
+#include <nanogui/label.h>
+#include <nanogui/button.h>
+#include <nanogui/formhelper.h>
+#include <nanogui/datagrid.h>
+#include <nanogui/plotcanvas.h>
+#include <nanogui/layout.h>
+#include <nanogui/theme.h>
+#include <nanogui/softwarerenderer.h>
+#include <nanogui/objectarena.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace nanogui;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double mean, median, min; /* Seconds per iteration */
+    double items;             /* Items processed per iteration */
+};
+
+static std::vector<Result> results;
+static volatile size_t sink; /* Keeps the compiler from discarding results */
+static std::string filter;
+static double minTime = 0.5;
+static int minIterations = 3;
+
+/* Run 'func' until both the minimum time and number of iterations are reached */
+template <typename Func> static void run(const std::string &name, double items, Func func) {
+    if (!filter.empty() && name.find(filter) == std::string::npos)
+        return;
+
+    std::vector<double> times;
+    double total = 0;
+    while (total < minTime || (int) times.size() < minIterations) {
+        Clock::time_point start = Clock::now();
+        func();
+        double time = std::chrono::duration<double>(Clock::now() - start).count();
+        times.push_back(time);
+        total += time;
+    }
+
+    std::sort(times.begin(), times.end());
+    Result result;
+    result.name = name;
+    result.iterations = times.size();
+    result.mean = total / times.size();
+    result.median = times[times.size() / 2];
+    result.min = times.front();
+    result.items = items;
+    results.push_back(result);
+
+    printf("%-40s %10zu  %11.4f ms  %11.4f ms  %12.0f /s\n", name.c_str(),
+           result.iterations, result.median * 1000.0, result.min * 1000.0,
+           items / result.median);
+    fflush(stdout);
+}
+
+/* Build a tree of (approximately) 'count' widgets: a root with groups of one
+   label and nine buttons each */
+static ref<Widget> buildTree(Theme *theme, int count, bool ids = false) {
+    ref<Widget> root = new Widget(nullptr);
+    root->setTheme(theme);
+    int groups = std::max(count / 11, 1);
+    for (int i = 0; i < groups; ++i) {
+        Widget *group = new Widget(root);
+        Label *label = new Label(group, "Group " + std::to_string(i));
+        if (ids) {
+            group->setId("group" + std::to_string(i));
+            label->setId("label");
+        }
+        for (int j = 0; j < 9; ++j) {
+            Button *button = new Button(group, "Button");
+            if (ids)
+                button->setId("button" + std::to_string(j));
+        }
+    }
+    return root;
+}
+
+enum LayoutKind { Box, Group, Grid, AdvancedGrid };
+static const char *layoutNames[] = { "BoxLayout", "GroupLayout", "GridLayout", "AdvancedGridLayout" };
+
+static Layout *createLayout(LayoutKind kind, Widget *widget) {
+    switch (kind) {
+        case Box: return new BoxLayout(Orientation::Vertical, Alignment::Fill, 2, 2);
+        case Group: return new GroupLayout();
+        case Grid: return new GridLayout(Orientation::Horizontal, 5, Alignment::Fill, 2, 2);
+        default: {
+            /* One row per child, anchored in the order of the children */
+            AdvancedGridLayout *layout = new AdvancedGridLayout(
+                { 0 }, std::vector<int>(widget->childCount(), 0), 2);
+            for (int i = 0; i < widget->childCount(); ++i)
+                layout->setAnchor(widget->childAt(i), AdvancedGridLayout::Anchor(0, i));
+            return layout;
+        }
+    }
+}
+
+static void setLayout(Widget *widget, LayoutKind kind) {
+    widget->setLayout(createLayout(kind, widget));
+    for (Widget *child : widget->children())
+        if (child->childCount() > 0)
+            setLayout(child, kind);
+}
+
+static void benchTrees(Theme *theme, NVGcontext *ctx) {
+    const int sizes[] = { 1000, 10000, 100000 };
+
+    for (int size : sizes) {
+        std::string suffix = "/" + std::to_string(size);
+
+        /* Includes the destruction of the tree */
+        run("tree_build" + suffix, size, [&] { buildTree(theme, size); });
+
+        run("tree_build_arena" + suffix, size, [&] {
+            ref<ObjectArena> arena = new ObjectArena();
+            ObjectArena::Scope scope(arena);
+            buildTree(theme, size);
+        });
+
+        for (int kind = Box; kind <= AdvancedGrid; ++kind) {
+            ref<Widget> root = buildTree(theme, size);
+            setLayout(root, (LayoutKind) kind);
+            run(std::string("layout_") + layoutNames[kind] + suffix, size,
+                [&] { root->performLayout(ctx); });
+        }
+
+        ref<Widget> root = buildTree(theme, size);
+
+        /* Assigns a ref<Theme> to every widget (reference counting overhead) */
+        ref<Theme> otherTheme = new Theme(ctx);
+        bool flip = false;
+        run("set_theme" + suffix, size, [&] {
+            root->setTheme((flip = !flip) ? otherTheme.get() : theme);
+        });
+
+        setLayout(root, Grid);
+        root->performLayout(ctx);
+        root->setSize(root->preferredSize(ctx));
+
+        std::mt19937 rng(size);
+        std::uniform_int_distribution<int> x(0, root->width()), y(0, root->height());
+        std::vector<Vector2i> points(10000);
+        for (auto &p : points)
+            p = Vector2i(x(rng), y(rng));
+
+        run("find_widget" + suffix, (double) points.size(), [&] {
+            size_t found = 0;
+            for (const auto &p : points)
+                found += root->findWidget(p) != nullptr;
+            sink = found;
+        });
+
+        run("dispatch_motion" + suffix, (double) points.size(), [&] {
+            Vector2i last = points.back();
+            for (const auto &p : points) {
+                root->mouseMotionEvent(p, p - last, 0, 0);
+                last = p;
+            }
+        });
+
+        run("dispatch_scroll" + suffix, (double) points.size(), [&] {
+            for (const auto &p : points)
+                root->scrollEvent(p, Vector2f(0.f, 1.f));
+        });
+    }
+}
+
+/* Find the enclosing window from the leaf of a deep chain of widgets */
+static void benchLookup(Theme *theme) {
+    for (int depth : { 16, 256 }) {
+        ref<Window> window = new Window(nullptr, "Lookup");
+        window->setTheme(theme);
+        Widget *leaf = window;
+        for (int i = 0; i < depth; ++i)
+            leaf = new Widget(leaf);
+
+        const int lookups = 10000;
+        run("window_lookup/" + std::to_string(depth), lookups, [&] {
+            size_t found = 0;
+            for (int i = 0; i < lookups; ++i)
+                found += leaf->window() == window.get();
+            sink = found;
+        });
+    }
+}
+
+static void benchSerializer(Theme *theme) {
+    const std::string filename = "nanogui_bench.tmp";
+
+    for (int size : { 1000, 10000 }) {
+        std::string suffix = "/" + std::to_string(size);
+        ref<Widget> root = buildTree(theme, size, true);
+        root->setId("root");
+
+        run("serialize_save_tree" + suffix, size, [&] {
+            Serializer s(filename, true);
+            s.set("root", *root);
+        });
+
+        run("serialize_load_tree" + suffix, size, [&] {
+            Serializer s(filename, false);
+            s.get("root", *root);
+        });
+    }
+
+    for (int size : { 256, 2048 }) {
+        std::string suffix = "/" + std::to_string(size) + "x" + std::to_string(size);
+        MatrixXf matrix = MatrixXf::Random(size, size), loaded;
+        double bytes = (double) matrix.size() * sizeof(float);
+
+        run("serialize_save_matrix" + suffix, bytes, [&] {
+            Serializer s(filename, true);
+            s.set("matrix", matrix);
+        });
+
+        run("serialize_load_matrix" + suffix, bytes, [&] {
+            Serializer s(filename, false);
+            s.get("matrix", loaded);
+        });
+    }
+
+    std::remove(filename.c_str());
+}
+
+static void benchForm(Theme *theme) {
+    for (int size : { 1000, 5000 }) {
+        ref<Window> window = new Window(nullptr, "Form");
+        window->setTheme(theme);
+        window->setLayout(new AdvancedGridLayout({10, 0, 10, 0}, {}));
+        FormHelper helper(nullptr);
+        helper.setWindow(window);
+
+        std::vector<int> ints(size / 2);
+        std::vector<double> doubles(size - size / 2);
+        for (size_t i = 0; i < ints.size(); ++i)
+            helper.addVariable("Integer " + std::to_string(i), ints[i]);
+        for (size_t i = 0; i < doubles.size(); ++i)
+            helper.addVariable("Double " + std::to_string(i), doubles[i]);
+
+        /* Every bound value changes between two refreshes */
+        int frame = 0;
+        run("form_refresh/" + std::to_string(size), size, [&] {
+            frame++;
+            for (size_t i = 0; i < ints.size(); ++i)
+                ints[i] = (int) i * 7 + frame;
+            for (size_t i = 0; i < doubles.size(); ++i)
+                doubles[i] = i * 0.1234 + frame;
+            helper.refresh();
+        });
+    }
+}
+
+static void benchDraw(Theme *theme, SoftwareRenderer &renderer) {
+    NVGcontext *ctx = renderer.nvgContext();
+
+    for (int size : { 100, 1000 }) {
+        std::string suffix = "/" + std::to_string(size);
+        ref<Window> window = new Window(nullptr, "Benchmark");
+        window->setTheme(theme);
+        window->setLayout(new GridLayout(Orientation::Horizontal, 10, Alignment::Fill, 4, 2));
+        for (int i = 0; i < size; ++i)
+            new Button(window, "Button " + std::to_string(i));
+        window->performLayout(ctx);
+        window->setSize(window->preferredSize(ctx));
+
+        run("draw_software" + suffix, size, [&] {
+            renderer.render(window, Color(0.3f, 1.f));
+        });
+    }
+}
+
+static void benchGrid(Theme *theme, SoftwareRenderer &renderer) {
+    NVGcontext *ctx = renderer.nvgContext();
+    const size_t rows = 1000000;
+
+    std::mt19937 rng(0);
+    std::vector<double> values(rows);
+    std::vector<uint32_t> ids(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        values[i] = rng() * (1.0 / 4294967296.0);
+        ids[i] = (uint32_t) i;
+    }
+    auto column = std::make_shared<ArrayColumn<double>>(std::move(values));
+
+    std::vector<uint32_t> order(rows);
+    run("column_sort/" + std::to_string(rows), rows, [&] {
+        std::iota(order.begin(), order.end(), 0u);
+        column->sort(order.data(), order.data() + rows, true);
+        sink = order[0];
+    });
+
+    /* Only the rows in view are formatted and drawn */
+    ref<Window> window = new Window(nullptr, "Grid");
+    window->setTheme(theme);
+    window->setLayout(new GroupLayout());
+    DataGrid *grid = new DataGrid(window);
+    grid->addColumn("Index", std::make_shared<ArrayColumn<uint32_t>>(std::move(ids)));
+    grid->addColumn("Value", column);
+    grid->setFixedSize(Vector2i(600, 500));
+    window->performLayout(ctx);
+    window->setSize(window->preferredSize(ctx));
+
+    run("draw_grid/" + std::to_string(rows), 1, [&] {
+        renderer.render(window, Color(0.3f, 1.f));
+    });
+}
+
+static void benchPlot() {
+    /* Appending points maintains the decimation pyramid; nothing is drawn,
+       so no OpenGL context is needed */
+    const size_t points = 1000000, batch = 1000;
+    std::vector<double> x(points);
+    std::vector<float> y(points);
+    for (size_t i = 0; i < points; ++i) {
+        x[i] = (double) i;
+        y[i] = std::sin(i * 0.001f);
+    }
+
+    run("plot_append/" + std::to_string(points), points, [&] {
+        ref<PlotCanvas> plot = new PlotCanvas(nullptr);
+        size_t series = plot->addSeries("Series", Color(1.f, 1.f));
+        for (size_t i = 0; i < points; i += batch)
+            plot->append(series, x.data() + i, y.data() + i, batch);
+        sink = plot->pointCount(series);
+    });
+}
+
+static void writeJSON(const std::string &filename) {
+    std::ofstream os(filename);
+    if (!os)
+        throw std::runtime_error("Could not open \"" + filename + "\" for writing!");
+    os << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        os << "    { \"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+           << ", \"mean_ms\": " << r.mean * 1000.0 << ", \"median_ms\": " << r.median * 1000.0
+           << ", \"min_ms\": " << r.min * 1000.0 << ", \"items_per_second\": "
+           << r.items / r.median << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+static void usage() {
+    std::cerr << "Syntax: nanogui_bench [options]" << std::endl
+              << "Options:" << std::endl
+              << "  --filter <text>    Only run benchmarks whose name contains <text>" << std::endl
+              << "  --json <file>      Write the results to a JSON file" << std::endl
+              << "  --min-time <sec>   Minimum running time per benchmark (default: 0.5)" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    std::string json;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTime = atof(argv[++i]);
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    try {
+        /* The software renderer provides a NanoVG context without a window */
+        SoftwareRenderer renderer(Vector2i(1280, 800));
+        ref<Theme> theme = new Theme(renderer.nvgContext());
+        theme->loadFonts(renderer.nvgContext());
+
+        printf("%-40s %10s  %14s  %14s  %15s\n", "Benchmark", "Iterations",
+               "Median", "Min", "Throughput");
+
+        benchTrees(theme, renderer.nvgContext());
+        benchLookup(theme);
+        benchSerializer(theme);
+        benchForm(theme);
+        benchDraw(theme, renderer);
+        benchGrid(theme, renderer);
+        benchPlot();
+
+        if (!json.empty())
+            writeJSON(json);
+    } catch (const std::exception &e) {
+        std::cerr << "Caught a fatal error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -10,6 +10,9 @@
 */
 
 #include <nanogui/screen.h>
+#include <nanogui/taskqueue.h>
+#include <nanogui/tracing.h>
+#include <nanogui/framearena.h>
 
 #if defined(_WIN32)
 #  include <windows.h>
@@ -17,8 +20,10 @@
 
 #include <nanogui/opengl.h>
 #include <map>
+#include <atomic>
 #include <thread>
-#include <chrono>
+#include <mutex>
+#include <limits>
 #include <iostream>
 
 #if !defined(_WIN32)
@@ -59,33 +64,176 @@ void init() {
     glfwSetTime(0);
 }
 
-static bool mainloop_active = false;
+/* Read by functions that may be called from other threads (e.g. async()) */
+static std::atomic<bool> mainloop_active { false };
+static float frame_rate_limit = 0.f;
+static bool threaded_rendering = false;
 
-void mainloop(int refresh) {
-    if (mainloop_active)
-        throw std::runtime_error("Main loop is already running!");
+void setThreadedRendering(bool value) {
+    threaded_rendering = value;
+}
+
+bool threadedRendering() {
+    return threaded_rendering;
+}
+
+void setFrameRateLimit(float fps) {
+    frame_rate_limit = fps;
+}
+
+float frameRateLimit() {
+    return frame_rate_limit;
+}
+
+/* Minimum time between two frames (in seconds) according to the frame rate limit */
+static double frame_interval() {
+    float fps = frame_rate_limit;
+    if (fps < 0) {
+        /* Pace frames to the refresh rate of the primary monitor */
+        GLFWmonitor *monitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode *mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+        fps = (mode && mode->refreshRate > 0) ? (float) mode->refreshRate : 60.f;
+    }
+    return fps > 0 ? 1.0 / fps : 0.0;
+}
+
+/* Timers and redraw requests, see addTimer() and scheduleRedraw() */
+struct Timer {
+    int id;
+    double deadline, interval;
+    std::function<void()> callback;
+};
+
+static std::mutex timer_mutex;
+static std::vector<Timer> timers;
+static int timer_next_id = 1;
+static double redraw_deadline = std::numeric_limits<double>::infinity();
+static double wait_deadline = std::numeric_limits<double>::infinity();
+static std::thread::id mainloop_thread;
+
+/* Called with 'timer_mutex' held: wake up the main loop if it sleeps past 'deadline' */
+static void wake_mainloop(double deadline) {
+    if (mainloop_active && deadline < wait_deadline &&
+        std::this_thread::get_id() != mainloop_thread) {
+        wait_deadline = deadline;
+        glfwPostEmptyEvent();
+    }
+}
+
+int addTimer(double delay, const std::function<void()> &callback, bool repeat) {
+    std::lock_guard<std::mutex> guard(timer_mutex);
+    double deadline = glfwGetTime() + delay;
+    int id = timer_next_id++;
+    /* A zero period would keep the main loop from ever going to sleep */
+    timers.push_back(Timer{ id, deadline, repeat ? std::max(delay, 1e-3) : -1.0, callback });
+    wake_mainloop(deadline);
+    return id;
+}
+
+void removeTimer(int id) {
+    std::lock_guard<std::mutex> guard(timer_mutex);
+    timers.erase(std::remove_if(timers.begin(), timers.end(),
+                                [id](const Timer &t) { return t.id == id; }),
+                 timers.end());
+}
+
+void scheduleRedraw(double delay) {
+    std::lock_guard<std::mutex> guard(timer_mutex);
+    double deadline = glfwGetTime() + delay;
+    if (deadline < redraw_deadline) {
+        redraw_deadline = deadline;
+        wake_mainloop(deadline);
+    }
+}
+
+/* Rendering threads read the clock while the main thread may replace it.
+   The clock is also invoked under the lock, so that setTimeSource() does
+   not return while another thread still uses the previous one */
+static std::mutex time_source_mutex;
+static std::function<double()> time_source;
+
+double getTime() {
+    std::lock_guard<std::mutex> guard(time_source_mutex);
+    return time_source ? time_source() : glfwGetTime();
+}
+
+void setTimeSource(const std::function<double()> &source) {
+    std::lock_guard<std::mutex> guard(time_source_mutex);
+    time_source = source;
+}
 
-    mainloop_active = true;
-
-    std::thread refresh_thread;
-    if (refresh > 0) {
-        /* If there are no mouse/keyboard events, try to refresh the
-           view roughly every 50 ms (default); this is to support animations
-           such as progress bars while keeping the system load
-           reasonably low */
-        refresh_thread = std::thread(
-            [refresh]() {
-                std::chrono::milliseconds time(refresh);
-                while (mainloop_active) {
-                    std::this_thread::sleep_for(time);
-                    glfwPostEmptyEvent();
+/* Tasks submitted from other threads, see async() */
+static TaskQueue async_queue;
+
+void async(const std::function<void()> &func) {
+    /* Only the first task of a batch needs to wake up the main loop */
+    if (async_queue.push(func) && mainloop_active)
+        glfwPostEmptyEvent();
+}
+
+TaskQueue::Statistics asyncStatistics() {
+    return async_queue.statistics();
+}
+
+/* Run all expired timers */
+static void run_timers(double now) {
+    std::vector<std::function<void()>> expired;
+    {
+        std::lock_guard<std::mutex> guard(timer_mutex);
+        for (auto it = timers.begin(); it != timers.end(); ) {
+            if (it->deadline <= now) {
+                expired.push_back(it->callback);
+                if (it->interval < 0) {
+                    it = timers.erase(it);
+                    continue;
                 }
+                /* Skip missed periods rather than firing repeatedly */
+                it->deadline = std::max(it->deadline + it->interval, now);
             }
-        );
+            ++it;
+        }
     }
+    if (expired.empty())
+        return;
+    /* Callbacks may modify widgets that rendering threads are drawing */
+    ScreenLock lock;
+    for (auto &callback : expired)
+        callback();
+}
+
+void mainloop(int refresh) {
+    if (mainloop_active.exchange(true))
+        throw std::runtime_error("Main loop is already running!");
+    /* Only the running loop records its thread (not a rejected second call) */
+    {
+        std::lock_guard<std::mutex> guard(timer_mutex);
+        mainloop_thread = std::this_thread::get_id();
+    }
+#if defined(NANOGUI_TRACING)
+    setTraceThreadName("Main thread");
+#endif
 
     try {
         while (mainloop_active) {
+            double frameStart = glfwGetTime();
+            /* Release the transient allocations of the previous frame */
+            FrameArena::thread().reset();
+            {
+                NANOGUI_TRACE_SCOPE("timers");
+                run_timers(frameStart);
+            }
+            if (!async_queue.empty()) {
+                NANOGUI_TRACE_SCOPE("async tasks");
+                ScreenLock lock;
+                async_queue.run();
+            }
+
+            /* Drawing may schedule further animation frames */
+            {
+                std::lock_guard<std::mutex> guard(timer_mutex);
+                redraw_deadline = std::numeric_limits<double>::infinity();
+            }
+
             int numScreens = 0;
             for (auto kv : __nanogui_screens) {
                 Screen *screen = kv.second;
@@ -95,7 +243,20 @@ void mainloop(int refresh) {
                     screen->setVisible(false);
                     continue;
                 }
-                screen->drawAll();
+                if (threaded_rendering) {
+                    /* Dispatch events here, but draw and swap buffers
+                       on the screen's own rendering thread */
+                    if (!screen->renderThreadActive())
+                        screen->startRenderThread();
+                    screen->processEvents();
+                    screen->requestFrame();
+                } else {
+                    if (screen->renderThreadActive())
+                        screen->stopRenderThread();
+                    /* Also dispatches the queued events, which makes them
+                       part of the frame's allocation statistics */
+                    screen->drawAll();
+                }
                 numScreens++;
             }
 
@@ -105,8 +266,49 @@ void mainloop(int refresh) {
                 break;
             }
 
-            /* Wait for mouse/keyboard or empty refresh events */
-            glfwWaitEvents();
+            /* Sleep until the next mouse/keyboard event, timer, or animation
+               frame. If requested, also refresh the view roughly every
+               'refresh' ms (50 ms by default) for applications that animate
+               without scheduling redraws. Otherwise, an idle application
+               causes no wakeups at all */
+            double next;
+            {
+                std::lock_guard<std::mutex> guard(timer_mutex);
+                next = redraw_deadline;
+                for (const Timer &timer : timers)
+                    next = std::min(next, timer.deadline);
+                if (refresh > 0)
+                    next = std::min(next, frameStart + refresh / 1000.0);
+                /* Don't sleep when tasks were queued during this frame */
+                bool pending = !async_queue.empty();
+                for (auto kv : __nanogui_screens)
+                    pending |= kv.second->hasPendingTasks();
+                if (pending)
+                    next = -std::numeric_limits<double>::infinity();
+                wait_deadline = next;
+            }
+
+            double now = glfwGetTime();
+            {
+                NANOGUI_TRACE_SCOPE("wait for events");
+                if (next == std::numeric_limits<double>::infinity())
+                    glfwWaitEvents();
+                else if (next > now)
+                    glfwWaitEventsTimeout(next - now);
+                else
+                    glfwPollEvents();
+            }
+
+            /* When a frame rate limit is active, keep collecting (and
+               coalescing) input until the next frame is due. This bounds
+               the input latency by the frame interval while avoiding a
+               redraw for every single event of a high-rate mouse */
+            double interval = frame_interval();
+            if (interval > 0) {
+                double deadline = frameStart + interval;
+                while (mainloop_active && (now = glfwGetTime()) < deadline)
+                    glfwWaitEventsTimeout(deadline - now);
+            }
         }
 
         /* Process events once more */
@@ -116,12 +318,14 @@ void mainloop(int refresh) {
         leave();
     }
 
-    if (refresh > 0)
-        refresh_thread.join();
+    for (auto kv : __nanogui_screens)
+        kv.second->stopRenderThread();
 }
 
 void leave() {
     mainloop_active = false;
+    /* Wake up the main loop in case it is waiting for events */
+    glfwPostEmptyEvent();
 }
 
 bool active() {
@@ -327,16 +531,24 @@ std::vector<std::string> file_dialog(const std::vector<std::pair<std::string, st
 #endif
 
 void Object::decRef(bool dealloc) const noexcept {
-    --m_refCount;
-    if (m_refCount == 0 && dealloc) {
+    checkThread();
+    int refCount = --m_refCount;
+    if (refCount == 0 && dealloc) {
         delete this;
-    } else if (m_refCount < 0) {
+    } else if (refCount < 0) {
         fprintf(stderr, "Internal error: Object reference count < 0!\n");
         abort();
     }
 }
 
-Object::~Object() { }
+#if defined(NANOGUI_NONATOMIC_REFCOUNT)
+void Object::threadError() const {
+    fprintf(stderr, "Internal error: the reference count of an object was "
+                    "modified outside of the thread that created it, which "
+                    "requires building without NANOGUI_NONATOMIC_REFCOUNT!\n");
+    abort();
+}
+#endif
 
 NAMESPACE_END(nanogui)
 
@@ -0,0 +1,445 @@
+/*
+    src/console.cpp -- Scrolling log view that accepts lines from any thread
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/console.h>
+#include <nanogui/coroutine.h>
+#include <nanogui/opengl.h>
+#include <nanogui/theme.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const float Padding = 4.f;
+static const float ScrollbarWidth = 12.f;
+
+/* Break a line into rows and invoke 'func' for each of them. Returns the
+   number of rows (at least one) */
+template <typename Func>
+static int forEachRow(NVGcontext *ctx, const std::string &text, float width, Func func) {
+    const char *begin = text.data(), *end = begin + text.size();
+    const int batchSize = 32;
+    NVGtextRow rows[batchSize];
+    int total = 0;
+    for (const char *it = begin; it < end; ) {
+        int count = nvgTextBreakLines(ctx, it, end, width, rows, batchSize);
+        for (int i = 0; i < count; ++i) {
+            /* NanoVG skips leading white space, which would hide indentation */
+            if (total + i == 0)
+                rows[i].start = begin;
+            func(rows[i]);
+        }
+        total += count;
+        if (count < batchSize)
+            break;
+        it = rows[count - 1].next;
+    }
+    return std::max(total, 1);
+}
+
+Console::Console(Widget *parent, size_t capacity)
+    : Widget(parent), mPending(nullptr), mPendingCount(0), mPendingLimit(std::max(capacity, (size_t) 1)),
+      mDropped(0), mRing(std::max(capacity, (size_t) 1)),
+      mFirst(0), mCount(0), mFirstSeq(0), mViewMeasured(0), mRowEnd(0),
+      mFilterPending(false), mWrapWidth(-1.f), mLineHeight(0.f), mScrollRow(0),
+      mFollow(true), mDragScrollbar(false) { }
+
+size_t Console::deleteLines(PendingLine *line) {
+    size_t count = 0;
+    while (line) {
+        PendingLine *next = line->next;
+        delete line;
+        line = next;
+        count++;
+    }
+    return count;
+}
+
+Console::~Console() {
+    deleteLines(mPending.exchange(nullptr));
+}
+
+void Console::append(const std::string &text) {
+    /* Nothing drains the list while the console isn't drawn. Rather than
+       letting it grow, discard the pending lines once the ring buffer could
+       not hold any more of them; newer lines are kept */
+    if (mPendingCount.fetch_add(1, std::memory_order_relaxed) >= mPendingLimit.load(std::memory_order_relaxed)) {
+        size_t dropped = deleteLines(mPending.exchange(nullptr, std::memory_order_acquire));
+        mPendingCount.fetch_sub(dropped, std::memory_order_relaxed);
+        mDropped.fetch_add(dropped, std::memory_order_relaxed);
+    }
+
+    /* 'line' may be taken and deleted by another thread as soon as it is
+       published, so the previous head is kept in a local variable */
+    PendingLine *line = new PendingLine{ text, nullptr };
+    PendingLine *head = mPending.load(std::memory_order_relaxed);
+    do {
+        line->next = head;
+    } while (!mPending.compare_exchange_weak(head, line, std::memory_order_release,
+                                             std::memory_order_relaxed));
+
+    /* Only the first line of a batch needs to wake up the main loop */
+    if (!head)
+        scheduleRedraw();
+}
+
+void Console::flush() {
+    uint64_t dropped = mDropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+        push("[" + std::to_string(dropped) + " lines dropped]");
+
+    PendingLine *line = mPending.exchange(nullptr, std::memory_order_acquire);
+
+    /* The list holds the most recent line first: reverse it, and skip lines
+       that would be discarded right away */
+    PendingLine *ordered = nullptr;
+    size_t count = 0;
+    while (line) {
+        PendingLine *next = line->next;
+        mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+        if (count++ < mRing.size()) {
+            line->next = ordered;
+            ordered = line;
+        } else {
+            delete line;
+        }
+        line = next;
+    }
+
+    while (ordered) {
+        PendingLine *next = ordered->next;
+        const std::string &text = ordered->text;
+        size_t start = 0;
+        while (true) {
+            size_t pos = text.find('\n', start);
+            if (pos == std::string::npos) {
+                /* A trailing line break does not start an empty line */
+                if (start < text.size() || start == 0)
+                    push(text.substr(start));
+                break;
+            }
+            push(text.substr(start, pos - start));
+            start = pos + 1;
+        }
+        delete ordered;
+        ordered = next;
+    }
+
+    applyFilterResult();
+}
+
+void Console::push(std::string &&text) {
+    if (mCount == mRing.size()) {
+        mRing[mFirst] = Entry();
+        mFirst = (mFirst + 1) % mRing.size();
+        mFirstSeq++;
+        mCount--;
+        while (!mView.empty() && mView.front().seq < mFirstSeq) {
+            mView.pop_front();
+            if (mViewMeasured > 0)
+                mViewMeasured--;
+        }
+    }
+
+    uint64_t seq = mFirstSeq + mCount++;
+    Entry &e = entry(seq);
+    e.text = std::make_shared<const std::string>(std::move(text));
+    e.rows = 0;
+    e.match = matches(*e.text);
+    if (e.match)
+        mView.push_back(ViewItem{ seq, 0 });
+}
+
+void Console::clear() {
+    mPendingCount.fetch_sub(deleteLines(mPending.exchange(nullptr, std::memory_order_acquire)),
+                            std::memory_order_relaxed);
+    mDropped = 0;
+    for (size_t i = 0; i < mCount; ++i)
+        entry(mFirstSeq + i) = Entry();
+    mFirstSeq += mCount;
+    mFirst = 0;
+    mCount = 0;
+    mView.clear();
+    mViewMeasured = 0;
+    mFollow = true;
+}
+
+void Console::setCapacity(size_t capacity) {
+    capacity = std::max(capacity, (size_t) 1);
+    if (capacity == mRing.size())
+        return;
+    mPendingLimit = capacity;
+
+    size_t keep = std::min(mCount, capacity);
+    std::vector<Entry> ring(capacity);
+    for (size_t i = 0; i < keep; ++i)
+        ring[i] = std::move(entry(mFirstSeq + mCount - keep + i));
+
+    mFirstSeq += mCount - keep;
+    mRing.swap(ring);
+    mFirst = 0;
+    mCount = keep;
+    while (!mView.empty() && mView.front().seq < mFirstSeq) {
+        mView.pop_front();
+        if (mViewMeasured > 0)
+            mViewMeasured--;
+    }
+}
+
+bool Console::matches(const std::string &text) const {
+    return mFilter.empty() || text.find(mFilter) != std::string::npos;
+}
+
+void Console::setFilter(const std::string &filter) {
+    if (filter == mFilter)
+        return;
+    mFilter = filter;
+
+    /* Lines arriving from now on are checked against the new filter */
+    if (filter.empty() || mCount == 0) {
+        mFilterResult.reset();
+        mFilterPending = false;
+        for (size_t i = 0; i < mCount; ++i)
+            entry(mFirstSeq + i).match = true;
+        rebuildView();
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, std::shared_ptr<const std::string>>> lines;
+    lines.reserve(mCount);
+    for (size_t i = 0; i < mCount; ++i)
+        lines.emplace_back(mFirstSeq + i, entry(mFirstSeq + i).text);
+
+    auto result = std::make_shared<FilterResult>();
+    result->endSeq = mFirstSeq + mCount;
+    mFilterResult = result;
+    mFilterPending = true;
+
+    background([result, lines, filter] {
+        for (const auto &line : lines)
+            if (line.second->find(filter) != std::string::npos)
+                result->matches.push_back(line.first);
+        result->ready.store(true, std::memory_order_release);
+        scheduleRedraw();
+    });
+}
+
+void Console::applyFilterResult() {
+    if (!mFilterResult || !mFilterResult->ready.load(std::memory_order_acquire))
+        return;
+    std::shared_ptr<FilterResult> result = std::move(mFilterResult);
+    mFilterPending = false;
+
+    /* Lines appended after the scan started were already checked */
+    uint64_t end = std::min(result->endSeq, mFirstSeq + mCount);
+    for (uint64_t seq = mFirstSeq; seq < end; ++seq)
+        entry(seq).match = false;
+    for (uint64_t seq : result->matches)
+        if (seq >= mFirstSeq && seq < end)
+            entry(seq).match = true;
+    rebuildView();
+}
+
+void Console::rebuildView() {
+    mView.clear();
+    for (size_t i = 0; i < mCount; ++i)
+        if (entry(mFirstSeq + i).match)
+            mView.push_back(ViewItem{ mFirstSeq + i, 0 });
+    mViewMeasured = 0;
+    mRowEnd = 0;
+    mFollow = true;
+}
+
+void Console::measureView(NVGcontext *ctx) {
+    for (size_t i = mViewMeasured; i < mView.size(); ++i) {
+        Entry &e = entry(mView[i].seq);
+        if (e.rows == 0)
+            e.rows = forEachRow(ctx, *e.text, mWrapWidth, [](const NVGtextRow &) { });
+        mView[i].row = mRowEnd;
+        mRowEnd += (uint64_t) e.rows;
+    }
+    mViewMeasured = mView.size();
+}
+
+double Console::maxScrollRow() const {
+    double visibleRows = mLineHeight > 0 ? (mSize.y() - 2 * Padding) / mLineHeight : 0;
+    return std::max((double) firstRow(), (double) mRowEnd - visibleRows);
+}
+
+size_t Console::itemAtRow(double row) const {
+    auto it = std::upper_bound(mView.begin(), mView.begin() + mViewMeasured, row,
+        [](double r, const ViewItem &item) { return r < (double) item.row; });
+    return it == mView.begin() ? 0 : (size_t) (it - mView.begin()) - 1;
+}
+
+void Console::setTheme(Theme *theme) {
+    Widget::setTheme(theme);
+    mWrapWidth = -1.f;
+}
+
+bool Console::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    if (button == GLFW_MOUSE_BUTTON_1 && down &&
+        p.x() >= mPos.x() + mSize.x() - ScrollbarWidth) {
+        mDragScrollbar = true;
+        return true;
+    }
+    if (!down)
+        mDragScrollbar = false;
+    return Widget::mouseButtonEvent(p, button, down, modifiers);
+}
+
+bool Console::mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) {
+    if (!mDragScrollbar)
+        return Widget::mouseDragEvent(p, rel, button, modifiers);
+
+    double total = (double) (mRowEnd - firstRow());
+    double visible = total - (maxScrollRow() - firstRow());
+    float scrollh = (mSize.y() - 8) * (float) std::min(1.0, visible / std::max(total, 1.0));
+    float track = mSize.y() - 8 - scrollh;
+    if (track > 0) {
+        mScrollRow += rel.y() * (total - visible) / track;
+        mFollow = mScrollRow >= maxScrollRow();
+    }
+    return true;
+}
+
+bool Console::scrollEvent(const Vector2i &/* p */, const Vector2f &rel) {
+    mScrollRow -= rel.y() * 3;
+    mFollow = mScrollRow >= maxScrollRow();
+    return true;
+}
+
+Vector2i Console::preferredSize(NVGcontext *) const {
+    return Vector2i(fontSize() * 25, (int) (fontSize() * 1.2f * 10 + 2 * Padding));
+}
+
+void Console::draw(NVGcontext* ctx) {
+    Widget::draw(ctx);
+    flush();
+
+    NVGpaint bg = nvgBoxGradient(ctx,
+        mPos.x() + 1, mPos.y() + 1 + 1.0f, mSize.x() - 2, mSize.y() - 2,
+        3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + 1, mPos.y() + 1, mSize.x() - 2, mSize.y() - 2, 3);
+    nvgFillPaint(ctx, bg);
+    nvgFill(ctx);
+
+    nvgFontSize(ctx, fontSize());
+    nvgFontFace(ctx, "sans");
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+    float ascender, descender, lineh;
+    nvgTextMetrics(ctx, &ascender, &descender, &lineh);
+    mLineHeight = lineh;
+
+    float x0 = mPos.x() + Padding, y0 = mPos.y() + Padding;
+    float width = mSize.x() - 2 * Padding - ScrollbarWidth,
+          height = mSize.y() - 2 * Padding;
+
+    if (width != mWrapWidth) {
+        /* Re-wrap everything, keeping the topmost line in place */
+        bool anchored = !mFollow && mViewMeasured > 0;
+        uint64_t anchor = anchored ? mView[itemAtRow(mScrollRow)].seq : 0;
+
+        mWrapWidth = width;
+        for (size_t i = 0; i < mCount; ++i)
+            entry(mFirstSeq + i).rows = 0;
+        mViewMeasured = 0;
+        mRowEnd = 0;
+        measureView(ctx);
+
+        if (anchored) {
+            auto it = std::lower_bound(mView.begin(), mView.end(), anchor,
+                [](const ViewItem &item, uint64_t seq) { return item.seq < seq; });
+            mScrollRow = it != mView.end() ? (double) it->row : (double) mRowEnd;
+        }
+    } else {
+        /* Only lines that arrived since the last frame are wrapped */
+        measureView(ctx);
+    }
+
+    double maxRow = maxScrollRow();
+    if (mFollow)
+        mScrollRow = maxRow;
+    mScrollRow = std::max((double) firstRow(), std::min(mScrollRow, maxRow));
+
+    if (!mView.empty()) {
+        nvgSave(ctx);
+        nvgIntersectScissor(ctx, mPos.x() + 1, mPos.y() + 1,
+                            mSize.x() - ScrollbarWidth - 1, mSize.y() - 2);
+        nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+
+        size_t index = itemAtRow(mScrollRow);
+        float y = y0 + (float) ((double) mView[index].row - mScrollRow) * lineh;
+        for (; index < mView.size() && y < y0 + height; ++index) {
+            int drawn = 0;
+            int rows = forEachRow(ctx, *entry(mView[index].seq).text, mWrapWidth,
+                [&](const NVGtextRow &row) {
+                    if (y + lineh >= y0 && y < y0 + height && row.end > row.start)
+                        nvgText(ctx, x0, y, row.start, row.end);
+                    y += lineh;
+                    drawn++;
+                });
+            /* Blank lines produce no rows but still take up space */
+            y += (rows - drawn) * lineh;
+        }
+        nvgRestore(ctx);
+    }
+
+    double total = (double) (mRowEnd - firstRow());
+    double visible = height / lineh;
+    if (total <= visible)
+        return;
+
+    float scrollh = (mSize.y() - 8) * (float) (visible / total);
+    float scroll = (float) ((mScrollRow - firstRow()) / (total - visible));
+
+    NVGpaint paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 + 1, mPos.y() + 4 + 1, 8,
+        mSize.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12, mPos.y() + 4, 8,
+                   mSize.y() - 8, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 - 1,
+        mPos.y() + 4 + (mSize.y() - 8 - scrollh) * scroll - 1, 8, scrollh,
+        3, 4, Color(220, 100), Color(128, 100));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12 + 1,
+                   mPos.y() + 4 + 1 + (mSize.y() - 8 - scrollh) * scroll, 8 - 2,
+                   scrollh - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+}
+
+void Console::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("capacity", (uint64_t) mRing.size());
+    s.set("filter", mFilter);
+}
+
+bool Console::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    uint64_t capacity;
+    std::string filter;
+    if (!s.get("capacity", capacity)) return false;
+    if (!s.get("filter", filter)) return false;
+    setCapacity((size_t) capacity);
+    setFilter(filter);
+    return true;
+}
+
+NAMESPACE_END(nanogui)
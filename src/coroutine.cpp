@@ -0,0 +1,184 @@
+/*
+    src/coroutine.cpp -- Cooperative tasks that run on the main loop thread
+    and suspend while waiting for background jobs, timers, or frames
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/coroutine.h>
+#include <nanogui/screen.h>
+#include <coro.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Pool of worker threads used by background() */
+class WorkerPool {
+public:
+    WorkerPool() {
+        unsigned int count = std::max(std::thread::hardware_concurrency(), 2u);
+        for (unsigned int i = 0; i < count; ++i)
+            mThreads.emplace_back([this] { work(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mQuit = true;
+        }
+        mCondition.notify_all();
+        for (auto &thread : mThreads)
+            thread.join();
+    }
+
+    void submit(const std::function<void()> &job) {
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mJobs.push_back(job);
+        }
+        mCondition.notify_one();
+    }
+
+private:
+    void work() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this] { return mQuit || !mJobs.empty(); });
+                if (mJobs.empty())
+                    return;
+                job = std::move(mJobs.front());
+                mJobs.pop_front();
+            }
+            try {
+                job();
+            } catch (const std::exception &e) {
+                std::cerr << "Caught exception in background job: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    std::vector<std::thread> mThreads;
+    std::deque<std::function<void()>> mJobs;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mQuit = false;
+};
+
+void background(const std::function<void()> &job) {
+    static WorkerPool pool;
+    pool.submit(job);
+}
+
+struct Coroutine {
+    std::function<void()> func;
+    coro_context context, caller;
+    coro_stack stack;
+    bool finished = false;
+    bool suspended = false;
+    bool resumed = false; /* resume() was called before the coroutine could suspend */
+    std::exception_ptr error; /* Escaped 'func', re-thrown by resume() */
+};
+
+/* The coroutine that is currently running (on the main loop thread) */
+static Coroutine *current_coroutine = nullptr;
+
+static void coroutine_entry(void *arg) {
+    Coroutine *co = (Coroutine *) arg;
+    try {
+        co->func();
+    } catch (const std::exception &e) {
+        std::cerr << "Caught exception in coroutine: " << e.what() << std::endl;
+    } catch (...) {
+        /* Unwinding must not cross the coroutine's stack boundary */
+        co->error = std::current_exception();
+    }
+    co->finished = true;
+    /* Coroutine entry functions must never return */
+    coro_transfer(&co->context, &co->caller);
+}
+
+/* Switch to 'co' until it suspends or finishes */
+static void resume(Coroutine *co) {
+    if (co == current_coroutine || !co->suspended) {
+        co->resumed = true;
+        return;
+    }
+    Coroutine *prev = current_coroutine;
+    current_coroutine = co;
+    co->suspended = false;
+    {
+        /* Coroutine bodies modify widgets like any other main loop code,
+           whatever the path that resumes them (the lock nests) */
+        ScreenLock lock;
+        coro_transfer(&co->caller, &co->context);
+    }
+    current_coroutine = prev;
+
+    if (co->finished) {
+        /* Safe now that we are back on the caller's stack */
+        std::exception_ptr error = co->error;
+        (void) coro_destroy(&co->context);
+        coro_stack_free(&co->stack);
+        delete co;
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+void spawn(const std::function<void()> &func, size_t stackSize) {
+    Coroutine *co = new Coroutine();
+    co->func = func;
+    if (!coro_stack_alloc(&co->stack, (unsigned int) (stackSize / sizeof(void *)))) {
+        delete co;
+        throw std::runtime_error("spawn(): could not allocate a coroutine stack!");
+    }
+    coro_create(&co->caller, nullptr, nullptr, nullptr, 0);
+    coro_create(&co->context, coroutine_entry, co, co->stack.sptr, co->stack.ssze);
+    co->suspended = true;
+    resume(co);
+}
+
+bool inCoroutine() {
+    return current_coroutine != nullptr;
+}
+
+void awaitCallback(const std::function<void(const std::function<void()> &resume)> &schedule) {
+    Coroutine *co = current_coroutine;
+    if (!co)
+        throw std::runtime_error("await*() must be called within a coroutine (see spawn())!");
+
+    co->resumed = false;
+    schedule([co] { resume(co); });
+    if (co->resumed)
+        return;
+
+    co->suspended = true;
+    coro_transfer(&co->context, &co->caller);
+}
+
+void awaitNextFrame() {
+    awaitDelay(0.0);
+}
+
+void awaitDelay(double seconds) {
+    /* Expired timers run at the beginning of each iteration of the main
+       loop, and timers that are added while doing so wait until the next */
+    awaitCallback([seconds](const std::function<void()> &resume) {
+        addTimer(seconds, resume);
+    });
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,550 @@
+/*
+    src/datagrid.cpp -- Table view of large columnar data sets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/datagrid.h>
+#include <nanogui/coroutine.h>
+#include <nanogui/entypo.h>
+#include <nanogui/opengl.h>
+#include <nanogui/theme.h>
+#include <nanogui/serializer/core.h>
+#include <numeric>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const int ScrollbarWidth = 12;
+static const int CellPadding = 6;
+/* Number of leading rows whose text determines the width of a column */
+static const size_t MeasuredRows = 256;
+/* Smallest number of rows worth handing to another worker thread */
+static const size_t MinChunkSize = 65536;
+
+bool DataColumn::contains(size_t row, const std::string &needle) const {
+    char buffer[NumberBufferSize];
+    size_t length;
+    const char *str = text(row, buffer, length);
+    return std::search(str, str + length, needle.begin(), needle.end()) != str + length;
+}
+
+DataGrid::DataGrid(Widget *parent)
+    : Widget(parent), mMailbox(std::make_shared<Mailbox>()), mUpdatePending(false),
+      mSortColumn(-1), mSortAscending(true), mFilterColumn(-1),
+      mScroll(Vector2f::Zero()), mDragScrollbar(0), mSelectedRow(-1) { }
+
+DataGrid::~DataGrid() {
+    /* Abandon running sort and filter operations */
+    mMailbox->generation++;
+}
+
+void DataGrid::addColumn(const std::string &caption, const std::shared_ptr<const DataColumn> &column) {
+    Column c;
+    c.caption = caption;
+    c.data = column;
+    mColumns.push_back(c);
+    mColumnOffset.clear();
+    refresh();
+}
+
+void DataGrid::setColumn(size_t index, const std::shared_ptr<const DataColumn> &column) {
+    mColumns[index].data = column;
+    mColumns[index].width = 0;
+    mColumnOffset.clear();
+    refresh();
+}
+
+void DataGrid::clearColumns() {
+    mColumns.clear();
+    mColumnOffset.clear();
+    mSortColumn = -1;
+    mFilterColumn = -1;
+    mSelectedRow = -1;
+    refresh();
+}
+
+void DataGrid::setColumnWidth(size_t index, int width) {
+    mColumns[index].fixedWidth = std::max(width, 0);
+    mColumns[index].width = 0;
+    mColumnOffset.clear();
+}
+
+size_t DataGrid::rowCount() const {
+    if (mColumns.empty())
+        return 0;
+    size_t count = (size_t) -1;
+    for (const Column &c : mColumns)
+        count = std::min(count, c.data ? c.data->size() : (size_t) 0);
+    return count;
+}
+
+void DataGrid::setSortColumn(int column, bool ascending) {
+    if (column < 0 || column >= (int) mColumns.size())
+        column = -1;
+    if (column == mSortColumn && ascending == mSortAscending)
+        return;
+    mSortColumn = column;
+    mSortAscending = ascending;
+    refresh();
+}
+
+void DataGrid::setFilter(const std::string &filter, int column) {
+    if (column < 0 || column >= (int) mColumns.size())
+        column = -1;
+    if (filter == mFilter && column == mFilterColumn)
+        return;
+    mFilter = filter;
+    mFilterColumn = column;
+    refresh();
+}
+
+void DataGrid::refresh() {
+    /* Supersede running operations */
+    uint64_t generation = ++mMailbox->generation;
+    std::atomic_store(&mMailbox->result, std::shared_ptr<Order>());
+
+    size_t rows = rowCount();
+    bool sorted = mSortColumn >= 0 && mColumns[mSortColumn].data;
+    if (!sorted && mFilter.empty()) {
+        mOrder.reset();
+        mUpdatePending = false;
+        return;
+    }
+
+    /* Split the rows into chunks that are filtered and sorted in parallel;
+       the last chunk to finish merges them */
+    struct Task {
+        uint64_t generation;
+        std::shared_ptr<Mailbox> mailbox;
+        size_t rowCount;
+        std::vector<std::shared_ptr<const DataColumn>> filterColumns;
+        std::string filter;
+        std::shared_ptr<const DataColumn> sortColumn;
+        bool ascending;
+        std::vector<std::vector<uint32_t>> chunks;
+        std::atomic<size_t> remaining;
+
+        bool cancelled() const { return mailbox->generation != generation; }
+
+        void run(size_t index) {
+            size_t begin = rowCount * index / chunks.size(),
+                   end = rowCount * (index + 1) / chunks.size();
+            std::vector<uint32_t> &rows = chunks[index];
+
+            if (filter.empty()) {
+                rows.resize(end - begin);
+                std::iota(rows.begin(), rows.end(), (uint32_t) begin);
+            } else {
+                for (size_t row = begin; row < end; ++row) {
+                    if ((row & 4095) == 0 && cancelled())
+                        break;
+                    for (const auto &column : filterColumns) {
+                        if (column->contains(row, filter)) {
+                            rows.push_back((uint32_t) row);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (sortColumn && !cancelled())
+                sortColumn->sort(rows.data(), rows.data() + rows.size(), ascending);
+
+            if (--remaining == 0)
+                finish();
+        }
+
+        void finish() {
+            if (cancelled())
+                return;
+
+            auto order = std::make_shared<Order>();
+            order->generation = generation;
+            std::vector<size_t> bounds { 0 };
+            size_t total = 0;
+            for (const auto &chunk : chunks)
+                bounds.push_back(total += chunk.size());
+            order->rows.reserve(total);
+            for (auto &chunk : chunks) {
+                order->rows.insert(order->rows.end(), chunk.begin(), chunk.end());
+                std::vector<uint32_t>().swap(chunk);
+            }
+
+            /* Merge pairs of sorted runs until a single one remains */
+            uint32_t *data = order->rows.data();
+            while (sortColumn && bounds.size() > 2) {
+                if (cancelled())
+                    return;
+                std::vector<size_t> merged { 0 };
+                for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                    if (i + 2 < bounds.size()) {
+                        sortColumn->merge(data + bounds[i], data + bounds[i + 1],
+                                          data + bounds[i + 2], ascending);
+                        merged.push_back(bounds[i + 2]);
+                    } else {
+                        merged.push_back(bounds[i + 1]);
+                    }
+                }
+                bounds.swap(merged);
+            }
+
+            if (!cancelled()) {
+                std::atomic_store(&mailbox->result, order);
+                scheduleRedraw();
+            }
+        }
+    };
+
+    auto task = std::make_shared<Task>();
+    task->generation = generation;
+    task->mailbox = mMailbox;
+    task->rowCount = rows;
+    task->filter = mFilter;
+    if (!mFilter.empty()) {
+        for (size_t i = 0; i < mColumns.size(); ++i)
+            if (mColumns[i].data && (mFilterColumn < 0 || mFilterColumn == (int) i))
+                task->filterColumns.push_back(mColumns[i].data);
+    }
+    if (sorted)
+        task->sortColumn = mColumns[mSortColumn].data;
+    task->ascending = mSortAscending;
+
+    size_t chunkCount = std::min((size_t) std::max(std::thread::hardware_concurrency(), 1u),
+                                 rows / MinChunkSize + 1);
+    task->chunks.resize(chunkCount);
+    task->remaining = chunkCount;
+    mUpdatePending = true;
+
+    for (size_t i = 0; i < chunkCount; ++i)
+        background([task, i] { task->run(i); });
+}
+
+void DataGrid::applyUpdate() {
+    if (!mUpdatePending)
+        return;
+    std::shared_ptr<Order> result =
+        std::atomic_exchange(&mMailbox->result, std::shared_ptr<Order>());
+    if (!result || result->generation != mMailbox->generation)
+        return;
+    mOrder = std::move(result);
+    mUpdatePending = false;
+    clampScroll();
+}
+
+void DataGrid::setTheme(Theme *theme) {
+    Widget::setTheme(theme);
+    for (Column &c : mColumns)
+        c.width = 0;
+    mColumnOffset.clear();
+}
+
+void DataGrid::measureColumns(NVGcontext *ctx) {
+    if (!mColumnOffset.empty() && mColumnOffset.size() == mColumns.size() + 1)
+        return;
+
+    nvgFontSize(ctx, fontSize());
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    char buffer[NumberBufferSize];
+
+    mColumnOffset.resize(mColumns.size() + 1);
+    int offset = 0;
+    for (size_t i = 0; i < mColumns.size(); ++i) {
+        Column &c = mColumns[i];
+        if (c.fixedWidth > 0) {
+            c.width = c.fixedWidth;
+        } else if (c.width == 0) {
+            /* Leave room for the sort indicator next to the caption */
+            nvgFontFace(ctx, "sans-bold");
+            float width = nvgTextBounds(ctx, 0, 0, c.caption.c_str(), nullptr, nullptr) + fontSize();
+
+            nvgFontFace(ctx, "sans");
+            size_t rows = c.data ? std::min(c.data->size(), MeasuredRows) : 0;
+            for (size_t row = 0; row < rows; ++row) {
+                size_t length;
+                const char *str = c.data->text(row, buffer, length);
+                width = std::max(width, nvgTextBounds(ctx, 0, 0, str, str + length, nullptr));
+            }
+            c.width = std::min((int) std::ceil(width), fontSize() * 30) + 2 * CellPadding;
+        }
+        mColumnOffset[i] = offset;
+        offset += c.width;
+    }
+    mColumnOffset.back() = offset;
+}
+
+Vector2i DataGrid::bodySize() const {
+    int width = mSize.x() - ScrollbarWidth;
+    int height = mSize.y() - rowHeight() - (contentWidth() > width ? ScrollbarWidth : 0);
+    return Vector2i(width, std::max(height, 0));
+}
+
+void DataGrid::clampScroll() {
+    Vector2i body = bodySize();
+    float maxX = (float) std::max(contentWidth() - body.x(), 0);
+    float maxY = std::max((float) visibleRowCount() * rowHeight() - body.y(), 0.f);
+    mScroll = Vector2f(std::max(0.f, std::min(mScroll.x(), maxX)),
+                       std::max(0.f, std::min(mScroll.y(), maxY)));
+}
+
+bool DataGrid::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    if (button != GLFW_MOUSE_BUTTON_1)
+        return Widget::mouseButtonEvent(p, button, down, modifiers);
+    if (!down) {
+        mDragScrollbar = 0;
+        return true;
+    }
+
+    Vector2i body = bodySize();
+    Vector2i rel = p - mPos;
+    int rh = rowHeight();
+
+    if (rel.x() >= body.x()) {
+        mDragScrollbar = 1;
+    } else if (rel.y() >= rh + body.y()) {
+        mDragScrollbar = 2;
+    } else if (!mColumnOffset.empty()) {
+        int x = rel.x() + (int) mScroll.x();
+        auto it = std::upper_bound(mColumnOffset.begin(), mColumnOffset.end(), x);
+        int column = (int) (it - mColumnOffset.begin()) - 1;
+        if (column < 0 || column >= (int) mColumns.size())
+            return true;
+
+        if (rel.y() < rh) {
+            /* Clicking a caption sorts by that column, again reverses the order */
+            setSortColumn(column, column == mSortColumn ? !mSortAscending : true);
+        } else {
+            size_t index = (size_t) ((rel.y() - rh + mScroll.y()) / rh);
+            if (index < visibleRowCount()) {
+                mSelectedRow = (int) visibleRow(index);
+                if (mCallback)
+                    mCallback(mSelectedRow);
+            }
+        }
+    }
+    return true;
+}
+
+bool DataGrid::mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) {
+    if (mDragScrollbar == 0)
+        return Widget::mouseDragEvent(p, rel, button, modifiers);
+
+    /* Move the content in proportion to the scrollbar track */
+    Vector2i body = bodySize();
+    if (mDragScrollbar == 1) {
+        float total = (float) visibleRowCount() * rowHeight();
+        float track = mSize.y() - 8;
+        if (total > 0)
+            mScroll.y() += rel.y() * total / track;
+    } else {
+        float track = body.x() - 8;
+        mScroll.x() += rel.x() * contentWidth() / track;
+    }
+    clampScroll();
+    return true;
+}
+
+bool DataGrid::scrollEvent(const Vector2i &/* p */, const Vector2f &rel) {
+    mScroll -= rel.cwiseProduct(Vector2f(fontSize() * 2.f, rowHeight() * 3.f));
+    clampScroll();
+    return true;
+}
+
+Vector2i DataGrid::preferredSize(NVGcontext *) const {
+    return Vector2i(fontSize() * 30, rowHeight() * 12);
+}
+
+void DataGrid::draw(NVGcontext* ctx) {
+    Widget::draw(ctx);
+    applyUpdate();
+    measureColumns(ctx);
+    clampScroll();
+
+    int rh = rowHeight();
+    Vector2i body = bodySize();
+    float x0 = mPos.x() - mScroll.x(), y0 = mPos.y() + rh - mScroll.y();
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    nvgFillColor(ctx, Color(0, 32));
+    nvgFill(ctx);
+
+    /* Rows in view */
+    size_t count = visibleRowCount(), dataRows = rowCount();
+    size_t first = (size_t) (mScroll.y() / rh);
+    size_t last = std::min(count, (size_t) ((mScroll.y() + body.y()) / rh) + 1);
+
+    /* Columns in view */
+    size_t firstColumn = 0, lastColumn = mColumns.size();
+    if (!mColumns.empty()) {
+        auto it = std::upper_bound(mColumnOffset.begin(), mColumnOffset.end(), (int) mScroll.x());
+        firstColumn = (size_t) std::max((int) (it - mColumnOffset.begin()) - 1, 0);
+        it = std::lower_bound(mColumnOffset.begin(), mColumnOffset.end(), (int) mScroll.x() + body.x());
+        lastColumn = std::min((size_t) (it - mColumnOffset.begin()), mColumns.size());
+    }
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y() + rh, body.x(), body.y());
+
+    for (size_t i = first; i < last; ++i) {
+        size_t row = visibleRow(i);
+        bool selected = (int) row == mSelectedRow;
+        if (!selected && i % 2 == 0)
+            continue;
+        nvgBeginPath(ctx);
+        nvgRect(ctx, mPos.x(), y0 + i * rh, body.x(), rh);
+        nvgFillColor(ctx, selected ? mTheme->mButtonGradientTopPushed : Color(255, 8));
+        nvgFill(ctx);
+    }
+
+    nvgFontSize(ctx, fontSize());
+    nvgFontFace(ctx, "sans");
+    nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+    char buffer[NumberBufferSize];
+
+    for (size_t col = firstColumn; col < lastColumn; ++col) {
+        const Column &c = mColumns[col];
+        if (!c.data)
+            continue;
+        float cx = x0 + mColumnOffset[col];
+        bool right = c.data->numeric();
+
+        nvgSave(ctx);
+        nvgIntersectScissor(ctx, cx + CellPadding / 2, mPos.y() + rh, c.width - CellPadding, body.y());
+        nvgTextAlign(ctx, (right ? NVG_ALIGN_RIGHT : NVG_ALIGN_LEFT) | NVG_ALIGN_MIDDLE);
+        float tx = right ? cx + c.width - CellPadding : cx + CellPadding;
+
+        for (size_t i = first; i < last; ++i) {
+            size_t row = visibleRow(i);
+            /* The order may still refer to columns that were replaced */
+            if (row >= dataRows)
+                continue;
+            size_t length;
+            const char *str = c.data->text(row, buffer, length);
+            if (length > 0)
+                nvgText(ctx, tx, y0 + (i + 0.5f) * rh, str, str + length);
+        }
+        nvgRestore(ctx);
+    }
+    nvgRestore(ctx);
+
+    /* Caption bar */
+    NVGpaint paint = nvgLinearGradient(ctx, mPos.x(), mPos.y(), mPos.x(), mPos.y() + rh,
+                                       mTheme->mButtonGradientTopUnfocused,
+                                       mTheme->mButtonGradientBotUnfocused);
+    nvgBeginPath(ctx);
+    nvgRect(ctx, mPos.x(), mPos.y(), mSize.x(), rh);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    nvgBeginPath(ctx);
+    for (size_t col = firstColumn; col < lastColumn; ++col) {
+        float x = std::round(x0 + mColumnOffset[col + 1]) - 0.5f;
+        nvgMoveTo(ctx, x, mPos.y());
+        nvgLineTo(ctx, x, mPos.y() + rh);
+    }
+    nvgMoveTo(ctx, mPos.x(), mPos.y() + rh - 0.5f);
+    nvgLineTo(ctx, mPos.x() + mSize.x(), mPos.y() + rh - 0.5f);
+    nvgStrokeColor(ctx, mTheme->mBorderDark);
+    nvgStroke(ctx);
+
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    for (size_t col = firstColumn; col < lastColumn; ++col) {
+        const Column &c = mColumns[col];
+        float cx = x0 + mColumnOffset[col];
+        nvgSave(ctx);
+        nvgIntersectScissor(ctx, cx, mPos.y(), c.width, rh);
+        nvgFontFace(ctx, "sans-bold");
+        nvgFillColor(ctx, mTheme->mTextColor);
+        nvgText(ctx, cx + CellPadding, mPos.y() + rh * 0.5f, c.caption.c_str(), nullptr);
+        if ((int) col == mSortColumn) {
+            nvgFontFace(ctx, "icons");
+            nvgFillColor(ctx, mTheme->mIconColor);
+            nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+            auto icon = utf8(mSortAscending ? ENTYPO_ICON_TRIANGLE_UP : ENTYPO_ICON_TRIANGLE_DOWN);
+            nvgText(ctx, cx + c.width - CellPadding / 2, mPos.y() + rh * 0.5f, icon.data(), nullptr);
+            nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+        }
+        nvgRestore(ctx);
+    }
+
+    /* Scroll bars */
+    float total = (float) count * rh;
+    if (total > body.y()) {
+        float scrollh = std::max((mSize.y() - 8) * body.y() / total, 8.f);
+        float scroll = mScroll.y() / (total - body.y());
+        float x = mPos.x() + mSize.x() - ScrollbarWidth;
+
+        paint = nvgBoxGradient(ctx, x + 1, mPos.y() + 4 + 1, 8, mSize.y() - 8,
+                               3, 4, Color(0, 32), Color(0, 92));
+        nvgBeginPath(ctx);
+        nvgRoundedRect(ctx, x, mPos.y() + 4, 8, mSize.y() - 8, 3);
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+
+        float y = mPos.y() + 4 + (mSize.y() - 8 - scrollh) * scroll;
+        paint = nvgBoxGradient(ctx, x - 1, y - 1, 8, scrollh, 3, 4,
+                               Color(220, 100), Color(128, 100));
+        nvgBeginPath(ctx);
+        nvgRoundedRect(ctx, x + 1, y + 1, 8 - 2, scrollh - 2, 2);
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+    }
+
+    if (contentWidth() > body.x()) {
+        float scrollw = std::max((body.x() - 8) * (float) body.x() / contentWidth(), 8.f);
+        float scroll = mScroll.x() / (contentWidth() - body.x());
+        float y = mPos.y() + mSize.y() - ScrollbarWidth;
+
+        paint = nvgBoxGradient(ctx, mPos.x() + 4 + 1, y + 1, body.x() - 8, 8,
+                               3, 4, Color(0, 32), Color(0, 92));
+        nvgBeginPath(ctx);
+        nvgRoundedRect(ctx, mPos.x() + 4, y, body.x() - 8, 8, 3);
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+
+        float x = mPos.x() + 4 + (body.x() - 8 - scrollw) * scroll;
+        paint = nvgBoxGradient(ctx, x - 1, y - 1, scrollw, 8, 3, 4,
+                               Color(220, 100), Color(128, 100));
+        nvgBeginPath(ctx);
+        nvgRoundedRect(ctx, x + 1, y + 1, scrollw - 2, 8 - 2, 2);
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+    }
+
+    nvgRestore(ctx);
+}
+
+void DataGrid::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("sortColumn", mSortColumn);
+    s.set("sortAscending", mSortAscending);
+    s.set("filter", mFilter);
+    s.set("filterColumn", mFilterColumn);
+    s.set("selectedRow", mSelectedRow);
+}
+
+bool DataGrid::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    int sortColumn, filterColumn;
+    bool sortAscending;
+    std::string filter;
+    if (!s.get("sortColumn", sortColumn)) return false;
+    if (!s.get("sortAscending", sortAscending)) return false;
+    if (!s.get("filter", filter)) return false;
+    if (!s.get("filterColumn", filterColumn)) return false;
+    if (!s.get("selectedRow", mSelectedRow)) return false;
+    setSortColumn(sortColumn, sortAscending);
+    setFilter(filter, filterColumn);
+    return true;
+}
+
+NAMESPACE_END(nanogui)
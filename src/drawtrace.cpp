@@ -0,0 +1,448 @@
+/*
+    src/drawtrace.cpp -- Recording and replay of the command stream that
+    NanoVG sends to its rendering backend
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/drawtrace.h>
+#include <nanogui/serializer/core.h>
+#include <nanovg.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Layout of the recorded commands. Every command stores CallInts integers;
+   draw calls additionally store CallFloats floats:
+
+   ints:   type, texture index (or -1), composite operation (4 values) or
+           the updated region (x, y, w, h), path/vertex count, unused
+   floats: paint transform (6), extent (2), radius, feather, inner color (4),
+           outer color (4), scissor transform (6), scissor extent (2),
+           fringe, stroke width, bounds (4) */
+enum CommandType { CmdFill = 0, CmdStroke, CmdTriangles, CmdUpdateTexture };
+static const size_t CallInts = 8, CallFloats = 32, TextureInts = 6, PathInts = 6;
+static const uint32_t TraceVersion = 1;
+
+static_assert(sizeof(NVGvertex) == 4 * sizeof(float), "Unexpected NVGvertex layout");
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static int bytesPerPixel(int type) {
+    return type == NVG_TEXTURE_RGBA ? 4 : 1;
+}
+
+struct DrawTrace::Capture {
+    DrawTrace *trace;
+    NVGparams *params;        /* Patched callbacks of the captured context */
+    NVGparams original;       /* Callbacks of the actual backend */
+    std::unordered_map<int, int> textures; /* Backend ID -> texture index */
+    Clock::time_point start;
+    double submit = 0, flush = 0;
+
+    int recordTexture(int image, int guessedType, int type = 0, int w = 0, int h = 0,
+                      int flags = 0, const unsigned char *data = nullptr) {
+        if (image == 0)
+            return -1;
+        auto it = textures.find(image);
+        if (it != textures.end())
+            return it->second;
+
+        if (type == 0) {
+            /* The texture existed before the capture started: only its size
+               can be queried from the backend. Its type is guessed from how
+               it is used (text is drawn as triangles from an alpha texture) */
+            type = guessedType;
+            if (!original.renderGetTextureSize(original.userPtr, image, &w, &h))
+                w = h = 1;
+        }
+
+        int index = (int) (trace->mTextures.size() / TextureInts);
+        int32_t entry[TextureInts] = { image, type, w, h, flags, data ? 1 : 0 };
+        trace->mTextures.insert(trace->mTextures.end(), entry, entry + TextureInts);
+        if (data)
+            trace->mTextureData.insert(trace->mTextureData.end(), data,
+                                       data + (size_t) w * h * bytesPerPixel(type));
+        textures[image] = index;
+        return index;
+    }
+
+    void recordCall(int type, const NVGpaint *paint, const NVGcompositeOperationState &op,
+                    const NVGscissor *scissor, float fringe, float strokeWidth,
+                    const float *bounds, int count) {
+        int texture = recordTexture(paint->image, type == CmdTriangles
+                                    ? NVG_TEXTURE_ALPHA : NVG_TEXTURE_RGBA);
+        int32_t ints[CallInts] = { type, texture, op.srcRGB, op.dstRGB,
+                                   op.srcAlpha, op.dstAlpha, count, 0 };
+        trace->mCallInts.insert(trace->mCallInts.end(), ints, ints + CallInts);
+
+        float floats[CallFloats];
+        float *f = floats;
+        f = std::copy(paint->xform, paint->xform + 6, f);
+        f = std::copy(paint->extent, paint->extent + 2, f);
+        *f++ = paint->radius;
+        *f++ = paint->feather;
+        f = std::copy(paint->innerColor.rgba, paint->innerColor.rgba + 4, f);
+        f = std::copy(paint->outerColor.rgba, paint->outerColor.rgba + 4, f);
+        f = std::copy(scissor->xform, scissor->xform + 6, f);
+        f = std::copy(scissor->extent, scissor->extent + 2, f);
+        *f++ = fringe;
+        *f++ = strokeWidth;
+        for (int i = 0; i < 4; ++i)
+            *f++ = bounds ? bounds[i] : 0.f;
+        trace->mCallFloats.insert(trace->mCallFloats.end(), floats, floats + CallFloats);
+    }
+
+    void recordVertices(const NVGvertex *verts, int count) {
+        const float *data = (const float *) verts;
+        trace->mVertices.insert(trace->mVertices.end(), data, data + 4 * count);
+    }
+
+    void recordPaths(const NVGpath *paths, int npaths, bool fill) {
+        for (int i = 0; i < npaths; ++i) {
+            const NVGpath &path = paths[i];
+            int nfill = fill ? path.nfill : 0;
+            int32_t entry[PathInts] = { path.closed, path.nbevel, nfill,
+                                        path.nstroke, path.winding, path.convex };
+            trace->mPaths.insert(trace->mPaths.end(), entry, entry + PathInts);
+            recordVertices(path.fill, nfill);
+            recordVertices(path.stroke, path.nstroke);
+        }
+    }
+
+    void recordUpdate(int image, int x, int y, int w, int h, const unsigned char *data) {
+        int texture = recordTexture(image, NVG_TEXTURE_ALPHA);
+        const int32_t *entry = &trace->mTextures[texture * TextureInts];
+        int bpp = bytesPerPixel(entry[1]), width = entry[2];
+
+        int32_t ints[CallInts] = { CmdUpdateTexture, texture, x, y, w, h, 0, 0 };
+        trace->mCallInts.insert(trace->mCallInts.end(), ints, ints + CallInts);
+
+        /* 'data' points to the whole image; only keep the updated region */
+        for (int row = y; row < y + h; ++row) {
+            const unsigned char *src = data + ((size_t) row * width + x) * bpp;
+            trace->mUpdateData.insert(trace->mUpdateData.end(), src, src + (size_t) w * bpp);
+        }
+    }
+};
+
+DrawTrace::DrawTrace()
+    : mSize(Vector2i::Zero()), mPixelRatio(1.f), mTessellationTime(0),
+      mSubmitTime(0), mFlushTime(0), mReplayContext(nullptr) { }
+
+DrawTrace::~DrawTrace() {
+    if (mCapture)
+        endCapture();
+    release();
+}
+
+void DrawTrace::beginCapture(NVGcontext *ctx, const Vector2i &size, float pixelRatio) {
+    if (mCapture)
+        throw std::runtime_error("DrawTrace::beginCapture(): a capture is already in progress!");
+    release();
+
+    mSize = size;
+    mPixelRatio = pixelRatio;
+    mTextures.clear();
+    mTextureData.clear();
+    mCallInts.clear();
+    mCallFloats.clear();
+    mPaths.clear();
+    mVertices.clear();
+    mUpdateData.clear();
+
+    mCapture.reset(new Capture());
+    mCapture->trace = this;
+    mCapture->params = nvgInternalParams(ctx);
+    mCapture->original = *mCapture->params;
+
+    NVGparams &params = *mCapture->params;
+    params.userPtr = mCapture.get();
+
+    params.renderCreateTexture = [](void *uptr, int type, int w, int h, int imageFlags,
+                                    const unsigned char *data) {
+        Capture *c = (Capture *) uptr;
+        int image = c->original.renderCreateTexture(c->original.userPtr, type, w, h,
+                                                    imageFlags, data);
+        if (image)
+            c->recordTexture(image, type, type, w, h, imageFlags, data);
+        return image;
+    };
+
+    params.renderDeleteTexture = [](void *uptr, int image) {
+        Capture *c = (Capture *) uptr;
+        c->textures.erase(image); /* The backend may reuse the ID */
+        return c->original.renderDeleteTexture(c->original.userPtr, image);
+    };
+
+    params.renderUpdateTexture = [](void *uptr, int image, int x, int y, int w, int h,
+                                    const unsigned char *data) {
+        Capture *c = (Capture *) uptr;
+        c->recordUpdate(image, x, y, w, h, data);
+        return c->original.renderUpdateTexture(c->original.userPtr, image, x, y, w, h, data);
+    };
+
+    params.renderGetTextureSize = [](void *uptr, int image, int *w, int *h) {
+        Capture *c = (Capture *) uptr;
+        return c->original.renderGetTextureSize(c->original.userPtr, image, w, h);
+    };
+
+    params.renderViewport = [](void *uptr, float width, float height, float devicePixelRatio) {
+        Capture *c = (Capture *) uptr;
+        c->original.renderViewport(c->original.userPtr, width, height, devicePixelRatio);
+    };
+
+    params.renderCancel = [](void *uptr) {
+        Capture *c = (Capture *) uptr;
+        c->original.renderCancel(c->original.userPtr);
+    };
+
+    params.renderFlush = [](void *uptr) {
+        Capture *c = (Capture *) uptr;
+        Clock::time_point start = Clock::now();
+        c->original.renderFlush(c->original.userPtr);
+        c->flush += elapsed(start);
+    };
+
+    params.renderFill = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                           NVGscissor *scissor, float fringe, const float *bounds,
+                           const NVGpath *paths, int npaths) {
+        Capture *c = (Capture *) uptr;
+        c->recordCall(CmdFill, paint, op, scissor, fringe, 0.f, bounds, npaths);
+        c->recordPaths(paths, npaths, true);
+        Clock::time_point start = Clock::now();
+        c->original.renderFill(c->original.userPtr, paint, op, scissor, fringe,
+                               bounds, paths, npaths);
+        c->submit += elapsed(start);
+    };
+
+    params.renderStroke = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                             NVGscissor *scissor, float fringe, float strokeWidth,
+                             const NVGpath *paths, int npaths) {
+        Capture *c = (Capture *) uptr;
+        c->recordCall(CmdStroke, paint, op, scissor, fringe, strokeWidth, nullptr, npaths);
+        c->recordPaths(paths, npaths, false);
+        Clock::time_point start = Clock::now();
+        c->original.renderStroke(c->original.userPtr, paint, op, scissor, fringe,
+                                 strokeWidth, paths, npaths);
+        c->submit += elapsed(start);
+    };
+
+    params.renderTriangles = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                                NVGscissor *scissor, const NVGvertex *verts, int nverts,
+                                float fringe) {
+        Capture *c = (Capture *) uptr;
+        c->recordCall(CmdTriangles, paint, op, scissor, fringe, 0.f, nullptr, nverts);
+        c->recordVertices(verts, nverts);
+        Clock::time_point start = Clock::now();
+        c->original.renderTriangles(c->original.userPtr, paint, op, scissor, verts,
+                                    nverts, fringe);
+        c->submit += elapsed(start);
+    };
+
+    mCapture->start = Clock::now();
+}
+
+void DrawTrace::endCapture() {
+    if (!mCapture)
+        throw std::runtime_error("DrawTrace::endCapture(): no capture in progress!");
+    double total = elapsed(mCapture->start);
+    *mCapture->params = mCapture->original;
+
+    mSubmitTime = mCapture->submit;
+    mFlushTime = mCapture->flush;
+    mTessellationTime = std::max(total - mSubmitTime - mFlushTime, 0.0);
+    mCapture.reset();
+}
+
+size_t DrawTrace::callCount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < mCallInts.size(); i += CallInts)
+        if (mCallInts[i] != CmdUpdateTexture)
+            ++count;
+    return count;
+}
+
+void DrawTrace::save(const std::string &filename) const {
+    Serializer s(filename, true);
+    s.push("drawtrace");
+    s.set("version", TraceVersion);
+    s.set("size", mSize);
+    s.set("pixelRatio", mPixelRatio);
+    s.set("tessellationTime", mTessellationTime);
+    s.set("submitTime", mSubmitTime);
+    s.set("flushTime", mFlushTime);
+    s.set("textures", mTextures);
+    s.set("textureData", mTextureData);
+    s.set("callInts", mCallInts);
+    s.set("callFloats", mCallFloats);
+    s.set("paths", mPaths);
+    s.set("vertices", mVertices);
+    s.set("updateData", mUpdateData);
+    s.pop();
+}
+
+void DrawTrace::load(const std::string &filename) {
+    if (mCapture)
+        throw std::runtime_error("DrawTrace::load(): a capture is in progress!");
+    if (!Serializer::isSerializedFile(filename))
+        throw std::runtime_error("DrawTrace::load(): \"" + filename + "\" is not a trace file!");
+    release();
+
+    Serializer s(filename, false);
+    uint32_t version = 0;
+    s.push("drawtrace");
+    if (!s.get("version", version) || version != TraceVersion)
+        throw std::runtime_error("DrawTrace::load(): unsupported trace version!");
+    s.get("size", mSize);
+    s.get("pixelRatio", mPixelRatio);
+    s.get("tessellationTime", mTessellationTime);
+    s.get("submitTime", mSubmitTime);
+    s.get("flushTime", mFlushTime);
+    s.get("textures", mTextures);
+    s.get("textureData", mTextureData);
+    s.get("callInts", mCallInts);
+    s.get("callFloats", mCallFloats);
+    s.get("paths", mPaths);
+    s.get("vertices", mVertices);
+    s.get("updateData", mUpdateData);
+    s.pop();
+}
+
+DrawTrace::Timing DrawTrace::replay(NVGcontext *ctx) {
+    if (mCapture)
+        throw std::runtime_error("DrawTrace::replay(): a capture is in progress!");
+    if (ctx != mReplayContext)
+        release();
+    NVGparams *params = nvgInternalParams(ctx);
+    void *uptr = params->userPtr;
+
+    /* Create the textures (once per context) */
+    size_t textureCount = mTextures.size() / TextureInts;
+    if (mReplayTextures.size() != textureCount) {
+        const uint8_t *data = mTextureData.data();
+        for (size_t i = 0; i < textureCount; ++i) {
+            const int32_t *entry = &mTextures[i * TextureInts];
+            int image = params->renderCreateTexture(uptr, entry[1], entry[2], entry[3],
+                                                    entry[4], entry[5] ? data : nullptr);
+            if (entry[5])
+                data += (size_t) entry[2] * entry[3] * bytesPerPixel(entry[1]);
+            mReplayTextures.push_back(image);
+        }
+        mReplayContext = ctx;
+    }
+
+    Timing timing;
+    std::vector<NVGpath> paths;
+    std::vector<uint8_t> scratch;
+    const int32_t *pathData = mPaths.data();
+    const float *callFloats = mCallFloats.data();
+    const NVGvertex *vertices = (const NVGvertex *) mVertices.data();
+    const uint8_t *updateData = mUpdateData.data();
+
+    params->renderViewport(uptr, (float) mSize.x(), (float) mSize.y(), mPixelRatio);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < mCallInts.size(); i += CallInts) {
+        const int32_t *ints = &mCallInts[i];
+        int type = ints[0], texture = ints[1], count = ints[6];
+
+        if (type == CmdUpdateTexture) {
+            const int32_t *entry = &mTextures[texture * TextureInts];
+            int bpp = bytesPerPixel(entry[1]), width = entry[2];
+            int x = ints[2], y = ints[3], w = ints[4], h = ints[5];
+            scratch.resize((size_t) width * entry[3] * bpp);
+            for (int row = y; row < y + h; ++row) {
+                memcpy(&scratch[((size_t) row * width + x) * bpp], updateData, (size_t) w * bpp);
+                updateData += (size_t) w * bpp;
+            }
+            params->renderUpdateTexture(uptr, mReplayTextures[texture], x, y, w, h,
+                                        scratch.data());
+            continue;
+        }
+
+        NVGpaint paint;
+        NVGscissor scissor;
+        const float *f = callFloats;
+        callFloats += CallFloats;
+        memcpy(paint.xform, f, sizeof(float) * 6);
+        memcpy(paint.extent, f + 6, sizeof(float) * 2);
+        paint.radius = f[8];
+        paint.feather = f[9];
+        memcpy(paint.innerColor.rgba, f + 10, sizeof(float) * 4);
+        memcpy(paint.outerColor.rgba, f + 14, sizeof(float) * 4);
+        paint.image = texture >= 0 ? mReplayTextures[texture] : 0;
+        memcpy(scissor.xform, f + 18, sizeof(float) * 6);
+        memcpy(scissor.extent, f + 24, sizeof(float) * 2);
+        float fringe = f[26], strokeWidth = f[27];
+        const float *bounds = f + 28;
+
+        NVGcompositeOperationState op;
+        op.srcRGB = ints[2];
+        op.dstRGB = ints[3];
+        op.srcAlpha = ints[4];
+        op.dstAlpha = ints[5];
+
+        if (type == CmdTriangles) {
+            params->renderTriangles(uptr, &paint, op, &scissor, vertices, count, fringe);
+            vertices += count;
+            continue;
+        }
+
+        paths.resize(count);
+        for (int j = 0; j < count; ++j) {
+            NVGpath &path = paths[j];
+            memset(&path, 0, sizeof(NVGpath));
+            path.closed = (unsigned char) pathData[0];
+            path.nbevel = pathData[1];
+            path.nfill = pathData[2];
+            path.nstroke = pathData[3];
+            path.winding = pathData[4];
+            path.convex = pathData[5];
+            pathData += PathInts;
+            path.fill = path.nfill > 0 ? (NVGvertex *) vertices : nullptr;
+            vertices += path.nfill;
+            path.stroke = path.nstroke > 0 ? (NVGvertex *) vertices : nullptr;
+            vertices += path.nstroke;
+        }
+
+        if (type == CmdFill)
+            params->renderFill(uptr, &paint, op, &scissor, fringe, bounds,
+                               paths.data(), count);
+        else
+            params->renderStroke(uptr, &paint, op, &scissor, fringe, strokeWidth,
+                                 paths.data(), count);
+    }
+    timing.submit = elapsed(start);
+
+    start = Clock::now();
+    params->renderFlush(uptr);
+    timing.flush = elapsed(start);
+
+    return timing;
+}
+
+void DrawTrace::release() {
+    if (mReplayContext) {
+        NVGparams *params = nvgInternalParams(mReplayContext);
+        for (int image : mReplayTextures)
+            if (image)
+                params->renderDeleteTexture(params->userPtr, image);
+    }
+    mReplayTextures.clear();
+    mReplayContext = nullptr;
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,200 @@
+/*
+    src/eventrecorder.cpp -- Recording and deterministic replay of the
+    input events received by a Screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/eventrecorder.h>
+#include <nanogui/screen.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const uint32_t RecordingVersion = 1;
+
+EventRecorder::EventRecorder() : mScreen(nullptr), mStartTime(0) { }
+
+EventRecorder::~EventRecorder() {
+    stop();
+}
+
+void EventRecorder::start(Screen *screen) {
+    stop();
+    mEvents.clear();
+    mScreen = screen;
+    mStartTime = glfwGetTime();
+    screen->setEventRecorder(this);
+}
+
+void EventRecorder::stop() {
+    if (!mScreen)
+        return;
+    if (mScreen->eventRecorder() == this)
+        mScreen->setEventRecorder(nullptr);
+    mScreen = nullptr;
+}
+
+void EventRecorder::record(EventType type, double x, double y, int arg0,
+                           int arg1, int arg2, int arg3) {
+    Event event;
+    event.type = type;
+    event.time = glfwGetTime() - mStartTime;
+    event.x = x; event.y = y;
+    event.arg[0] = arg0; event.arg[1] = arg1;
+    event.arg[2] = arg2; event.arg[3] = arg3;
+    mEvents.push_back(event);
+}
+
+void EventRecorder::save(const std::string &filename) const {
+    std::vector<double> times, coords;
+    std::vector<int32_t> args;
+    times.reserve(mEvents.size());
+    coords.reserve(mEvents.size() * 2);
+    args.reserve(mEvents.size() * 5);
+    for (const Event &e : mEvents) {
+        times.push_back(e.time);
+        coords.push_back(e.x);
+        coords.push_back(e.y);
+        args.push_back((int32_t) e.type);
+        args.insert(args.end(), e.arg, e.arg + 4);
+    }
+
+    Serializer s(filename, true);
+    s.push("events");
+    s.set("version", RecordingVersion);
+    s.set("times", times);
+    s.set("coords", coords);
+    s.set("args", args);
+    s.pop();
+}
+
+void EventRecorder::load(const std::string &filename) {
+    if (!Serializer::isSerializedFile(filename))
+        throw std::runtime_error("EventRecorder::load(): \"" + filename + "\" is not a recording!");
+
+    Serializer s(filename, false);
+    uint32_t version = 0;
+    std::vector<double> times, coords;
+    std::vector<int32_t> args;
+    s.push("events");
+    if (!s.get("version", version) || version != RecordingVersion)
+        throw std::runtime_error("EventRecorder::load(): unsupported file version!");
+    s.get("times", times);
+    s.get("coords", coords);
+    s.get("args", args);
+    s.pop();
+
+    if (coords.size() != times.size() * 2 || args.size() != times.size() * 5)
+        throw std::runtime_error("EventRecorder::load(): file is corrupt!");
+
+    mEvents.resize(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        Event &e = mEvents[i];
+        e.type = (EventType) args[i * 5];
+        e.time = times[i];
+        e.x = coords[i * 2];
+        e.y = coords[i * 2 + 1];
+        std::copy(&args[i * 5 + 1], &args[i * 5 + 5], e.arg);
+    }
+}
+
+EventRecorder::Statistics EventRecorder::replay(Screen *screen, bool realTime) {
+    if (recording())
+        throw std::runtime_error("EventRecorder::replay(): a recording is in progress!");
+
+    typedef std::chrono::steady_clock Clock;
+    const double frameTime = 1.0 / 60.0;
+    double start = glfwGetTime(), lastDraw = -frameTime;
+
+    /* The virtual clock starts one second after the current time. Widgets
+       still hold timestamps taken before the replay (e.g. of the last click
+       of a text box), which thereby always lie further in the past than the
+       double click interval. Tooltip delays start with the replay */
+    const double epoch = start + 1.0;
+    /* Read by rendering threads through getTime() */
+    std::atomic<double> virtualTime { epoch };
+    screen->mLastInteraction = epoch;
+
+    /* Restore the GLFW timer even if an event handler throws. Timestamps
+       taken during the replay then lie in the future, which the double
+       click checks ignore; tooltip delays restart */
+    struct TimeSourceGuard {
+        Screen *screen;
+        ~TimeSourceGuard() {
+            setTimeSource(nullptr);
+            screen->mLastInteraction = glfwGetTime();
+        }
+    } guard { screen };
+    setTimeSource([&virtualTime] { return virtualTime.load(); });
+
+    mLatencies.clear();
+    mLatencies.reserve(mEvents.size());
+
+    for (const Event &e : mEvents) {
+        while (realTime) {
+            double now = glfwGetTime() - start;
+            if (now >= e.time)
+                break;
+            if (now - lastDraw >= frameTime) {
+                virtualTime = epoch + now;
+                screen->drawAll();
+                lastDraw = now;
+            } else {
+                double wait = std::min(e.time, lastDraw + frameTime) - now;
+                std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+            }
+        }
+
+        virtualTime = epoch + e.time;
+        Clock::time_point t0 = Clock::now();
+        switch (e.type) {
+            case EventType::CursorPos:
+                screen->cursorPosCallbackEvent(e.x, e.y);
+                break;
+            case EventType::MouseButton:
+                screen->mouseButtonCallbackEvent(e.arg[0], e.arg[1], e.arg[2]);
+                break;
+            case EventType::Key:
+                screen->keyCallbackEvent(e.arg[0], e.arg[1], e.arg[2], e.arg[3]);
+                break;
+            case EventType::Char:
+                screen->charCallbackEvent((unsigned int) e.arg[0]);
+                break;
+            case EventType::Scroll:
+                screen->scrollCallbackEvent(e.x, e.y);
+                break;
+        }
+        mLatencies.push_back(std::chrono::duration<double>(Clock::now() - t0).count());
+    }
+
+    Statistics stats;
+    if (mLatencies.empty())
+        return stats;
+
+    std::vector<double> sorted(mLatencies);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) { return sorted[(size_t) (p * (sorted.size() - 1) + 0.5)]; };
+
+    stats.count = sorted.size();
+    for (double latency : sorted)
+        stats.total += latency;
+    stats.mean = stats.total / stats.count;
+    stats.median = percentile(0.5);
+    stats.p90 = percentile(0.9);
+    stats.p99 = percentile(0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+NAMESPACE_END(nanogui)
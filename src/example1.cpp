@@ -310,6 +310,12 @@ public:
         new Label(window, "Progress bar", "sans-bold");
         mProgress = new ProgressBar(window);
 
+        /* Animate the progress bar (and the rotating triangle drawn by
+           drawContents()) at 60 Hz; the main loop sleeps in between */
+        mAnimationTimer = addTimer(1.0 / 60.0, [this] {
+            mProgress->setValue(std::fmod((float) glfwGetTime() / 10, 1.0f));
+        }, true);
+
         new Label(window, "Slider and text box", "sans-bold");
 
         Widget *panel = new Widget(window);
@@ -562,6 +568,7 @@ public:
     }
 
     ~ExampleApplication() {
+        nanogui::removeTimer(mAnimationTimer);
         mShader.free();
     }
 
@@ -575,14 +582,6 @@ public:
         return false;
     }
 
-    virtual void draw(NVGcontext *ctx) {
-        /* Animate the scrollbar */
-        mProgress->setValue(std::fmod((float) glfwGetTime() / 10, 1.0f));
-
-        /* Draw the user interface */
-        Screen::draw(ctx);
-    }
-
     virtual void drawContents() {
         using namespace nanogui;
 
@@ -602,6 +601,7 @@ public:
     }
 private:
     nanogui::ProgressBar *mProgress;
+    int mAnimationTimer;
     nanogui::GLShader mShader;
 
     using imagesDataType = vector<pair<GLTexture, GLTexture::handleType>>;
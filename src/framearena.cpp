@@ -0,0 +1,178 @@
+/*
+    src/framearena.cpp -- Per-frame bump allocation of transient data and
+    counters for heap allocations made while drawing a frame
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/framearena.h>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+NAMESPACE_BEGIN(nanogui)
+
+FrameArena::FrameArena()
+    : mData(static_cast<char *>(std::malloc(BlockSize))), mCapacity(BlockSize),
+      mOffset(0), mOverflowOffset(0), mOverflowUsed(0) {
+    if (!mData)
+        throw std::bad_alloc();
+}
+
+FrameArena::~FrameArena() {
+    for (auto &block : mOverflow)
+        std::free(block.first);
+    std::free(mData);
+}
+
+void *FrameArena::allocateOverflow(size_t size, size_t align) {
+    mOverflowUsed += size;
+
+    /* Continue in the most recent overflow block if the request fits */
+    if (!mOverflow.empty()) {
+        auto &block = mOverflow.back();
+        size_t address = reinterpret_cast<size_t>(block.first);
+        size_t offset = ((address + mOverflowOffset + align - 1) & ~(align - 1)) - address;
+        if (offset + size <= block.second) {
+            mOverflowOffset = offset + size;
+            return block.first + offset;
+        }
+    }
+
+    size_t blockSize = std::max(mCapacity, size + align);
+    char *data = static_cast<char *>(std::malloc(blockSize));
+    if (!data)
+        throw std::bad_alloc();
+    mOverflow.emplace_back(data, blockSize);
+
+    size_t address = reinterpret_cast<size_t>(data);
+    size_t offset = ((address + align - 1) & ~(align - 1)) - address;
+    mOverflowOffset = offset + size;
+    return data + offset;
+}
+
+void FrameArena::reset() {
+    if (!mOverflow.empty()) {
+        /* Grow the primary block so that the next frame fits into it */
+        size_t capacity = mCapacity;
+        for (auto &block : mOverflow) {
+            capacity += block.second;
+            std::free(block.first);
+        }
+        mOverflow.clear();
+        std::free(mData);
+        mData = static_cast<char *>(std::malloc(capacity));
+        if (!mData) {
+            mData = static_cast<char *>(std::malloc(BlockSize));
+            capacity = BlockSize;
+        }
+        mCapacity = capacity;
+    }
+    mOffset = 0;
+    mOverflowOffset = 0;
+    mOverflowUsed = 0;
+}
+
+FrameArena &FrameArena::thread() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+#if defined(NANOGUI_TRACK_ALLOCATIONS)
+NAMESPACE_BEGIN(detail)
+/* Trivially destructible, so that the counters remain usable while other
+   thread-local objects are constructed and destroyed */
+static thread_local uint64_t allocation_count = 0;
+static thread_local uint64_t deallocation_count = 0;
+static thread_local uint64_t allocation_bytes = 0;
+NAMESPACE_END(detail)
+#endif
+
+bool allocationTracking() {
+#if defined(NANOGUI_TRACK_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationStats allocationStats() {
+    AllocationStats stats;
+#if defined(NANOGUI_TRACK_ALLOCATIONS)
+    stats.allocations = detail::allocation_count;
+    stats.deallocations = detail::deallocation_count;
+    stats.bytes = detail::allocation_bytes;
+#endif
+    return stats;
+}
+
+NAMESPACE_END(nanogui)
+
+#if defined(NANOGUI_TRACK_ALLOCATIONS)
+/* Replacements of the global allocation functions that count the calls made
+   by each thread. The array, nothrow and sized variants forward to these */
+
+void *operator new(std::size_t size) {
+    nanogui::detail::allocation_count++;
+    nanogui::detail::allocation_bytes += size;
+    if (size == 0)
+        size = 1;
+    while (true) {
+        void *ptr = std::malloc(size);
+        if (ptr)
+            return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr)
+        return;
+    nanogui::detail::deallocation_count++;
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+#endif
@@ -0,0 +1,113 @@
+/*
+    src/gapbuffer.cpp -- Text storage with cheap insertion and removal
+    near the editing position
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/gapbuffer.h>
+#include <algorithm>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+GapBuffer::GapBuffer() : mGapBegin(0), mGapEnd(0) { }
+
+void GapBuffer::moveGap(size_t pos) {
+    if (pos < mGapBegin) {
+        size_t count = mGapBegin - pos;
+        std::memmove(mData.data() + mGapEnd - count, mData.data() + pos, count);
+        mGapBegin -= count;
+        mGapEnd -= count;
+    } else if (pos > mGapBegin) {
+        size_t count = pos - mGapBegin;
+        std::memmove(mData.data() + mGapBegin, mData.data() + mGapEnd, count);
+        mGapBegin += count;
+        mGapEnd += count;
+    }
+}
+
+void GapBuffer::reserveGap(size_t length) {
+    size_t gap = mGapEnd - mGapBegin;
+    if (gap >= length)
+        return;
+
+    /* Grow geometrically so that typing stays amortized O(1) */
+    size_t textSize = size();
+    size_t newGap = std::max(std::max(length, textSize / 2), (size_t) 64);
+    size_t tail = mData.size() - mGapEnd;
+    mData.resize(textSize + newGap);
+    std::memmove(mData.data() + mData.size() - tail, mData.data() + mGapEnd, tail);
+    mGapEnd = mGapBegin + newGap;
+}
+
+void GapBuffer::insert(size_t pos, const char *str, size_t length) {
+    if (length == 0)
+        return;
+    moveGap(pos);
+    reserveGap(length);
+    std::memcpy(mData.data() + mGapBegin, str, length);
+    mGapBegin += length;
+}
+
+void GapBuffer::erase(size_t pos, size_t length) {
+    if (length == 0)
+        return;
+    moveGap(pos);
+    mGapEnd += length;
+}
+
+void GapBuffer::assign(const std::string &str) {
+    mData.assign(str.begin(), str.end());
+    mGapBegin = mGapEnd = mData.size();
+}
+
+std::string GapBuffer::substr(size_t begin, size_t end) const {
+    std::string result;
+    result.reserve(end - begin);
+    if (begin < mGapBegin)
+        result.append(mData.data() + begin, std::min(end, mGapBegin) - begin);
+    if (end > mGapBegin) {
+        size_t gap = mGapEnd - mGapBegin;
+        size_t from = std::max(begin, mGapBegin);
+        result.append(mData.data() + from + gap, end - from);
+    }
+    return result;
+}
+
+const char *GapBuffer::data(size_t begin, size_t end) {
+    if (begin < mGapBegin && end > mGapBegin) {
+        /* Move the gap by the shorter distance */
+        if (mGapBegin - begin < end - mGapBegin)
+            moveGap(begin);
+        else
+            moveGap(end);
+    }
+    if (begin >= mGapBegin)
+        begin += mGapEnd - mGapBegin;
+    return mData.data() + begin;
+}
+
+size_t GapBuffer::find(char c, size_t pos) const {
+    size_t gap = mGapEnd - mGapBegin;
+    if (pos < mGapBegin) {
+        const void *hit = std::memchr(mData.data() + pos, c, mGapBegin - pos);
+        if (hit)
+            return (size_t) ((const char *) hit - mData.data());
+        pos = mGapBegin;
+    }
+    size_t total = size();
+    if (pos >= total)
+        return total;
+    const void *hit = std::memchr(mData.data() + pos + gap, c, total - pos);
+    if (hit)
+        return (size_t) ((const char *) hit - mData.data()) - gap;
+    return total;
+}
+
+NAMESPACE_END(nanogui)
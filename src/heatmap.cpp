@@ -0,0 +1,284 @@
+/*
+    src/heatmap.cpp -- Scrolling heatmap / spectrogram of streamed data
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/heatmap.h>
+#include <nanogui/numeric.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(nanogui)
+
+namespace {
+    /* 'head' rotates the ring buffer so that its oldest column is on the
+       left, and the color map is sampled between its first and last texel
+       centers so that both ends of the range get the end colors */
+    constexpr char const *const heatmapFragmentShader =
+        R"(#version 330
+        uniform sampler2D image;
+        uniform sampler1D colormap;
+        uniform float head;
+        uniform vec2 normalization;
+        out vec4 color;
+        in vec2 uv;
+        void main() {
+            float value = texture(image, vec2(uv.x + head, uv.y)).r;
+            if (isnan(value))
+                discard;
+            float t = clamp(value * normalization.x + normalization.y, 0.0, 1.0);
+            float n = float(textureSize(colormap, 0));
+            color = texture(colormap, (t * (n - 1.0) + 0.5) / n);
+        })";
+
+    constexpr int ColormapSize = 256;
+
+    /* Polynomial fits of the matplotlib color maps */
+    const float viridisCoefficients[7][3] = {
+        { 0.2777273272234177f, 0.005407344544966578f, 0.3340998053353061f },
+        { 0.1050930431085774f, 1.404613529898575f, 1.384590162594685f },
+        { -0.3308618287255563f, 0.214847559468213f, 0.09509516302823659f },
+        { -4.634230498983486f, -5.799100973351585f, -19.33244095627987f },
+        { 6.228269936347081f, 14.17993336680509f, 56.69055260068105f },
+        { 4.776384997670288f, -13.74514537774601f, -65.35303263337234f },
+        { -5.435455855934631f, 4.645852612178535f, 26.3124352495832f }
+    };
+
+    const float infernoCoefficients[7][3] = {
+        { 0.0002189403691192265f, 0.001651004631001012f, -0.01948089843709184f },
+        { 0.1065134194856116f, 0.5639564367884091f, 3.932712388889277f },
+        { 11.60249308247187f, -3.972853965665698f, -15.9423941062914f },
+        { -41.70399613139459f, 17.43639888205313f, 44.35414519872813f },
+        { 77.162935699427f, -33.40235894210092f, -81.80730925738993f },
+        { -71.31942824499214f, 32.62606426397723f, 73.20951985803202f },
+        { 25.13112622477341f, -12.24266895238567f, -23.07032500287172f }
+    };
+
+    std::vector<Color> evaluateColormap(const float (&coefficients)[7][3]) {
+        std::vector<Color> colors;
+        colors.reserve(ColormapSize);
+        for (int i = 0; i < ColormapSize; ++i) {
+            float t = i / (float) (ColormapSize - 1);
+            Vector3f value = Vector3f::Zero();
+            for (int j = 6; j >= 0; --j)
+                value = value * t + Vector3f(coefficients[j][0], coefficients[j][1], coefficients[j][2]);
+            colors.emplace_back(value.cwiseMax(0.f).cwiseMin(1.f).eval(), 1.f);
+        }
+        return colors;
+    }
+
+    /* Validate the size before any base class adds the widget to its parent */
+    GLuint checkSize(int columns, int rows, GLuint texture) {
+        if (columns < 1 || rows < 1)
+            throw std::runtime_error("Heatmap::Heatmap(): expected at least one column and one row!");
+        return texture;
+    }
+
+    GLuint createTexture(int columns, int rows) {
+        checkSize(columns, rows, 0);
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, columns, rows, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+}
+
+Heatmap::Heatmap(Widget *parent, int columns, int rows)
+    : Heatmap(parent, columns, rows, createTexture(columns, rows)) { }
+
+Heatmap::Heatmap(Widget *parent, int columns, int rows, GLuint texture)
+    : ImageView(parent, checkSize(columns, rows, texture), heatmapFragmentShader), mColumns(columns), mRows(rows),
+      mTexture(texture), mColormap(0), mColormapDirty(false), mAutoRange(true), mRangeMin(0.f), mRangeMax(1.f) {
+    glGenTextures(1, &mColormap);
+    glBindTexture(GL_TEXTURE_1D, mColormap);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    setColormap(Colormap::Viridis);
+    clear();
+
+    setPixelInfoCallback([this](const Vector2i &pixel) {
+        float value = this->value(pixel.x(), mRows - 1 - pixel.y());
+        if (std::isnan(value))
+            return std::make_pair(std::string(), Color());
+
+        /* Pick black or white text depending on the color of the value */
+        auto range = this->range();
+        float t = range.second > range.first ? (value - range.first) / (range.second - range.first) : 0.5f;
+        int index = (int) std::round(std::min(std::max(t, 0.f), 1.f) * (ColormapSize - 1));
+        const uint8_t *rgb = &mColormapData[index * 4];
+        float luminance = (0.299f * rgb[0] + 0.587f * rgb[1] + 0.114f * rgb[2]) / 255.f;
+
+        char buffer[NumberBufferSize];
+        size_t length = formatNumber(buffer, sizeof(buffer), value, "%.4g");
+        return std::make_pair(std::string(buffer, length),
+                              luminance > 0.5f ? Color(0, 255) : Color(255, 255));
+    });
+}
+
+Heatmap::~Heatmap() {
+    glDeleteTextures(1, &mTexture);
+    glDeleteTextures(1, &mColormap);
+}
+
+void Heatmap::bindImage(GLuint) {
+    throw std::runtime_error("Heatmap::bindImage(): the texture of a heatmap cannot be replaced!");
+}
+
+void Heatmap::appendColumn(const float *values) {
+    size_t slot = (size_t) (mCount % (uint64_t) mColumns);
+    float lo = std::numeric_limits<float>::infinity(), hi = -lo;
+    for (int i = 0; i < mRows; ++i) {
+        float value = values[i];
+        mValues[(size_t) (mRows - 1 - i) * mColumns + slot] = value;
+        /* NaNs fail both comparisons */
+        if (value < lo)
+            lo = value;
+        if (value > hi)
+            hi = value;
+    }
+
+    uint64_t index = mCount++;
+
+    /* An entry that is not smaller (larger) than the new column's minimum
+       (maximum) can never be the extremum of the window again */
+    if (lo <= hi) {
+        while (!mMinimum.empty() && mMinimum.back().second >= lo)
+            mMinimum.pop_back();
+        mMinimum.emplace_back(index, lo);
+        while (!mMaximum.empty() && mMaximum.back().second <= hi)
+            mMaximum.pop_back();
+        mMaximum.emplace_back(index, hi);
+    }
+
+    /* Forget the columns that scrolled out */
+    while (!mMinimum.empty() && mMinimum.front().first + mColumns < mCount)
+        mMinimum.pop_front();
+    while (!mMaximum.empty() && mMaximum.front().first + mColumns < mCount)
+        mMaximum.pop_front();
+}
+
+void Heatmap::clear() {
+    mValues.assign((size_t) mColumns * mRows, std::numeric_limits<float>::quiet_NaN());
+    mCount = mUploaded = 0;
+    mUploadAll = true;
+    mMinimum.clear();
+    mMaximum.clear();
+}
+
+float Heatmap::value(int column, int row) const {
+    if (column < 0 || column >= mColumns || row < 0 || row >= mRows)
+        return std::numeric_limits<float>::quiet_NaN();
+    size_t slot = (size_t) ((mCount + (uint64_t) column) % (uint64_t) mColumns);
+    return mValues[(size_t) (mRows - 1 - row) * mColumns + slot];
+}
+
+std::pair<float, float> Heatmap::range() const {
+    if (!mAutoRange)
+        return { mRangeMin, mRangeMax };
+    if (mMinimum.empty())
+        return { 0.f, 1.f };
+    return { mMinimum.front().second, mMaximum.front().second };
+}
+
+void Heatmap::setRange(float min, float max) {
+    mRangeMin = min;
+    mRangeMax = max;
+    mAutoRange = false;
+}
+
+void Heatmap::setColormap(Colormap colormap) {
+    switch (colormap) {
+        case Colormap::Grayscale:
+            setColormap({ Color(0.f, 1.f), Color(1.f, 1.f) });
+            break;
+        case Colormap::Viridis:
+            setColormap(evaluateColormap(viridisCoefficients));
+            break;
+        case Colormap::Inferno:
+            setColormap(evaluateColormap(infernoCoefficients));
+            break;
+    }
+}
+
+void Heatmap::setColormap(const std::vector<Color> &colors) {
+    if (colors.size() < 2)
+        throw std::runtime_error("Heatmap::setColormap(): expected at least two colors!");
+
+    mColormapData.resize(ColormapSize * 4);
+    for (int i = 0; i < ColormapSize; ++i) {
+        float t = i * (colors.size() - 1) / (float) (ColormapSize - 1);
+        size_t index = std::min((size_t) t, colors.size() - 2);
+        Color color = colors[index] * (index + 1 - t) + colors[index + 1] * (t - index);
+        for (int j = 0; j < 4; ++j)
+            mColormapData[i * 4 + j] = (uint8_t) std::round(std::min(std::max(color[j], 0.f), 1.f) * 255.f);
+    }
+    mColormapDirty = true;
+}
+
+void Heatmap::upload() {
+    uint64_t pending = mUploadAll ? (uint64_t) mColumns
+                                  : std::min(mCount - mUploaded, (uint64_t) mColumns);
+    if (pending == 0)
+        return;
+    int first = mUploadAll ? 0 : (int) ((mCount - pending) % (uint64_t) mColumns);
+
+    /* The new columns are a range of every row of 'mValues' (split in two
+       where the ring buffer wraps around), copied in place by one call */
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, mColumns);
+    while (pending > 0) {
+        int count = (int) std::min(pending, (uint64_t) (mColumns - first));
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, first);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, first, 0, count, mRows, GL_RED, GL_FLOAT, mValues.data());
+        pending -= (uint64_t) count;
+        first = 0;
+    }
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    mUploaded = mCount;
+    mUploadAll = false;
+}
+
+void Heatmap::draw(NVGcontext *ctx) {
+    upload();
+
+    if (mColormapDirty) {
+        glBindTexture(GL_TEXTURE_1D, mColormap);
+        glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, ColormapSize, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, mColormapData.data());
+        mColormapDirty = false;
+    }
+
+    auto range = this->range();
+    float scale = range.second > range.first ? 1.f / (range.second - range.first) : 0.f;
+    Vector2f normalization(scale, scale == 0.f ? 0.5f : -range.first * scale);
+
+    /* Uniforms stay set when ImageView::draw() binds the shader again */
+    GLShader &shader = imageShader();
+    shader.bind();
+    shader.setUniform("colormap", 1);
+    shader.setUniform("head", (float) (mCount % (uint64_t) mColumns) / mColumns);
+    shader.setUniform("normalization", normalization);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_1D, mColormap);
+    glActiveTexture(GL_TEXTURE0);
+
+    ImageView::draw(ctx);
+}
+
+NAMESPACE_END(nanogui)
@@ -15,29 +15,26 @@
 #include <nanogui/window.h>
 #include <nanogui/screen.h>
 #include <nanogui/theme.h>
+#include <nanogui/framearena.h>
+#include <algorithm>
 #include <cmath>
 
 NAMESPACE_BEGIN(nanogui)
 
 namespace {
-    std::vector<std::string> tokenize(const std::string &string,
-                                      const std::string &delim = "\n",
-                                      bool includeEmpty = false) {
-        std::string::size_type lastPos = 0, pos = string.find_first_of(delim, lastPos);
-        std::vector<std::string> tokens;
-
-        while (lastPos != std::string::npos) {
-            std::string substr = string.substr(lastPos, pos - lastPos);
-            if (!substr.empty() || includeEmpty)
-                tokens.push_back(std::move(substr));
-            lastPos = pos;
-            if (lastPos != std::string::npos) {
-                lastPos += 1;
-                pos = string.find_first_of(delim, lastPos);
-            }
+    /* Split a string at newlines into (begin, end) pointer pairs without
+       copying; the result lives in the frame arena */
+    frame_vector<std::pair<const char *, const char *>> splitLines(const std::string &string) {
+        frame_vector<std::pair<const char *, const char *>> lines;
+        lines.reserve(4);
+        const char *start = string.data(), *end = start + string.size();
+        while (start != end) {
+            const char *next = std::find(start, end, '\n');
+            if (next != start)
+                lines.emplace_back(start, next);
+            start = next == end ? end : next + 1;
         }
-
-        return tokens;
+        return lines;
     }
 
     constexpr char const *const defaultImageViewVertexShader =
@@ -67,11 +64,13 @@ namespace {
 }
 
 ImageView::ImageView(Widget* parent, GLuint imageID)
+    : ImageView(parent, imageID, defaultImageViewFragmentShader) { }
+
+ImageView::ImageView(Widget* parent, GLuint imageID, const char* fragmentShader)
     : Widget(parent), mImageID(imageID), mScale(1.0f), mOffset(Vector2f::Zero()),
     mFixedScale(false), mFixedOffset(false), mPixelInfoCallback(nullptr) {
     updateImageParameters();
-    mShader.init("ImageViewShader", defaultImageViewVertexShader,
-                 defaultImageViewFragmentShader);
+    mShader.init("ImageViewShader", defaultImageViewVertexShader, fragmentShader);
 
     MatrixXu indices(3, 2);
     indices.col(0) << 0, 1, 2;
@@ -291,8 +290,7 @@ void ImageView::draw(NVGcontext* ctx) {
 
     // Calculate several variables that need to be send to OpenGL in order for the image to be
     // properly displayed inside the widget.
-    const Screen* screen = dynamic_cast<const Screen*>(this->window()->parent());
-    assert(screen);
+    const Screen* screen = this->screen();
     Vector2f screenSize = screen->size().cast<float>();
     Vector2f scaleFactor = mScale * imageSizeF().cwiseQuotient(screenSize);
     Vector2f positionInScreen = absolutePosition().cast<float>();
@@ -434,7 +432,7 @@ void ImageView::drawPixelInfo(NVGcontext* ctx, float stride) const {
 void ImageView::writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
                                const Vector2i& pixel, float stride, float fontSize) const {
     auto pixelData = mPixelInfoCallback(pixel);
-    auto pixelDataRows = tokenize(pixelData.first);
+    auto pixelDataRows = splitLines(pixelData.first);
 
     // If no data is provided for this pixel then simply return.
     if (pixelDataRows.empty())
@@ -444,7 +442,7 @@ void ImageView::writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
     float yOffset = (stride - fontSize * pixelDataRows.size()) / 2;
     for (size_t i = 0; i != pixelDataRows.size(); ++i) {
         nvgText(ctx, cellPosition.x() + stride / 2, cellPosition.y() + yOffset,
-                pixelDataRows[i].data(), nullptr);
+                pixelDataRows[i].first, pixelDataRows[i].second);
         yOffset += fontSize;
     }
 }
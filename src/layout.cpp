@@ -20,6 +20,11 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Return 'widget' if it is a window, and nullptr otherwise */
+static inline const Window *asWindow(const Widget *widget) {
+    return widget->hasKind(Widget::WindowKind) ? static_cast<const Window *>(widget) : nullptr;
+}
+
 BoxLayout::BoxLayout(Orientation orientation, Alignment alignment,
           int margin, int spacing)
     : mOrientation(orientation), mAlignment(alignment), mMargin(margin),
@@ -30,7 +35,7 @@ Vector2i BoxLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
     Vector2i size = Vector2i::Constant(2*mMargin);
 
     int yOffset = 0;
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty()) {
         if (mOrientation == Orientation::Vertical)
             size[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
@@ -72,7 +77,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int position = mMargin;
     int yOffset = 0;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty()) {
         if (mOrientation == Orientation::Vertical) {
             position += widget->theme()->mWindowHeaderHeight - mMargin/2;
@@ -126,7 +131,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 Vector2i GroupLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
     int height = mMargin, width = 2*mMargin;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         height += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -134,7 +139,7 @@ Vector2i GroupLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const
     for (auto c : widget->children()) {
         if (!c->visible())
             continue;
-        const Label *label = dynamic_cast<const Label *>(c);
+        const Label *label = c->hasKind(Widget::LabelKind) ? static_cast<const Label *>(c) : nullptr;
         if (!first)
             height += (label == nullptr) ? mSpacing : mGroupSpacing;
         first = false;
@@ -160,7 +165,7 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int height = mMargin, availableWidth =
         (widget->fixedWidth() ? widget->fixedWidth() : widget->width()) - 2*mMargin;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         height += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -168,7 +173,7 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     for (auto c : widget->children()) {
         if (!c->visible())
             continue;
-        const Label *label = dynamic_cast<const Label *>(c);
+        const Label *label = c->hasKind(Widget::LabelKind) ? static_cast<const Label *>(c) : nullptr;
         if (!first)
             height += (label == nullptr) ? mSpacing : mGroupSpacing;
         first = false;
@@ -207,7 +212,7 @@ Vector2i GridLayout::preferredSize(NVGcontext *ctx,
          + std::max((int) grid[1].size() - 1, 0) * mSpacing[1]
     );
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         size[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -263,7 +268,7 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int dim[2] = { (int) grid[0].size(), (int) grid[1].size() };
 
     Vector2i extra = Vector2i::Zero();
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin / 2;
 
@@ -357,7 +362,7 @@ Vector2i AdvancedGridLayout::preferredSize(NVGcontext *ctx, const Widget *widget
         std::accumulate(grid[1].begin(), grid[1].end(), 0));
 
     Vector2i extra = Vector2i::Constant(2 * mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -369,7 +374,7 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     computeLayout(ctx, widget, grid);
 
     grid[0].insert(grid[0].begin(), mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         grid[1].insert(grid[1].begin(), widget->theme()->mWindowHeaderHeight + mMargin/2);
     else
@@ -422,7 +427,7 @@ void AdvancedGridLayout::computeLayout(NVGcontext *ctx, const Widget *widget,
     );
 
     Vector2i extra = Vector2i::Constant(2 * mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = asWindow(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
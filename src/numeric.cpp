@@ -0,0 +1,248 @@
+/*
+    src/numeric.cpp -- Locale-independent conversion between numbers and
+    their textual representation
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/numeric.h>
+#include <nanogui/compat.h>
+#include <clocale>
+#include <cmath>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Powers of ten that are exactly representable as doubles */
+static const double powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int MaxExactPow10 = 22;
+
+NAMESPACE_BEGIN(detail)
+
+bool parse_double(const char *it, const char *end, double &value) {
+    while (it != end && (*it == ' ' || *it == '\t'))
+        ++it;
+    const char *start = it;
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+'))
+        negative = *it++ == '-';
+
+    /* Gather up to 19 significant digits, which fit into 64 bits */
+    unsigned long long mantissa = 0;
+    int significant = 0, exponent = 0, digits = 0;
+    bool inexact = false, fraction = false;
+    for (; it != end; ++it) {
+        if (*it == '.' && !fraction) {
+            fraction = true;
+            continue;
+        } else if (*it < '0' || *it > '9') {
+            break;
+        }
+        unsigned digit = (unsigned) (*it - '0');
+        digits++;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + digit;
+            if (mantissa != 0)
+                significant++;
+            if (fraction)
+                exponent--;
+        } else {
+            inexact |= digit != 0;
+            if (!fraction)
+                exponent++;
+        }
+    }
+    if (digits == 0)
+        return false;
+
+    if (it != end && (*it == 'e' || *it == 'E')) {
+        const char *exp = it + 1;
+        bool expNegative = false;
+        if (exp != end && (*exp == '-' || *exp == '+'))
+            expNegative = *exp++ == '-';
+        if (exp != end && *exp >= '0' && *exp <= '9') {
+            int expValue = 0;
+            for (; exp != end && *exp >= '0' && *exp <= '9'; ++exp)
+                if (expValue < 100000)
+                    expValue = expValue * 10 + (*exp - '0');
+            exponent += expNegative ? -expValue : expValue;
+            it = exp;
+        }
+    }
+
+    /* When both the mantissa and the power of ten are exact, a single
+       multiplication or division yields the correctly rounded result */
+    double result;
+    if (mantissa == 0) {
+        result = 0.0;
+    } else if (!inexact && mantissa <= (1ull << 53) &&
+               exponent >= -MaxExactPow10 && exponent <= MaxExactPow10) {
+        result = (double) mantissa;
+        if (exponent < 0)
+            result /= powers_of_ten[-exponent];
+        else
+            result *= powers_of_ten[exponent];
+    } else {
+        /* Rare case: defer to the (slower) exactly rounding stream parser */
+        std::istringstream is(std::string(start, it));
+        is.imbue(std::locale::classic());
+        if (!(is >> result)) {
+            /* Out of range: saturate like strtod() */
+            result = exponent < 0 ? 0.0 : HUGE_VAL;
+            if (negative)
+                result = -result;
+        }
+        value = result;
+        return true;
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+NAMESPACE_END(detail)
+
+/* Recognize formats of the form "%.Ng" and return N (or -1) */
+static int general_precision(const char *format) {
+    if (format[0] != '%' || format[1] != '.')
+        return -1;
+    int precision = 0;
+    const char *it = format + 2;
+    for (; *it >= '0' && *it <= '9'; ++it) {
+        precision = precision * 10 + (*it - '0');
+        if (precision > 15)
+            return -1;
+    }
+    if (it == format + 2 || it[0] != 'g' || it[1] != '\0')
+        return -1;
+    return precision == 0 ? 1 : precision;
+}
+
+static char *write_digits(char *ptr, unsigned long long value, int count) {
+    for (int i = count - 1; i >= 0; --i) {
+        ptr[i] = (char) ('0' + value % 10);
+        value /= 10;
+    }
+    return ptr + count;
+}
+
+/* Produce the output of "%.<precision>g" using double arithmetic. Returns
+   nullptr if the rounding decision cannot be made reliably */
+static char *format_general(char *ptr, double value, int precision) {
+    if (std::signbit(value))
+        *ptr++ = '-';
+    value = std::abs(value);
+    if (value == 0.0) {
+        *ptr++ = '0';
+        return ptr;
+    }
+
+    int exp10 = (int) std::floor(std::log10(value));
+    double scaled = 0.0, lower = powers_of_ten[precision - 1], upper = powers_of_ten[precision];
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        int shift = precision - 1 - exp10;
+        if (shift < -MaxExactPow10 || shift > MaxExactPow10)
+            return nullptr;
+        scaled = shift >= 0 ? value * powers_of_ten[shift] : value / powers_of_ten[-shift];
+        if (scaled >= upper)
+            exp10++;
+        else if (scaled < lower)
+            exp10--;
+        else
+            break;
+    }
+    if (scaled < lower || scaled >= upper)
+        return nullptr;
+
+    /* 'scaled' carries a relative error of at most 2^-53. Give up if the
+       exact value could lie on the other side of a rounding boundary */
+    double fractional = scaled - std::floor(scaled);
+    if (std::abs(fractional - 0.5) <= scaled * std::ldexp(1.0, -52))
+        return nullptr;
+
+    unsigned long long digits = (unsigned long long) std::floor(scaled) + (fractional > 0.5 ? 1 : 0);
+    if ((double) digits >= upper) {
+        digits /= 10;
+        exp10++;
+    }
+
+    /* Drop trailing zeros, as "%g" does */
+    int count = precision;
+    while (count > 1 && digits % 10 == 0) {
+        digits /= 10;
+        count--;
+    }
+
+    if (exp10 < -4 || exp10 >= precision) {
+        ptr = write_digits(ptr, digits, count);
+        if (count > 1) {
+            std::memmove(ptr - count + 2, ptr - count + 1, (size_t) count - 1);
+            ptr[-count + 1] = '.';
+            ptr++;
+        }
+        *ptr++ = 'e';
+        *ptr++ = exp10 < 0 ? '-' : '+';
+        int e = std::abs(exp10);
+        ptr = write_digits(ptr, (unsigned long long) e, e >= 100 ? 3 : 2);
+    } else if (exp10 < 0) {
+        *ptr++ = '0';
+        *ptr++ = '.';
+        for (int i = 0; i < -exp10 - 1; ++i)
+            *ptr++ = '0';
+        ptr = write_digits(ptr, digits, count);
+    } else {
+        int integral = exp10 + 1;
+        if (count <= integral) {
+            ptr = write_digits(ptr, digits, count);
+            for (int i = count; i < integral; ++i)
+                *ptr++ = '0';
+        } else {
+            ptr = write_digits(ptr, digits, count);
+            std::memmove(ptr - count + integral + 1, ptr - count + integral, (size_t) (count - integral));
+            ptr[-count + integral] = '.';
+            ptr++;
+        }
+    }
+    return ptr;
+}
+
+size_t formatNumber(char *buffer, size_t size, double value, const char *format) {
+    int precision = general_precision(format);
+    if (precision > 0 && size >= NumberBufferSize && std::isfinite(value)) {
+        char *end = format_general(buffer, value, precision);
+        if (end) {
+            *end = '\0';
+            return (size_t) (end - buffer);
+        }
+    }
+
+    int length = NANOGUI_SNPRINTF(buffer, size, format, value);
+    if (length < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    if ((size_t) length >= size)
+        length = (int) size - 1;
+
+    /* Undo the effect of a decimal comma in the current C locale */
+    char point = std::localeconv()->decimal_point[0];
+    if (point != '.') {
+        char *pos = std::strchr(buffer, point);
+        if (pos)
+            *pos = '.';
+    }
+    return (size_t) length;
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,163 @@
+/*
+    src/objectarena.cpp -- Bulk allocation of widgets, layouts and other
+    reference counted objects
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/objectarena.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#  include <malloc.h>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Objects are at least aligned like memory returned by malloc(), so that
+   subclasses without NANOGUI_MAKE_ALIGNED_OPERATOR_NEW can rely on the same
+   alignment inside an arena as on the heap */
+static const size_t MinAlignment = alignof(std::max_align_t);
+
+static thread_local ObjectArena *current_arena = nullptr;
+
+static inline uintptr_t align_up(uintptr_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(uintptr_t) (alignment - 1);
+}
+
+/* Set by the destructor of an object that lies in an arena, and consumed by
+   the deallocateObject() call that immediately follows it. Arena objects are
+   preceded by a pointer to their arena, while heap objects carry no header
+   and are released without any lookup or locking. */
+static thread_local const Object *released_object = nullptr;
+
+static inline ObjectArena *&arena_header(void *ptr) {
+    return ((ObjectArena **) ptr)[-1];
+}
+
+Object::Object()
+    : m_inArena(current_arena && current_arena->contains(this)) { }
+
+Object::Object(const Object &)
+    : m_inArena(current_arena && current_arena->contains(this)) { }
+
+Object::~Object() {
+    if (m_inArena)
+        released_object = this;
+}
+
+void *Object::allocateObject(size_t size, size_t alignment) {
+    alignment = std::max(alignment, MinAlignment);
+    if (current_arena)
+        return current_arena->allocate(size, alignment);
+    if (alignment <= MinAlignment)
+        return ::operator new(size);
+
+#if defined(_WIN32)
+    void *ptr = _aligned_malloc(size, alignment);
+#else
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size) != 0)
+        ptr = nullptr;
+#endif
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void Object::deallocateObject(void *ptr, size_t size, size_t alignment) noexcept {
+    if (!ptr)
+        return;
+    const Object *released = released_object;
+    released_object = nullptr;
+
+    /* The flag of an arena object lies within its allocation (also for
+       arrays and when Object is not the first base class). If a new
+       expression failed before any constructor ran, the memory can only
+       come from the arena that is active on this thread */
+    bool inArena = (released && (uintptr_t) released - (uintptr_t) ptr < size) ||
+                   (current_arena && current_arena->contains(ptr));
+    if (inArena)
+        arena_header(ptr)->release();
+    else if (alignment <= MinAlignment)
+        ::operator delete(ptr);
+    else
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+}
+
+ObjectArena::Scope::Scope(ObjectArena *arena) : mPrevious(current_arena) {
+    current_arena = arena;
+}
+
+ObjectArena::Scope::~Scope() {
+    current_arena = mPrevious;
+}
+
+ObjectArena::ObjectArena(size_t chunkSize)
+    : mCursor(nullptr), mEnd(nullptr), mChunkSize(chunkSize), mBytesAllocated(0),
+      mCapacity(0), mObjectCount(0) { }
+
+ObjectArena::~ObjectArena() {
+    for (char *chunk : mChunks)
+        std::free(chunk);
+}
+
+ObjectArena *ObjectArena::current() {
+    return current_arena;
+}
+
+bool ObjectArena::contains(const void *ptr) const {
+    /* Objects are usually constructed in the most recent chunk */
+    uintptr_t value = (uintptr_t) ptr;
+    for (size_t i = mChunks.size(); i-- > 0; ) {
+        uintptr_t start = (uintptr_t) mChunks[i];
+        if (value >= start && value < start + mChunkSizes[i])
+            return true;
+    }
+    return false;
+}
+
+void *ObjectArena::allocate(size_t size, size_t alignment) {
+    /* Leave room for the header that points back to the arena */
+    const size_t header = sizeof(ObjectArena *);
+    uintptr_t ptr = align_up((uintptr_t) mCursor + header, alignment);
+    if (mCursor == nullptr || ptr + size > (uintptr_t) mEnd) {
+        size_t chunkSize = std::max(mChunkSize, size + header + alignment);
+        char *chunk = (char *) std::malloc(chunkSize);
+        if (!chunk)
+            throw std::bad_alloc();
+        mChunks.push_back(chunk);
+        mChunkSizes.push_back(chunkSize);
+        mCapacity += chunkSize;
+        mCursor = chunk;
+        mEnd = chunk + chunkSize;
+        ptr = align_up((uintptr_t) chunk + header, alignment);
+    }
+    arena_header((void *) ptr) = this;
+
+    mBytesAllocated += ptr + size - (uintptr_t) mCursor;
+    mCursor = (char *) (ptr + size);
+
+    /* Each object keeps the arena (and thus its memory) alive */
+    ++mObjectCount;
+    incRef();
+    return (void *) ptr;
+}
+
+void ObjectArena::release() {
+    --mObjectCount;
+    decRef();
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,522 @@
+/*
+    src/plotcanvas.cpp -- GPU-accelerated plot of large time series
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/plotcanvas.h>
+#include <nanogui/numeric.h>
+#include <nanogui/theme.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN(nanogui)
+
+namespace {
+    /* Every instance is a quad spanning one segment, widened by half the
+       line width on all sides so that consecutive segments overlap */
+    constexpr char const *const plotLineVertexShader =
+        R"(#version 330
+        uniform vec2 scale;
+        uniform vec2 offset;
+        uniform vec2 viewport;
+        uniform float size;
+        in vec2 a;
+        in vec2 b;
+        void main() {
+            vec2 pa = a * scale + offset, pb = b * scale + offset;
+            vec2 d = (pb - pa) * viewport;
+            float len = length(d);
+            vec2 dir = len > 0.0 ? d / len : vec2(1.0, 0.0);
+            vec2 normal = vec2(-dir.y, dir.x);
+            float along = gl_VertexID < 2 ? -1.0 : 1.0;
+            float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+            vec2 p = gl_VertexID < 2 ? pa : pb;
+            p += (dir * along + normal * side) * size / viewport;
+            gl_Position = vec4(p, 0.0, 1.0);
+        })";
+
+    /* Every instance is a quad centered at a point */
+    constexpr char const *const plotPointVertexShader =
+        R"(#version 330
+        uniform vec2 scale;
+        uniform vec2 offset;
+        uniform vec2 viewport;
+        uniform float size;
+        in vec2 a;
+        out vec2 uv;
+        void main() {
+            uv = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+            gl_Position = vec4(a * scale + offset + uv * size / viewport, 0.0, 1.0);
+        })";
+
+    constexpr char const *const plotLineFragmentShader =
+        R"(#version 330
+        uniform vec4 color;
+        out vec4 fragColor;
+        void main() {
+            fragColor = color;
+        })";
+
+    constexpr char const *const plotPointFragmentShader =
+        R"(#version 330
+        uniform vec4 color;
+        in vec2 uv;
+        out vec4 fragColor;
+        void main() {
+            if (dot(uv, uv) > 1.0)
+                discard;
+            fragColor = color;
+        })";
+
+    /* Distance between tick marks: 1, 2 or 5 times a power of ten */
+    double tickStep(double range, double maxTicks) {
+        double raw = range / std::max(maxTicks, 1.0);
+        double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+        double normalized = raw / magnitude;
+        return magnitude * (normalized <= 1 ? 1 : normalized <= 2 ? 2 : normalized <= 5 ? 5 : 10);
+    }
+
+    /* Invoke 'func' for the multiples of 'step' within [min, max]. Counting
+       the ticks (rather than adding up 'step') terminates even when 'step'
+       vanishes next to the magnitude of the range; degenerate ranges and
+       steps have no ticks */
+    template <typename Func> void forEachTick(double min, double max, double step, Func func) {
+        if (!(step > 0) || !std::isfinite(step) || !(max > min))
+            return;
+        double first = std::ceil(min / step), last = std::floor(max / step);
+        if (!std::isfinite(first) || !std::isfinite(last) || last - first > 1000)
+            return;
+        for (int i = 0; i <= (int) (last - first); ++i)
+            func((first + i) * step);
+    }
+
+    /* Widen an empty or reversed range; the minimum width matches the zoom
+       limit of PlotCanvas::scrollEvent() */
+    void widenRange(double &min, double &max) {
+        if (min > max)
+            std::swap(min, max);
+        double width = 1e-9 * std::max(std::max(std::abs(min), std::abs(max)), 1.0);
+        if (max - min >= width)
+            return;
+        double center = 0.5 * (min + max),
+               half = std::max(0.5, std::abs(center) * 1e-9);
+        min = center - half;
+        max = center + half;
+    }
+
+    /* Index of the first point at or after 'x' */
+    size_t lowerBound(const std::vector<Vector2f> &points, float x) {
+        return (size_t) (std::lower_bound(points.begin(), points.end(), x,
+            [](const Vector2f &p, float value) { return p.x() < value; }) - points.begin());
+    }
+
+    /* Index of the first point after 'x' */
+    size_t upperBound(const std::vector<Vector2f> &points, float x) {
+        return (size_t) (std::upper_bound(points.begin(), points.end(), x,
+            [](float value, const Vector2f &p) { return value < p.x(); }) - points.begin());
+    }
+}
+
+PlotCanvas::PlotCanvas(Widget *parent)
+    : GLCanvas(parent), mShadersReady(false), mOrigin(0), mHasOrigin(false),
+      mXMin(0), mXMax(1), mYMin(0), mYMax(1), mAutoFit(true),
+      mLineWidth(1.5f), mPointSize(5.f) {
+    mBackgroundColor = Color(0.1f, 1.f);
+}
+
+PlotCanvas::~PlotCanvas() {
+    /* OpenGL objects only exist if the canvas was ever drawn */
+    for (Series &series : mSeries) {
+        for (Level &level : series.levels)
+            if (level.buffer)
+                glDeleteBuffers(1, &level.buffer);
+        if (series.tail.buffer)
+            glDeleteBuffers(1, &series.tail.buffer);
+    }
+    if (!mReleasedBuffers.empty())
+        glDeleteBuffers((GLsizei) mReleasedBuffers.size(), mReleasedBuffers.data());
+    if (mShadersReady) {
+        mLineShader.free();
+        mPointShader.free();
+    }
+}
+
+size_t PlotCanvas::addSeries(const std::string &name, const Color &color, Style style) {
+    Series series;
+    series.name = name;
+    series.color = color;
+    series.style = style;
+    series.levels.resize(1);
+    series.xMin = series.yMin = std::numeric_limits<float>::infinity();
+    series.xMax = series.yMax = -std::numeric_limits<float>::infinity();
+    mSeries.push_back(std::move(series));
+    return mSeries.size() - 1;
+}
+
+void PlotCanvas::clearSeries(size_t index) {
+    Series &series = mSeries[index];
+    for (size_t i = 1; i < series.levels.size(); ++i)
+        if (series.levels[i].buffer)
+            mReleasedBuffers.push_back(series.levels[i].buffer);
+    series.levels.resize(1);
+    series.levels[0].points.clear();
+    series.levels[0].uploaded = 0;
+    series.sorted = true;
+    series.xMin = series.yMin = std::numeric_limits<float>::infinity();
+    series.xMax = series.yMax = -std::numeric_limits<float>::infinity();
+}
+
+void PlotCanvas::append(size_t index, const double *x, const float *y, size_t count) {
+    Series &series = mSeries[index];
+    std::vector<Vector2f> &points = series.levels[0].points;
+    for (size_t i = 0; i < count; ++i) {
+        if (std::isnan(x[i]) || std::isnan(y[i]))
+            continue;
+        if (!mHasOrigin) {
+            mOrigin = x[i];
+            mHasOrigin = true;
+        }
+        Vector2f p((float) (x[i] - mOrigin), y[i]);
+        if (!points.empty() && p.x() < points.back().x())
+            series.sorted = false;
+        series.xMin = std::min(series.xMin, p.x());
+        series.xMax = std::max(series.xMax, p.x());
+        series.yMin = std::min(series.yMin, p.y());
+        series.yMax = std::max(series.yMax, p.y());
+        points.push_back(p);
+    }
+
+    decimate(series, 0);
+}
+
+void PlotCanvas::decimate(Series &series, size_t level) {
+    /* Every group of four points of a level yields two points of the next
+       one: the minimum and the maximum, in their original order */
+    for (; ; ++level) {
+        size_t groups = series.levels[level].points.size() / 4;
+        if (groups == 0)
+            break;
+        if (level + 1 == series.levels.size())
+            series.levels.emplace_back();
+
+        const std::vector<Vector2f> &src = series.levels[level].points;
+        std::vector<Vector2f> &dst = series.levels[level + 1].points;
+        size_t done = dst.size() / 2;
+        if (done == groups)
+            break;
+
+        for (size_t group = done; group < groups; ++group) {
+            const Vector2f *p = src.data() + group * 4;
+            int lo = 0, hi = 0;
+            for (int k = 1; k < 4; ++k) {
+                if (p[k].y() < p[lo].y())
+                    lo = k;
+                if (p[k].y() >= p[hi].y())
+                    hi = k;
+            }
+            dst.push_back(p[std::min(lo, hi)]);
+            dst.push_back(p[std::max(lo, hi)]);
+        }
+    }
+}
+
+void PlotCanvas::upload(Level &level) {
+    size_t count = level.points.size();
+    if (level.uploaded == count)
+        return;
+    if (!level.buffer)
+        glGenBuffers(1, &level.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, level.buffer);
+
+    /* Grow geometrically, so that appending costs amortized constant time */
+    if (count > level.capacity) {
+        level.capacity = std::max(count, std::max(level.capacity * 2, (size_t) 1024));
+        glBufferData(GL_ARRAY_BUFFER, level.capacity * sizeof(Vector2f), nullptr, GL_DYNAMIC_DRAW);
+        level.uploaded = 0;
+    }
+
+    glBufferSubData(GL_ARRAY_BUFFER, level.uploaded * sizeof(Vector2f),
+                    (count - level.uploaded) * sizeof(Vector2f),
+                    level.points.data() + level.uploaded);
+    level.uploaded = count;
+}
+
+void PlotCanvas::drawPoints(Level &level, size_t first, size_t count, bool lines) {
+    size_t instances = lines ? count - 1 : count;
+    if (count == 0 || instances == 0)
+        return;
+
+    GLShader &shader = lines ? mLineShader : mPointShader;
+    glBindBuffer(GL_ARRAY_BUFFER, level.buffer);
+
+    /* Segments read their end points from the same buffer, one point apart */
+    for (int i = 0; i < (lines ? 2 : 1); ++i) {
+        GLint attrib = shader.attrib(i == 0 ? "a" : "b");
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribPointer(attrib, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2f),
+                              (const void *) ((first + i) * sizeof(Vector2f)));
+        glVertexAttribDivisor(attrib, 1);
+    }
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) instances);
+}
+
+void PlotCanvas::fit() {
+    float xmin = std::numeric_limits<float>::infinity(), xmax = -xmin,
+          ymin = xmin, ymax = -xmin;
+    for (const Series &series : mSeries) {
+        if (series.levels[0].points.empty())
+            continue;
+        xmin = std::min(xmin, series.xMin);
+        xmax = std::max(xmax, series.xMax);
+        ymin = std::min(ymin, series.yMin);
+        ymax = std::max(ymax, series.yMax);
+    }
+    if (xmin > xmax)
+        return;
+
+    double margin = (ymax - ymin) * 0.05;
+    if (margin == 0)
+        margin = 0.5;
+    mXMin = xmin + mOrigin;
+    mXMax = xmax + mOrigin;
+    mYMin = ymin - margin;
+    mYMax = ymax + margin;
+    widenRange(mXMin, mXMax);
+    widenRange(mYMin, mYMax);
+}
+
+void PlotCanvas::setRange(double xmin, double xmax, double ymin, double ymax) {
+    if (!std::isfinite(xmin) || !std::isfinite(xmax) || !std::isfinite(ymin) || !std::isfinite(ymax))
+        throw std::runtime_error("PlotCanvas::setRange(): the range must be finite!");
+    widenRange(xmin, xmax);
+    widenRange(ymin, ymax);
+    mXMin = xmin;
+    mXMax = xmax;
+    mYMin = ymin;
+    mYMax = ymax;
+    mAutoFit = false;
+}
+
+bool PlotCanvas::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    if (button == GLFW_MOUSE_BUTTON_2 && down) {
+        mAutoFit = true;
+        return true;
+    }
+    if (button == GLFW_MOUSE_BUTTON_1)
+        return true;
+    return GLCanvas::mouseButtonEvent(p, button, down, modifiers);
+}
+
+bool PlotCanvas::mouseDragEvent(const Vector2i &, const Vector2i &rel, int button, int) {
+    if ((button & (1 << GLFW_MOUSE_BUTTON_1)) == 0)
+        return false;
+    double dx = rel.x() * (mXMax - mXMin) / mSize.x(),
+           dy = rel.y() * (mYMax - mYMin) / mSize.y();
+    mXMin -= dx;
+    mXMax -= dx;
+    mYMin += dy;
+    mYMax += dy;
+    mAutoFit = false;
+    return true;
+}
+
+bool PlotCanvas::scrollEvent(const Vector2i &p, const Vector2f &rel) {
+    /* Keep the value under the cursor in place */
+    double fraction = (p.x() - mPos.x()) / (double) mSize.x();
+    double anchor = mXMin + fraction * (mXMax - mXMin);
+    double factor = std::pow(0.8, (double) rel.y());
+    double range = std::max((mXMax - mXMin) * factor, 1e-9 * std::max(std::abs(anchor), 1.0));
+    mXMin = anchor - fraction * range;
+    mXMax = mXMin + range;
+    mAutoFit = false;
+    return true;
+}
+
+void PlotCanvas::drawGL() {
+    if (!mShadersReady) {
+        mLineShader.init("PlotCanvasLineShader", plotLineVertexShader, plotLineFragmentShader);
+        mPointShader.init("PlotCanvasPointShader", plotPointVertexShader, plotPointFragmentShader);
+        mShadersReady = true;
+    }
+    if (!mReleasedBuffers.empty()) {
+        glDeleteBuffers((GLsizei) mReleasedBuffers.size(), mReleasedBuffers.data());
+        mReleasedBuffers.clear();
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    Vector2f viewportSize((float) viewport[2], (float) viewport[3]);
+    float pixelRatio = viewport[2] / (float) std::max(mSize.x(), 1);
+
+    /* Map the visible range onto normalized device coordinates */
+    double sx = 2.0 / (mXMax - mXMin), sy = 2.0 / (mYMax - mYMin);
+    Vector2f scale((float) sx, (float) sy);
+    Vector2f offset((float) (-1.0 - (mXMin - mOrigin) * sx), (float) (-1.0 - mYMin * sy));
+    float xmin = (float) (mXMin - mOrigin), xmax = (float) (mXMax - mOrigin);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    for (Series &series : mSeries) {
+        series.drawnLevel = 0;
+        series.drawnPoints = 0;
+        const std::vector<Vector2f> &base = series.levels[0].points;
+        if (base.empty())
+            continue;
+
+        /* Choose the coarsest level with at least two points per pixel */
+        size_t visible = base.size();
+        if (series.sorted)
+            visible = upperBound(base, xmax) - lowerBound(base, xmin);
+        size_t level = 0;
+        while (series.sorted && level + 1 < series.levels.size() &&
+               (visible >> (level + 1)) >= (size_t) (2 * viewport[2]))
+            ++level;
+
+        /* Points in view, plus one on each side to continue the lines */
+        Level &points = series.levels[level];
+        size_t first = 0, last = points.points.size();
+        if (series.sorted) {
+            first = lowerBound(points.points, xmin);
+            last = std::min(upperBound(points.points, xmax) + 1, last);
+            first = first > 0 ? first - 1 : 0;
+        }
+        upload(points);
+
+        /* The last few points of every finer level are not yet covered by a
+           complete group of the next one */
+        Level &tail = series.tail;
+        tail.points.clear();
+        if (level > 0 && (!series.sorted || last == points.points.size())) {
+            tail.points.push_back(points.points.back());
+            for (size_t i = level; i-- > 0; ) {
+                const std::vector<Vector2f> &src = series.levels[i].points;
+                tail.points.insert(tail.points.end(),
+                                   src.begin() + series.levels[i + 1].points.size() * 2,
+                                   src.end());
+            }
+            tail.uploaded = 0;
+            upload(tail);
+        }
+
+        series.drawnLevel = (int) level;
+        series.drawnPoints = last - first + tail.points.size();
+
+        for (int pass = 0; pass < 2; ++pass) {
+            bool lines = pass == 0;
+            if ((int) series.style & (lines ? (int) Style::Lines : (int) Style::Points)) {
+                GLShader &shader = lines ? mLineShader : mPointShader;
+                shader.bind();
+                shader.setUniform("scale", scale);
+                shader.setUniform("offset", offset);
+                shader.setUniform("viewport", viewportSize);
+                shader.setUniform("size", (lines ? mLineWidth : mPointSize) * pixelRatio);
+                shader.setUniform("color", Vector4f(series.color));
+                drawPoints(points, first, last - first, lines);
+                drawPoints(tail, 0, tail.points.size(), lines);
+            }
+        }
+    }
+
+    glDisable(GL_BLEND);
+}
+
+void PlotCanvas::draw(NVGcontext *ctx) {
+    if (mAutoFit)
+        fit();
+
+    GLCanvas::draw(ctx);
+
+    /* Grid, tick labels and legend are drawn by NanoVG on top */
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    nvgFontSize(ctx, fontSize());
+    nvgFontFace(ctx, "sans");
+    char buffer[NumberBufferSize];
+
+    double xstep = tickStep(mXMax - mXMin, mSize.x() / 80.0),
+           ystep = tickStep(mYMax - mYMin, mSize.y() / 40.0);
+
+    nvgBeginPath(ctx);
+    forEachTick(mXMin, mXMax, xstep, [&](double t) {
+        float x = std::round(mPos.x() + (float) ((t - mXMin) / (mXMax - mXMin)) * mSize.x()) + 0.5f;
+        nvgMoveTo(ctx, x, mPos.y());
+        nvgLineTo(ctx, x, mPos.y() + mSize.y());
+    });
+    forEachTick(mYMin, mYMax, ystep, [&](double t) {
+        float y = std::round(mPos.y() + mSize.y() - (float) ((t - mYMin) / (mYMax - mYMin)) * mSize.y()) + 0.5f;
+        nvgMoveTo(ctx, mPos.x(), y);
+        nvgLineTo(ctx, mPos.x() + mSize.x(), y);
+    });
+    nvgStrokeColor(ctx, Color(255, 24));
+    nvgStrokeWidth(ctx, 1.f);
+    nvgStroke(ctx);
+
+    nvgFillColor(ctx, mTheme->mTextColor);
+    nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_BOTTOM);
+    forEachTick(mXMin, mXMax, xstep, [&](double t) {
+        double value = std::abs(t) < xstep * 1e-9 ? 0.0 : t;
+        float x = mPos.x() + (float) ((t - mXMin) / (mXMax - mXMin)) * mSize.x();
+        formatNumber(buffer, sizeof(buffer), value, "%g");
+        nvgText(ctx, x, mPos.y() + mSize.y() - 2, buffer, nullptr);
+    });
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    forEachTick(mYMin, mYMax, ystep, [&](double t) {
+        double value = std::abs(t) < ystep * 1e-9 ? 0.0 : t;
+        float y = mPos.y() + mSize.y() - (float) ((t - mYMin) / (mYMax - mYMin)) * mSize.y();
+        formatNumber(buffer, sizeof(buffer), value, "%g");
+        nvgText(ctx, mPos.x() + 4, y, buffer, nullptr);
+    });
+
+    /* Legend */
+    float y = mPos.y() + 4;
+    float lineh = fontSize() * 1.2f;
+    nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+    for (const Series &series : mSeries) {
+        float x = mPos.x() + mSize.x() - 8;
+        float textWidth = nvgTextBounds(ctx, 0, 0, series.name.c_str(), nullptr, nullptr);
+        nvgFillColor(ctx, mTheme->mTextColor);
+        nvgText(ctx, x, y + lineh * 0.5f, series.name.c_str(), nullptr);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, x - textWidth - 16, y + lineh * 0.5f - 1.5f, 12, 3);
+        nvgFillColor(ctx, series.color);
+        nvgFill(ctx);
+        y += lineh;
+    }
+
+    nvgRestore(ctx);
+}
+
+void PlotCanvas::save(Serializer &s) const {
+    GLCanvas::save(s);
+    s.set("xMin", mXMin);
+    s.set("xMax", mXMax);
+    s.set("yMin", mYMin);
+    s.set("yMax", mYMax);
+    s.set("autoFit", mAutoFit);
+    s.set("lineWidth", mLineWidth);
+    s.set("pointSize", mPointSize);
+}
+
+bool PlotCanvas::load(Serializer &s) {
+    if (!GLCanvas::load(s)) return false;
+    if (!s.get("xMin", mXMin)) return false;
+    if (!s.get("xMax", mXMax)) return false;
+    if (!s.get("yMin", mYMin)) return false;
+    if (!s.get("yMax", mYMax)) return false;
+    if (!s.get("autoFit", mAutoFit)) return false;
+    if (!s.get("lineWidth", mLineWidth)) return false;
+    if (!s.get("pointSize", mPointSize)) return false;
+    return true;
+}
+
+NAMESPACE_END(nanogui)
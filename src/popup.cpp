@@ -11,6 +11,7 @@
 */
 
 #include <nanogui/popup.h>
+#include <nanogui/screen.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/serializer/core.h>
@@ -20,6 +21,15 @@ NAMESPACE_BEGIN(nanogui)
 Popup::Popup(Widget *parent, Window *parentWindow)
     : Window(parent, ""), mParentWindow(parentWindow),
       mAnchorPos(Vector2i::Zero()), mAnchorHeight(30), mSide(Side::Right) {
+    mKind |= PopupKind;
+    if (parent && parent->hasKind(ScreenKind))
+        static_cast<Screen *>(parent)->setPopupOwner(this, parentWindow);
+}
+
+void Popup::setParentWindow(Window *parentWindow) {
+    mParentWindow = parentWindow;
+    if (mParent && mParent->hasKind(ScreenKind))
+        static_cast<Screen *>(mParent)->setPopupOwner(this, parentWindow);
 }
 
 void Popup::performLayout(NVGcontext *ctx) {
@@ -37,7 +47,9 @@ void Popup::performLayout(NVGcontext *ctx) {
 void Popup::refreshRelativePlacement() {
     mParentWindow->refreshRelativePlacement();
     mVisible &= mParentWindow->visibleRecursive();
-    mPos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    Vector2i pos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    if (pos != mPos)
+        setPosition(pos);
 }
 
 void Popup::draw(NVGcontext* ctx) {
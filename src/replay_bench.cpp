@@ -0,0 +1,151 @@
+/*
+    src/replay_bench.cpp -- Replays a NanoVG command trace recorded with
+    Screen::recordFrame() and reports percentiles of the time spent in the
+    different stages of the rendering backend
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/opengl.h>
+#include <nanogui/screen.h>
+#include <nanogui/drawtrace.h>
+#include <nanogui/softwarerenderer.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace nanogui;
+
+static void usage() {
+    std::cerr << "Syntax: nanogui_replay_bench [options] <trace file>" << std::endl
+              << "Options:" << std::endl
+              << "  -n <count>     Number of replayed frames (default: 500)" << std::endl
+              << "  --software     Replay against the software renderer instead of OpenGL" << std::endl
+              << "  --threads <n>  Number of rasterization threads of the software renderer" << std::endl;
+}
+
+static void report(const char *name, std::vector<double> values) {
+    if (values.empty())
+        return;
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double p) {
+        size_t index = (size_t) (p * (values.size() - 1) + 0.5);
+        return values[index] * 1000.0;
+    };
+    printf("  %-12s p50 %8.3f ms   p90 %8.3f ms   p99 %8.3f ms   max %8.3f ms\n",
+           name, percentile(0.5), percentile(0.9), percentile(0.99), values.back() * 1000.0);
+}
+
+int main(int argc, char **argv) {
+    std::string filename;
+    int iterations = 500, threads = 0;
+    bool software = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = std::max(atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--software") == 0) {
+            software = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && filename.empty()) {
+            filename = argv[i];
+        } else {
+            usage();
+            return -1;
+        }
+    }
+
+    if (filename.empty()) {
+        usage();
+        return -1;
+    }
+
+    try {
+        DrawTrace trace;
+        trace.load(filename);
+
+        printf("Trace \"%s\": %ix%i (pixel ratio %.2f), %zu draw calls, %zu vertices\n",
+               filename.c_str(), trace.size().x(), trace.size().y(), trace.pixelRatio(),
+               trace.callCount(), trace.vertexCount());
+        printf("Captured frame: tessellation %.3f ms, submit %.3f ms, flush %.3f ms\n",
+               trace.tessellationTime() * 1000.0, trace.submitTime() * 1000.0,
+               trace.flushTime() * 1000.0);
+
+        std::vector<double> submit, flush, device;
+
+        if (software) {
+            SoftwareRenderer renderer(trace.size(), trace.pixelRatio(), threads);
+            for (int i = 0; i < iterations; ++i) {
+                renderer.clear(Color(0.f, 0.f));
+                DrawTrace::Timing timing = trace.replay(renderer.nvgContext());
+                submit.push_back(timing.submit);
+                flush.push_back(timing.flush);
+                device.push_back(renderer.rasterTime());
+            }
+            trace.release();
+
+            printf("Software renderer, %i frames:\n", iterations);
+            report("submit", submit);
+            report("flush", flush);
+            report("rasterize", device);
+        } else {
+            nanogui::init();
+
+            /* scoped variables */ {
+                ref<Screen> screen = new Screen(trace.size(), "NanoGUI replay benchmark");
+                glfwMakeContextCurrent(screen->glfwWindow());
+                glfwSwapInterval(0);
+
+                GLuint query;
+                glGenQueries(1, &query);
+
+                int width, height;
+                glfwGetFramebufferSize(screen->glfwWindow(), &width, &height);
+
+                for (int i = 0; i < iterations; ++i) {
+                    glViewport(0, 0, width, height);
+                    glClearColor(0.f, 0.f, 0.f, 1.f);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+                    glBeginQuery(GL_TIME_ELAPSED, query);
+                    DrawTrace::Timing timing = trace.replay(screen->nvgContext());
+                    glEndQuery(GL_TIME_ELAPSED);
+
+                    GLuint64 elapsed = 0;
+                    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+                    submit.push_back(timing.submit);
+                    flush.push_back(timing.flush);
+                    device.push_back(elapsed * 1e-9);
+
+                    glfwSwapBuffers(screen->glfwWindow());
+                    glfwPollEvents();
+                }
+
+                glDeleteQueries(1, &query);
+                trace.release();
+            }
+
+            nanogui::shutdown();
+
+            printf("OpenGL backend, %i frames:\n", iterations);
+            report("submit", submit);
+            report("flush", flush);
+            report("gpu", device);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Caught a fatal error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
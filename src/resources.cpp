@@ -0,0 +1,118 @@
+/*
+    src/resources.cpp -- Access to resource files (fonts, etc.) that are
+    embedded into the NanoGUI library in compressed form
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/resources.h>
+#include <nanogui/opengl.h>
+#include <nanogui_resources.h>
+#include <memory>
+#include <mutex>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Decoder for the LZ4 block format written by resources/respack.cpp */
+static bool lz4_decompress(const uint8_t *in, uint32_t inSize, uint8_t *out, uint32_t outSize) {
+    const uint8_t *ip = in, *ipEnd = in + inSize;
+    uint8_t *op = out, *opEnd = out + outSize;
+
+    auto readLength = [&](size_t &length) {
+        uint8_t value;
+        do {
+            if (ip >= ipEnd)
+                return false;
+            value = *ip++;
+            length += value;
+        } while (value == 255);
+        return true;
+    };
+
+    while (ip < ipEnd) {
+        uint8_t token = *ip++;
+
+        size_t nLiterals = token >> 4;
+        if (nLiterals == 15 && !readLength(nLiterals))
+            return false;
+        if ((size_t) (ipEnd - ip) < nLiterals || (size_t) (opEnd - op) < nLiterals)
+            return false;
+        memcpy(op, ip, nLiterals);
+        ip += nLiterals; op += nLiterals;
+
+        if (ip == ipEnd)
+            break; /* The last sequence only contains literals */
+
+        if (ipEnd - ip < 2)
+            return false;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t) (op - out))
+            return false;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(matchLength))
+            return false;
+        matchLength += 4;
+        if ((size_t) (opEnd - op) < matchLength)
+            return false;
+
+        /* Matches may overlap the output, hence the bytewise copy */
+        const uint8_t *match = op - offset;
+        for (size_t i = 0; i < matchLength; ++i)
+            op[i] = match[i];
+        op += matchLength;
+    }
+
+    return op == opEnd;
+}
+
+const uint8_t *resource(const std::string &name, uint32_t *size) {
+    static std::mutex mutex;
+    static std::unique_ptr<std::unique_ptr<uint8_t[]>[]> cache(
+        new std::unique_ptr<uint8_t[]>[nanogui_resources_count]);
+
+    for (uint32_t i = 0; i < nanogui_resources_count; ++i) {
+        const nanogui_resource &res = nanogui_resources[i];
+        if (name != res.name)
+            continue;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!cache[i]) {
+            std::unique_ptr<uint8_t[]> data(new uint8_t[res.size]);
+            if (!lz4_decompress(res.data, res.compressed_size, data.get(), res.size))
+                throw std::runtime_error("Embedded resource \"" + name + "\" is corrupt!");
+            cache[i] = std::move(data);
+        }
+        if (size)
+            *size = res.size;
+        return cache[i].get();
+    }
+
+    throw std::runtime_error("Unknown embedded resource \"" + name + "\"!");
+}
+
+std::vector<std::string> resourceNames() {
+    std::vector<std::string> result;
+    for (uint32_t i = 0; i < nanogui_resources_count; ++i)
+        result.push_back(nanogui_resources[i].name);
+    return result;
+}
+
+int createFontResource(NVGcontext *ctx, const char *face, const std::string &name) {
+    int id = nvgFindFont(ctx, face);
+    if (id != -1)
+        return id;
+    uint32_t size = 0;
+    const uint8_t *data = resource(name, &size);
+    /* NanoVG does not modify the font data, and must not free it (the buffer is shared) */
+    return nvgCreateFontMem(ctx, face, const_cast<uint8_t *>(data), (int) size, 0);
+}
+
+NAMESPACE_END(nanogui)
@@ -16,8 +16,15 @@
 #include <nanogui/opengl.h>
 #include <nanogui/window.h>
 #include <nanogui/popup.h>
+#include <nanogui/drawtrace.h>
+#include <nanogui/eventrecorder.h>
+#include <nanogui/tracing.h>
+#include <algorithm>
 #include <map>
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #if defined(_WIN32)
 #  define NOMINMAX
@@ -39,6 +46,30 @@ NAMESPACE_BEGIN(nanogui)
 
 std::map<GLFWwindow *, Screen *> __nanogui_screens;
 
+/* State of a Screen's rendering thread (see Screen::startRenderThread()) */
+struct Screen::RenderThread {
+    std::thread thread;
+    /// Held while the widget tree is accessed: by the main thread to dispatch events, and while drawing
+    std::mutex frameMutex;
+    /// Held by the thread on which the OpenGL context is current (acquired after frameMutex)
+    std::mutex contextMutex;
+    std::mutex signalMutex;
+    std::condition_variable signal;
+    bool frameRequested = false;
+    bool quit = false;
+    int lockDepth = 0; /* Nesting of Screen::lockWidgets() on the main thread */
+    GLFWwindow *previousContext = nullptr; /* Restored by the outermost unlockWidgets() */
+};
+
+namespace {
+    /* Holds Screen::lockWidgets() for the current scope */
+    struct WidgetLockGuard {
+        Screen *screen;
+        WidgetLockGuard(Screen *screen) : screen(screen) { screen->lockWidgets(); }
+        ~WidgetLockGuard() { screen->unlockWidgets(); }
+    };
+}
+
 #if defined(NANOGUI_GLAD)
 static bool gladInitialized = false;
 #endif
@@ -105,7 +136,11 @@ static float get_pixel_ratio(GLFWwindow *window) {
 Screen::Screen()
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f),
-      mShutdownGLFWOnDestruct(false), mFullscreen(false) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(false), mEventCoalescing(true),
+      mEventRecorder(nullptr),
+      mFrameAllocations(0), mFrameDeallocations(0), mFrameAllocatedBytes(0),
+      mCulledWidgets(0) {
+    mKind |= ScreenKind;
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 }
 
@@ -115,7 +150,11 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
                unsigned int glMajor, unsigned int glMinor)
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f), mCaption(caption),
-      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen), mEventCoalescing(true),
+      mEventRecorder(nullptr),
+      mFrameAllocations(0), mFrameDeallocations(0), mFrameAllocatedBytes(0),
+      mCulledWidgets(0) {
+    mKind |= ScreenKind;
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 
     /* Request a forward compatible OpenGL glMajor.glMinor core profile context.
@@ -135,14 +174,20 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
     glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
     glfwWindowHint(GLFW_RESIZABLE, resizable ? GL_TRUE : GL_FALSE);
 
+    /* With threaded rendering, all contexts share textures, buffers, and
+       shader programs with the one created first */
+    GLFWwindow *share = nullptr;
+    if (threadedRendering() && !__nanogui_screens.empty())
+        share = __nanogui_screens.begin()->first;
+
     if (fullscreen) {
         GLFWmonitor *monitor = glfwGetPrimaryMonitor();
         const GLFWvidmode *mode = glfwGetVideoMode(monitor);
         mGLFWWindow = glfwCreateWindow(mode->width, mode->height,
-                                       caption.c_str(), monitor, nullptr);
+                                       caption.c_str(), monitor, share);
     } else {
         mGLFWWindow = glfwCreateWindow(size.x(), size.y(),
-                                       caption.c_str(), nullptr, nullptr);
+                                       caption.c_str(), nullptr, share);
     }
 
     if (!mGLFWWindow)
@@ -186,7 +231,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->cursorPosCallbackEvent(x, y);
+            s->queueEvent(QueuedEvent::CursorPos, x, y);
         }
     );
 
@@ -198,7 +243,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->mouseButtonCallbackEvent(button, action, modifiers);
+            s->queueEvent(QueuedEvent::MouseButton, 0, 0, button, action, modifiers);
         }
     );
 
@@ -210,7 +255,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->keyCallbackEvent(key, scancode, action, mods);
+            s->queueEvent(QueuedEvent::Key, 0, 0, key, scancode, action, mods);
         }
     );
 
@@ -222,7 +267,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->charCallbackEvent(codepoint);
+            s->queueEvent(QueuedEvent::Char, 0, 0, (int) codepoint);
         }
     );
 
@@ -234,7 +279,14 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->dropCallbackEvent(count, filenames);
+            if (!s->mEventCoalescing) {
+                s->dropCallbackEvent(count, filenames);
+                return;
+            }
+            QueuedEvent event;
+            event.type = QueuedEvent::Drop;
+            event.filenames.assign(filenames, filenames + count);
+            s->mEventQueue.push_back(std::move(event));
         }
     );
 
@@ -246,7 +298,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             Screen *s = it->second;
             if (!s->mProcessEvents)
                 return;
-            s->scrollCallbackEvent(x, y);
+            s->queueEvent(QueuedEvent::Scroll, x, y);
         }
     );
 
@@ -264,6 +316,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             if (!s->mProcessEvents)
                 return;
 
+            WidgetLockGuard guard(s);
             s->resizeCallbackEvent(width, height);
         }
     );
@@ -317,7 +370,7 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
     mMousePos = Vector2i::Zero();
     mMouseState = mModifiers = 0;
     mDragActive = false;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = getTime();
     mProcessEvents = true;
     __nanogui_screens[mGLFWWindow] = this;
 
@@ -330,6 +383,9 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
 }
 
 Screen::~Screen() {
+    stopRenderThread();
+    if (mEventRecorder)
+        mEventRecorder->stop();
     __nanogui_screens.erase(mGLFWWindow);
     for (int i=0; i < (int) Cursor::CursorCount; ++i) {
         if (mCursors[i])
@@ -370,21 +426,68 @@ void Screen::setSize(const Vector2i &size) {
 }
 
 void Screen::drawAll() {
-    glClearColor(mBackground[0], mBackground[1], mBackground[2], mBackground[3]);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    NANOGUI_TRACE_SCOPE("Screen::drawAll");
+    AllocationStats allocations = allocationStats();
+    if (!mRenderThread) {
+        processEvents();
+    }
 
-    drawContents();
-    drawWidgets();
+    /* When rendering on a separate thread, the context is only current
+       while drawing and swapping, so that the main thread can use it while
+       it holds the widget lock (see lockWidgets()) */
+    std::unique_lock<std::mutex> contextGuard;
+    {
+        /* Keep the main thread from dispatching events while the widget
+           tree is drawn. Swapping buffers (which may block on vsync)
+           happens without this lock */
+        std::unique_lock<std::mutex> guard;
+        if (mRenderThread) {
+            guard = std::unique_lock<std::mutex>(mRenderThread->frameMutex);
+            contextGuard = std::unique_lock<std::mutex>(mRenderThread->contextMutex);
+            glfwMakeContextCurrent(mGLFWWindow);
+        }
 
-    glfwSwapBuffers(mGLFWWindow);
-}
+        glClearColor(mBackground[0], mBackground[1], mBackground[2], mBackground[3]);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-void Screen::drawWidgets() {
-    if (!mVisible)
-        return;
+        {
+            NANOGUI_TRACE_SCOPE("Screen::drawContents");
+            drawContents();
+        }
+        drawWidgets();
+    }
 
-    glfwMakeContextCurrent(mGLFWWindow);
+    {
+        NANOGUI_TRACE_SCOPE("glfwSwapBuffers");
+        glfwSwapBuffers(mGLFWWindow);
+    }
+    if (contextGuard) {
+        glfwMakeContextCurrent(nullptr);
+        contextGuard.unlock();
+    }
+
+#if defined(NANOGUI_TRACING)
+    /* The frame that responds to the input events dispatched so far is now visible */
+    uint64_t inputTime = mTracePresentStart.exchange(0);
+    if (inputTime)
+        traceEvent("input-to-photon", inputTime, traceTimestamp());
+#endif
+
+    AllocationStats now = allocationStats();
+    mFrameAllocations = now.allocations - allocations.allocations;
+    mFrameDeallocations = now.deallocations - allocations.deallocations;
+    mFrameAllocatedBytes = now.bytes - allocations.bytes;
+}
+
+AllocationStats Screen::frameAllocations() const {
+    AllocationStats stats;
+    stats.allocations = mFrameAllocations;
+    stats.deallocations = mFrameDeallocations;
+    stats.bytes = mFrameAllocatedBytes;
+    return stats;
+}
 
+void Screen::updateWindowSize() {
     glfwGetFramebufferSize(mGLFWWindow, &mFBSize[0], &mFBSize[1]);
     glfwGetWindowSize(mGLFWWindow, &mSize[0], &mSize[1]);
 
@@ -396,14 +499,53 @@ void Screen::drawWidgets() {
     if (mSize[0])
         mPixelRatio = (float) mFBSize[0] / (float) mSize[0];
 #endif
+}
+
+void Screen::loadThemeFonts() {
+    /* Fonts are registered with the context rather than stored in the theme,
+       so they only need to be loaded again when the theme changes */
+    if (mFontTheme == mTheme)
+        return;
+    mTheme->loadFonts(mNVGContext);
+    mFontTheme = mTheme;
+}
+
+void Screen::drawWidgets() {
+    if (!mVisible)
+        return;
+    NANOGUI_TRACE_SCOPE("Screen::drawWidgets");
+
+    glfwMakeContextCurrent(mGLFWWindow);
+
+    /* GLFW only permits querying the window size on the main thread; the
+       rendering thread uses the values recorded by requestFrame() */
+    if (!mRenderThread)
+        updateWindowSize();
 
     glViewport(0, 0, mFBSize[0], mFBSize[1]);
     glBindSampler(0, 0);
+    loadThemeFonts();
+
+    std::unique_ptr<DrawTrace> trace;
+    if (!mTraceFilename.empty()) {
+        trace.reset(new DrawTrace());
+        trace->beginCapture(mNVGContext, mSize, mPixelRatio);
+    }
+
     nvgBeginFrame(mNVGContext, mSize[0], mSize[1], mPixelRatio);
 
+    size_t culled = Widget::culledCount();
     draw(mNVGContext);
+    mCulledWidgets = Widget::culledCount() - culled;
 
-    double elapsed = glfwGetTime() - mLastInteraction;
+    double elapsed = getTime() - mLastInteraction;
+
+    if (elapsed < 1.0) {
+        /* Request frames for the tooltip's delayed appearance and fade-in */
+        const Widget *widget = findWidget(mMousePos);
+        if (widget && !widget->tooltip().empty())
+            scheduleRedraw(elapsed < 0.5 ? 0.5 - elapsed : 1.0 / 60.0);
+    }
 
     if (elapsed > 0.5f) {
         /* Draw tooltips */
@@ -452,9 +594,20 @@ void Screen::drawWidgets() {
     }
 
     nvgEndFrame(mNVGContext);
+
+    if (trace) {
+        trace->endCapture();
+        try {
+            trace->save(mTraceFilename);
+        } catch (const std::exception &e) {
+            std::cerr << "Could not save the frame trace: " << e.what() << std::endl;
+        }
+        mTraceFilename.clear();
+    }
 }
 
 bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
+    NANOGUI_TRACE_SCOPE("Widget::keyboardEvent");
     if (mFocusPath.size() > 0) {
         for (auto it = mFocusPath.rbegin() + 1; it != mFocusPath.rend(); ++it)
             if ((*it)->focused() && (*it)->keyboardEvent(key, scancode, action, modifiers))
@@ -465,6 +618,7 @@ bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
 }
 
 bool Screen::keyboardCharacterEvent(unsigned int codepoint) {
+    NANOGUI_TRACE_SCOPE("Widget::keyboardCharacterEvent");
     if (mFocusPath.size() > 0) {
         for (auto it = mFocusPath.rbegin() + 1; it != mFocusPath.rend(); ++it)
             if ((*it)->focused() && (*it)->keyboardCharacterEvent(codepoint))
@@ -482,6 +636,7 @@ bool Screen::resizeEvent(const Vector2i& size) {
 }
 
 bool Screen::cursorPosCallbackEvent(double x, double y) {
+    NANOGUI_TRACE_SCOPE("Screen::cursorPosCallbackEvent");
     Vector2i p((int) x, (int) y);
 
 #if defined(_WIN32) || defined(__linux__)
@@ -489,7 +644,7 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
 #endif
 
     bool ret = false;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = getTime();
     try {
         p -= Vector2i(1, 2);
 
@@ -500,13 +655,16 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
                 glfwSetCursor(mGLFWWindow, mCursors[(int) mCursor]);
             }
         } else {
+            NANOGUI_TRACE_SCOPE("Widget::mouseDragEvent");
             ret = mDragWidget->mouseDragEvent(
                 p - mDragWidget->parent()->absolutePosition(), p - mMousePos,
                 mMouseState, mModifiers);
         }
 
-        if (!ret)
+        if (!ret) {
+            NANOGUI_TRACE_SCOPE("Widget::mouseMotionEvent");
             ret = mouseMotionEvent(p, p - mMousePos, mMouseState, mModifiers);
+        }
 
         mMousePos = p;
 
@@ -518,12 +676,14 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
 }
 
 bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
+    NANOGUI_TRACE_SCOPE("Screen::mouseButtonCallbackEvent");
     mModifiers = modifiers;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = getTime();
     try {
         if (mFocusPath.size() > 1) {
-            const Window *window =
-                dynamic_cast<Window *>(mFocusPath[mFocusPath.size() - 2]);
+            const Widget *widget = mFocusPath[mFocusPath.size() - 2];
+            const Window *window = widget->hasKind(WindowKind)
+                ? static_cast<const Window *>(widget) : nullptr;
             if (window && window->modal()) {
                 if (!window->contains(mMousePos))
                     return false;
@@ -559,6 +719,7 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
             mDragWidget = nullptr;
         }
 
+        NANOGUI_TRACE_SCOPE("Widget::mouseButtonEvent");
         return mouseButtonEvent(mMousePos, button, action == GLFW_PRESS,
                                 mModifiers);
     } catch (const std::exception &e) {
@@ -568,7 +729,8 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
 }
 
 bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
-    mLastInteraction = glfwGetTime();
+    NANOGUI_TRACE_SCOPE("Screen::keyCallbackEvent");
+    mLastInteraction = getTime();
     try {
         return keyboardEvent(key, scancode, action, mods);
     } catch (const std::exception &e) {
@@ -578,7 +740,8 @@ bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
 }
 
 bool Screen::charCallbackEvent(unsigned int codepoint) {
-    mLastInteraction = glfwGetTime();
+    NANOGUI_TRACE_SCOPE("Screen::charCallbackEvent");
+    mLastInteraction = getTime();
     try {
         return keyboardCharacterEvent(codepoint);
     } catch (const std::exception &e) {
@@ -589,6 +752,7 @@ bool Screen::charCallbackEvent(unsigned int codepoint) {
 }
 
 bool Screen::dropCallbackEvent(int count, const char **filenames) {
+    NANOGUI_TRACE_SCOPE("Screen::dropCallbackEvent");
     std::vector<std::string> arg(count);
     for (int i = 0; i < count; ++i)
         arg[i] = filenames[i];
@@ -596,16 +760,19 @@ bool Screen::dropCallbackEvent(int count, const char **filenames) {
 }
 
 bool Screen::scrollCallbackEvent(double x, double y) {
-    mLastInteraction = glfwGetTime();
+    NANOGUI_TRACE_SCOPE("Screen::scrollCallbackEvent");
+    mLastInteraction = getTime();
     try {
         if (mFocusPath.size() > 1) {
-            const Window *window =
-                dynamic_cast<Window *>(mFocusPath[mFocusPath.size() - 2]);
+            const Widget *widget = mFocusPath[mFocusPath.size() - 2];
+            const Window *window = widget->hasKind(WindowKind)
+                ? static_cast<const Window *>(widget) : nullptr;
             if (window && window->modal()) {
                 if (!window->contains(mMousePos))
                     return false;
             }
         }
+        NANOGUI_TRACE_SCOPE("Widget::scrollEvent");
         return scrollEvent(mMousePos, Vector2f(x, y));
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what()
@@ -615,6 +782,7 @@ bool Screen::scrollCallbackEvent(double x, double y) {
 }
 
 bool Screen::resizeCallbackEvent(int, int) {
+    NANOGUI_TRACE_SCOPE("Screen::resizeCallbackEvent");
     Vector2i fbSize, size;
     glfwGetFramebufferSize(mGLFWWindow, &fbSize[0], &fbSize[1]);
     glfwGetWindowSize(mGLFWWindow, &size[0], &size[1]);
@@ -627,7 +795,7 @@ bool Screen::resizeCallbackEvent(int, int) {
         return false;
 
     mFBSize = fbSize; mSize = size;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = getTime();
 
     try {
         return resizeEvent(mSize);
@@ -638,6 +806,233 @@ bool Screen::resizeCallbackEvent(int, int) {
     }
 }
 
+void Screen::setEventCoalescing(bool value) {
+    if (!value)
+        processEvents();
+    mEventCoalescing = value;
+}
+
+void Screen::queueEvent(QueuedEvent::Type type, double x, double y,
+                        int arg0, int arg1, int arg2, int arg3) {
+#if defined(NANOGUI_TRACING)
+    if (tracing() && !mTraceInputStart)
+        mTraceInputStart = traceTimestamp();
+#endif
+
+    if (mEventRecorder) {
+        /* EventRecorder has no counterpart of QueuedEvent::Drop */
+        EventRecorder::EventType recordedType = type == QueuedEvent::Scroll
+            ? EventRecorder::EventType::Scroll : (EventRecorder::EventType) type;
+        mEventRecorder->record(recordedType, x, y, arg0, arg1, arg2, arg3);
+    }
+
+    /* Merge runs of motion and scroll events into a single event */
+    if (mEventCoalescing && !mEventQueue.empty() && mEventQueue.back().type == type) {
+        QueuedEvent &last = mEventQueue.back();
+        if (type == QueuedEvent::CursorPos) {
+            last.x = x; last.y = y;
+            return;
+        } else if (type == QueuedEvent::Scroll) {
+            last.x += x; last.y += y;
+            return;
+        }
+    }
+
+    QueuedEvent event;
+    event.type = type;
+    event.x = x; event.y = y;
+    event.arg[0] = arg0; event.arg[1] = arg1;
+    event.arg[2] = arg2; event.arg[3] = arg3;
+
+    /* Events are always queued while a rendering thread is active */
+    if (mEventCoalescing || mRenderThread) {
+        mEventQueue.push_back(std::move(event));
+    } else {
+        dispatchEvent(event);
+        tracePresentInput();
+    }
+}
+
+void Screen::tracePresentInput() {
+#if defined(NANOGUI_TRACING)
+    /* Keep the earliest input that has not been presented yet */
+    if (mTraceInputStart) {
+        uint64_t expected = 0;
+        mTracePresentStart.compare_exchange_strong(expected, mTraceInputStart);
+        mTraceInputStart = 0;
+    }
+#endif
+}
+
+void Screen::startRenderThread() {
+    if (mRenderThread)
+        return;
+
+    /* The context can only be current on one thread at a time */
+    if (glfwGetCurrentContext() == mGLFWWindow)
+        glfwMakeContextCurrent(nullptr);
+
+    mRenderThread.reset(new RenderThread());
+    updateWindowSize();
+
+    RenderThread *rt = mRenderThread.get();
+    rt->thread = std::thread([this, rt]() {
+#if defined(NANOGUI_TRACING)
+        setTraceThreadName("Render thread (" + mCaption + ")");
+#endif
+        {
+            /* Each thread blocks on the vsync of its own window only */
+            std::lock_guard<std::mutex> guard(rt->contextMutex);
+            glfwMakeContextCurrent(mGLFWWindow);
+            glfwSwapInterval(1);
+            glfwMakeContextCurrent(nullptr);
+        }
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(rt->signalMutex);
+                rt->signal.wait(lock, [rt] { return rt->frameRequested || rt->quit; });
+                if (rt->quit)
+                    break;
+                rt->frameRequested = false;
+            }
+
+            try {
+                FrameArena::thread().reset();
+                drawAll();
+            } catch (const std::exception &e) {
+                std::cerr << "Caught exception in rendering thread: " << e.what() << std::endl;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(rt->contextMutex);
+        glfwMakeContextCurrent(mGLFWWindow);
+        glfwSwapInterval(0);
+        glfwMakeContextCurrent(nullptr);
+    });
+}
+
+void Screen::stopRenderThread() {
+    if (!mRenderThread)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mRenderThread->signalMutex);
+        mRenderThread->quit = true;
+    }
+    mRenderThread->signal.notify_one();
+    mRenderThread->thread.join();
+    mRenderThread.reset();
+
+    /* Hand the context back to the main thread */
+    glfwMakeContextCurrent(mGLFWWindow);
+}
+
+void Screen::requestFrame() {
+    if (!mRenderThread)
+        return;
+    if (mRenderThread->lockDepth > 0) {
+        updateWindowSize();
+    } else {
+        /* Only the widget tree is needed here: don't wait for the rendering
+           thread to release the context, which it holds while swapping */
+        std::lock_guard<std::mutex> guard(mRenderThread->frameMutex);
+        updateWindowSize();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mRenderThread->signalMutex);
+        mRenderThread->frameRequested = true;
+    }
+    mRenderThread->signal.notify_one();
+}
+
+void Screen::lockWidgets() {
+    if (!mRenderThread || mRenderThread->lockDepth++ > 0)
+        return;
+    mRenderThread->frameMutex.lock();
+    mRenderThread->contextMutex.lock();
+    mRenderThread->previousContext = glfwGetCurrentContext();
+    glfwMakeContextCurrent(mGLFWWindow);
+}
+
+void Screen::unlockWidgets() {
+    if (!mRenderThread || --mRenderThread->lockDepth > 0)
+        return;
+    /* Give the context back before the rendering thread may claim it. Locks
+       of several screens nest, so the previous context is that of a screen
+       which is still locked (or has no rendering thread) */
+    glfwMakeContextCurrent(mRenderThread->previousContext);
+    mRenderThread->contextMutex.unlock();
+    mRenderThread->frameMutex.unlock();
+}
+
+ScreenLock::ScreenLock() {
+    mScreens.reserve(__nanogui_screens.size());
+    for (auto kv : __nanogui_screens) {
+        mScreens.push_back(kv.second);
+        kv.second->lockWidgets();
+    }
+}
+
+ScreenLock::~ScreenLock() {
+    for (auto it = mScreens.rbegin(); it != mScreens.rend(); ++it)
+        (*it)->unlockWidgets();
+}
+
+void Screen::dispatchEvent(const QueuedEvent &event) {
+    switch (event.type) {
+        case QueuedEvent::CursorPos:
+            cursorPosCallbackEvent(event.x, event.y);
+            break;
+        case QueuedEvent::MouseButton:
+            mouseButtonCallbackEvent(event.arg[0], event.arg[1], event.arg[2]);
+            break;
+        case QueuedEvent::Key:
+            keyCallbackEvent(event.arg[0], event.arg[1], event.arg[2], event.arg[3]);
+            break;
+        case QueuedEvent::Char:
+            charCallbackEvent((unsigned int) event.arg[0]);
+            break;
+        case QueuedEvent::Drop: {
+                std::vector<const char *> filenames;
+                for (const std::string &f : event.filenames)
+                    filenames.push_back(f.c_str());
+                dropCallbackEvent((int) filenames.size(), filenames.data());
+            }
+            break;
+        case QueuedEvent::Scroll:
+            scrollCallbackEvent(event.x, event.y);
+            break;
+    }
+}
+
+void Screen::recordFrame(const std::string &filename) {
+    mTraceFilename = filename;
+    scheduleRedraw();
+}
+
+void Screen::post(const std::function<void()> &func) {
+    if (mTaskQueue.push(func) && nanogui::active())
+        glfwPostEmptyEvent();
+}
+
+void Screen::processEvents() {
+    if (mEventQueue.empty() && mTaskQueue.empty())
+        return;
+    NANOGUI_TRACE_SCOPE("Screen::processEvents");
+    WidgetLockGuard guard(this);
+    mTaskQueue.run();
+    /* Handlers may cause further events to be queued; swap the queue out first */
+    std::vector<QueuedEvent> queue;
+    queue.swap(mEventQueue);
+    for (const QueuedEvent &event : queue)
+        dispatchEvent(event);
+    tracePresentInput();
+    if (mEventQueue.empty()) {
+        queue.clear();
+        mEventQueue.swap(queue); /* Reuse the allocation */
+    }
+}
+
 void Screen::updateFocus(Widget *widget) {
     for (auto w: mFocusPath) {
         if (!w->focused())
@@ -648,7 +1043,7 @@ void Screen::updateFocus(Widget *widget) {
     Widget *window = nullptr;
     while (widget) {
         mFocusPath.push_back(widget);
-        if (dynamic_cast<Window *>(widget))
+        if (widget->hasKind(WindowKind))
             window = widget;
         widget = widget->parent();
     }
@@ -669,6 +1064,7 @@ void Screen::disposeWindow(Window *window) {
 
 void Screen::centerWindow(Window *window) {
     if (window->size() == Vector2i::Zero()) {
+        loadThemeFonts();
         window->setSize(window->preferredSize(mNVGContext));
         window->performLayout(mNVGContext);
     }
@@ -676,25 +1072,59 @@ void Screen::centerWindow(Window *window) {
 }
 
 void Screen::moveWindowToFront(Window *window) {
-    mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), window), mChildren.end());
-    mChildren.push_back(window);
-    /* Brute force topological sort (no problem for a few windows..) */
-    bool changed = false;
-    do {
-        size_t baseIndex = 0;
-        for (size_t index = 0; index < mChildren.size(); ++index)
-            if (mChildren[index] == window)
-                baseIndex = index;
-        changed = false;
-        for (size_t index = 0; index < mChildren.size(); ++index) {
-            Popup *pw = dynamic_cast<Popup *>(mChildren[index]);
-            if (pw && pw->parentWindow() == window && index < baseIndex) {
-                moveWindowToFront(pw);
-                changed = true;
-                break;
-            }
-        }
-    } while (changed);
+    mZOrder.raise(window);
+    restackWindow(window);
+}
+
+void Screen::setWindowLayer(Window *window, int layer) {
+    mZOrder.setLayer(window, layer);
+    mZOrder.raise(window);
+    restackWindow(window);
+}
+
+void Screen::addChild(int index, Widget *widget) {
+    Widget::addChild(index, widget);
+
+    /* Windows created with the screen as parent are added by the constructor
+       of Widget, before they are known to be windows; their constructors call
+       trackWindow() and setPopupOwner() instead */
+    if (widget->hasKind(WindowKind))
+        trackWindow(static_cast<Window *>(widget));
+    if (widget->hasKind(PopupKind))
+        setPopupOwner(static_cast<Popup *>(widget), static_cast<Popup *>(widget)->parentWindow());
+}
+
+void Screen::removeChild(int index) {
+    Widget *widget = mChildren[index];
+    if (widget->hasKind(WindowKind))
+        mZOrder.remove(static_cast<Window *>(widget));
+    Widget::removeChild(index);
+}
+
+void Screen::trackWindow(Window *window) {
+    mZOrder.insert(window);
+    restackWindow(window);
+}
+
+void Screen::setPopupOwner(Popup *popup, Window *owner) {
+    mZOrder.setOwner(popup, owner);
+    mZOrder.raise(popup);
+    restackWindow(popup);
+}
+
+void Screen::restackWindow(Window *window) {
+    std::vector<Window *> group = mZOrder.group(window);
+    if (group.empty())
+        return;
+    auto member = [&](const Widget *w) {
+        return std::find(group.begin(), group.end(), w) != group.end();
+    };
+    mChildren.erase(std::remove_if(mChildren.begin(), mChildren.end(), member), mChildren.end());
+
+    /* Insert the group below the window that follows it, if any */
+    Window *above = mZOrder.above(group.back());
+    auto it = above ? std::find(mChildren.begin(), mChildren.end(), above) : mChildren.end();
+    mChildren.insert(it, group.begin(), group.end());
 }
 
 NAMESPACE_END(nanogui)
@@ -0,0 +1,940 @@
+/*
+    src/softwarerenderer.cpp -- NanoVG backend which rasterizes on the CPU
+    into a memory framebuffer
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/softwarerenderer.h>
+#include <nanogui/coroutine.h>
+#include <nanogui/resources.h>
+#include <nanogui/theme.h>
+#include <nanogui/widget.h>
+#include <nanovg.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define NANOGUI_SW_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define NANOGUI_SW_NEON 1
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Edge length of the square tiles that are rasterized independently */
+static const int TileSize = 64;
+
+struct SWTexture {
+    int width, height, type, flags;
+    std::vector<uint8_t> data;
+};
+
+/* Shader parameters of a draw call (cf. GLNVGfragUniforms in nanovg_gl.h),
+   with all matrices mapping framebuffer pixel centers */
+struct SWPaint {
+    float paintMat[6], scissorMat[6];
+    float extent[2], scissorExt[2], scissorScale[2];
+    float radius, feather, strokeMult;
+    float innerCol[4], outerCol[4];
+    const SWTexture *texture;
+    int texType; /* 0: premultiplied RGBA, 1: RGBA, 2: alpha */
+    bool solid, scissor, edgeAA;
+};
+
+struct SWPath {
+    int fillOffset, fillCount;
+    int strokeOffset, strokeCount;
+};
+
+struct SWCall {
+    enum Type { ConvexFill, Fill, Stroke, Triangles } type;
+    int pathOffset, pathCount;
+    int triangleOffset, triangleCount;
+    int bounds[4]; /* Affected pixels: x0, y0, x1, y1 (exclusive) */
+    SWPaint paint;
+    NVGcompositeOperationState blend;
+    bool sourceOver;
+};
+
+/* Pixel range x0..x1-1, y0..y1-1 within the tile whose top left corner is (ox, oy) */
+struct SWRect { int x0, y0, x1, y1, ox, oy; };
+
+/* Per-thread scratch buffers used while rasterizing a tile */
+struct SWTileBuffers {
+    float coverage[TileSize * TileSize];
+    int winding[TileSize * TileSize];
+
+    SWTileBuffers() {
+        std::fill(coverage, coverage + TileSize * TileSize, 0.f);
+        std::fill(winding, winding + TileSize * TileSize, 0);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+static void premultiply(float *out, const NVGcolor &c) {
+    out[0] = c.r * c.a; out[1] = c.g * c.a;
+    out[2] = c.b * c.a; out[3] = c.a;
+}
+
+/* Concatenate an affine transform with a scale applied to its input */
+static void scaleInput(float *m, float s) {
+    m[0] *= s; m[1] *= s; m[2] *= s; m[3] *= s;
+}
+
+static inline void transformPoint(const float *m, float x, float y, float &ox, float &oy) {
+    ox = m[0] * x + m[2] * y + m[4];
+    oy = m[1] * x + m[3] * y + m[5];
+}
+
+static inline float clamp01(float value) {
+    return std::min(std::max(value, 0.f), 1.f);
+}
+
+static inline float sdroundrect(float px, float py, float ex, float ey, float rad) {
+    float dx = std::abs(px) - (ex - rad), dy = std::abs(py) - (ey - rad);
+    float mx = std::max(dx, 0.f), my = std::max(dy, 0.f);
+    return std::min(std::max(dx, dy), 0.f) + std::sqrt(mx * mx + my * my) - rad;
+}
+
+static inline float scissorMask(const SWPaint &p, float x, float y) {
+    if (!p.scissor)
+        return 1.f;
+    float sx, sy;
+    transformPoint(p.scissorMat, x, y, sx, sy);
+    sx = 0.5f - (std::abs(sx) - p.scissorExt[0]) * p.scissorScale[0];
+    sy = 0.5f - (std::abs(sy) - p.scissorExt[1]) * p.scissorScale[1];
+    return clamp01(sx) * clamp01(sy);
+}
+
+static inline float strokeMask(const SWPaint &p, float u, float v) {
+    if (!p.edgeAA)
+        return 1.f;
+    return std::min(1.f, (1.f - std::abs(u * 2.f - 1.f)) * p.strokeMult) * std::min(1.f, v);
+}
+
+/* Bilinear (or nearest neighbor) lookup with OpenGL texture coordinate conventions */
+static void sampleTexture(const SWTexture &tex, int texType, float u, float v, float *out) {
+    auto wrap = [](int i, int size, bool repeat) {
+        if (repeat) {
+            i %= size;
+            return i < 0 ? i + size : i;
+        }
+        return std::min(std::max(i, 0), size - 1);
+    };
+    bool repeatX = tex.flags & NVG_IMAGE_REPEATX, repeatY = tex.flags & NVG_IMAGE_REPEATY;
+    int channels = tex.type == NVG_TEXTURE_RGBA ? 4 : 1;
+
+    auto fetch = [&](int x, int y, float *texel) {
+        const uint8_t *ptr = tex.data.data() +
+            ((size_t) wrap(y, tex.height, repeatY) * tex.width + wrap(x, tex.width, repeatX)) * channels;
+        for (int i = 0; i < channels; ++i)
+            texel[i] = ptr[i] * (1.f / 255.f);
+    };
+
+    float texel[4] = { 0.f, 0.f, 0.f, 0.f };
+    float x = u * tex.width - 0.5f, y = v * tex.height - 0.5f;
+    if (tex.flags & NVG_IMAGE_NEAREST) {
+        fetch((int) std::floor(x + 0.5f), (int) std::floor(y + 0.5f), texel);
+    } else {
+        float fx = std::floor(x), fy = std::floor(y);
+        float tx = x - fx, ty = y - fy;
+        int ix = (int) fx, iy = (int) fy;
+        float t00[4], t10[4], t01[4], t11[4];
+        fetch(ix, iy, t00); fetch(ix + 1, iy, t10);
+        fetch(ix, iy + 1, t01); fetch(ix + 1, iy + 1, t11);
+        for (int i = 0; i < channels; ++i)
+            texel[i] = (t00[i] * (1 - tx) + t10[i] * tx) * (1 - ty) +
+                       (t01[i] * (1 - tx) + t11[i] * tx) * ty;
+    }
+
+    if (texType == 2) {
+        out[0] = out[1] = out[2] = out[3] = texel[0];
+    } else if (texType == 1) {
+        out[0] = texel[0] * texel[3]; out[1] = texel[1] * texel[3];
+        out[2] = texel[2] * texel[3]; out[3] = texel[3];
+    } else {
+        memcpy(out, texel, sizeof(float) * 4);
+    }
+}
+
+/* Evaluate the paint (gradient or image pattern) at a framebuffer location */
+static void evalPaint(const SWPaint &p, float x, float y, float *out) {
+    if (p.solid) {
+        memcpy(out, p.innerCol, sizeof(float) * 4);
+        return;
+    }
+    float px, py;
+    transformPoint(p.paintMat, x, y, px, py);
+    if (p.texture) {
+        float u = px / p.extent[0], v = py / p.extent[1];
+        if (p.texture->flags & NVG_IMAGE_FLIPY)
+            v = 1.f - v;
+        sampleTexture(*p.texture, p.texType, u, v, out);
+        for (int i = 0; i < 4; ++i)
+            out[i] *= p.innerCol[i];
+    } else {
+        float d = clamp01((sdroundrect(px, py, p.extent[0], p.extent[1], p.radius) +
+                           p.feather * 0.5f) / p.feather);
+        for (int i = 0; i < 4; ++i)
+            out[i] = p.innerCol[i] * (1.f - d) + p.outerCol[i] * d;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+/* Source-over blending of a premultiplied color (scaled by 'alpha') */
+static inline void blendOver(uint32_t *dst, const float *color, float alpha) {
+#if defined(NANOGUI_SW_SSE2)
+    __m128 src = _mm_mul_ps(_mm_loadu_ps(color), _mm_set1_ps(alpha * 255.f));
+    __m128 inv = _mm_set1_ps(1.f - color[3] * alpha);
+    __m128i zero = _mm_setzero_si128();
+    __m128i d = _mm_cvtsi32_si128((int) *dst);
+    d = _mm_unpacklo_epi16(_mm_unpacklo_epi8(d, zero), zero);
+    __m128 result = _mm_add_ps(src, _mm_mul_ps(_mm_cvtepi32_ps(d), inv));
+    __m128i r = _mm_cvtps_epi32(result);
+    r = _mm_packs_epi32(r, r);
+    r = _mm_packus_epi16(r, r);
+    *dst = (uint32_t) _mm_cvtsi128_si32(r);
+#elif defined(NANOGUI_SW_NEON)
+    float32x4_t src = vmulq_n_f32(vld1q_f32(color), alpha * 255.f);
+    uint16x8_t d16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(*dst)));
+    float32x4_t d = vcvtq_f32_u32(vmovl_u16(vget_low_u16(d16)));
+    float32x4_t result = vmlaq_n_f32(src, d, 1.f - color[3] * alpha);
+    uint32x4_t r = vcvtq_u32_f32(vaddq_f32(result, vdupq_n_f32(0.5f)));
+    uint16x4_t r16 = vqmovn_u32(r);
+    uint8x8_t r8 = vqmovn_u16(vcombine_u16(r16, r16));
+    *dst = vget_lane_u32(vreinterpret_u32_u8(r8), 0);
+#else
+    uint8_t *d = (uint8_t *) dst;
+    float inv = 1.f - color[3] * alpha;
+    for (int i = 0; i < 4; ++i) {
+        float value = color[i] * alpha * 255.f + d[i] * inv;
+        d[i] = (uint8_t) std::min(std::max(value + 0.5f, 0.f), 255.f);
+    }
+#endif
+}
+
+static inline float blendFactor(int factor, const float *src, const float *dst, int channel) {
+    switch (factor) {
+        case NVG_ZERO: return 0.f;
+        case NVG_ONE: return 1.f;
+        case NVG_SRC_COLOR: return src[channel];
+        case NVG_ONE_MINUS_SRC_COLOR: return 1.f - src[channel];
+        case NVG_DST_COLOR: return dst[channel];
+        case NVG_ONE_MINUS_DST_COLOR: return 1.f - dst[channel];
+        case NVG_SRC_ALPHA: return src[3];
+        case NVG_ONE_MINUS_SRC_ALPHA: return 1.f - src[3];
+        case NVG_DST_ALPHA: return dst[3];
+        case NVG_ONE_MINUS_DST_ALPHA: return 1.f - dst[3];
+        case NVG_SRC_ALPHA_SATURATE:
+            return channel == 3 ? 1.f : std::min(src[3], 1.f - dst[3]);
+        default: return 0.f;
+    }
+}
+
+/* Blending with arbitrary factors (see nvgGlobalCompositeBlendFuncSeparate()) */
+static void blendGeneric(uint32_t *dst, const float *color, float alpha,
+                         const NVGcompositeOperationState &op) {
+    uint8_t *d = (uint8_t *) dst;
+    float src[4], dstf[4];
+    for (int i = 0; i < 4; ++i) {
+        src[i] = color[i] * alpha;
+        dstf[i] = d[i] * (1.f / 255.f);
+    }
+    for (int i = 0; i < 4; ++i) {
+        int sf = i < 3 ? op.srcRGB : op.srcAlpha, df = i < 3 ? op.dstRGB : op.dstAlpha;
+        float value = src[i] * blendFactor(sf, src, dstf, i) +
+                      dstf[i] * blendFactor(df, src, dstf, i);
+        d[i] = (uint8_t) (clamp01(value) * 255.f + 0.5f);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Invoke 'shade(index, x, y, u, v)' for all pixel centers within 'clip' that
+ * are covered by the triangle (a, b, c) in framebuffer coordinates. Shared
+ * edges are only rasterized once (top-left rule), which keeps the winding
+ * numbers of triangle fans exact. Returns the orientation of the triangle.
+ */
+template <typename Func>
+static int rasterTriangle(const NVGvertex &a, const NVGvertex &b, const NVGvertex &c,
+                          const SWRect &clip, const Func &shade) {
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area == 0.f || !std::isfinite(area))
+        return 0;
+
+    const NVGvertex *v[3] = { &a, &b, &c };
+    int sign = 1;
+    if (area < 0) {
+        std::swap(v[1], v[2]);
+        area = -area;
+        sign = -1;
+    }
+
+    int x0 = std::max(clip.x0, (int) std::floor(std::min({ a.x, b.x, c.x }) - 0.5f));
+    int x1 = std::min(clip.x1, (int) std::ceil(std::max({ a.x, b.x, c.x }) + 0.5f));
+    int y0 = std::max(clip.y0, (int) std::floor(std::min({ a.y, b.y, c.y }) - 0.5f));
+    int y1 = std::min(clip.y1, (int) std::ceil(std::max({ a.y, b.y, c.y }) + 0.5f));
+    if (x0 >= x1 || y0 >= y1)
+        return sign;
+
+    /* Edge i lies opposite of vertex i. Each edge function is evaluated with
+       the endpoints in a canonical order and negated if necessary, so that
+       triangles sharing an edge compute bitwise identical values for it */
+    struct Edge { float px, py, dx, dy; bool negate, topLeft; } edges[3];
+    for (int i = 0; i < 3; ++i) {
+        const NVGvertex *p = v[(i + 1) % 3], *q = v[(i + 2) % 3];
+        Edge &e = edges[i];
+        float dx = q->x - p->x, dy = q->y - p->y;
+        e.topLeft = dy < 0 || (dy == 0 && dx > 0);
+        e.negate = !(p->y < q->y || (p->y == q->y && p->x < q->x));
+        if (e.negate)
+            std::swap(p, q);
+        e.px = p->x; e.py = p->y;
+        e.dx = q->x - p->x; e.dy = q->y - p->y;
+    }
+
+    float invArea = 1.f / area;
+    for (int y = y0; y < y1; ++y) {
+        float py = y + 0.5f;
+
+        /* Conservatively determine the span of this row, then test exactly */
+        float rowTerm[3];
+        float spanMin = (float) x0, spanMax = (float) (x1 - 1);
+        bool empty = false;
+        for (int i = 0; i < 3; ++i) {
+            const Edge &e = edges[i];
+            rowTerm[i] = e.dx * (py - e.py);
+            /* E(px) = rowTerm - dy * (px - x0) with the sign applied; solve E(px) = 0 */
+            float dy = e.negate ? -e.dy : e.dy, rt = e.negate ? -rowTerm[i] : rowTerm[i];
+            if (dy < 0)
+                spanMin = std::max(spanMin, std::floor(e.px + rt / dy - 0.5f) - 1.f);
+            else if (dy > 0)
+                spanMax = std::min(spanMax, std::ceil(e.px + rt / dy - 0.5f) + 1.f);
+            else if (rt < 0 || (rt == 0 && !e.topLeft))
+                empty = true;
+        }
+        if (empty || spanMin > spanMax)
+            continue;
+
+        int sx0 = (int) spanMin, sx1 = (int) spanMax;
+        int index = (y - clip.oy) * TileSize + (sx0 - clip.ox);
+
+        for (int x = sx0; x <= sx1; ++x, ++index) {
+            float px = x + 0.5f, w[3];
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; ++i) {
+                const Edge &e = edges[i];
+                float value = rowTerm[i] - e.dy * (px - e.px);
+                if (e.negate)
+                    value = -value;
+                inside = value > 0 || (value == 0 && e.topLeft);
+                w[i] = value * invArea;
+            }
+            if (inside)
+                shade(index, x, y,
+                      w[0] * v[0]->u + w[1] * v[1]->u + w[2] * v[2]->u,
+                      w[0] * v[0]->v + w[1] * v[1]->v + w[2] * v[2]->v);
+        }
+    }
+    return sign;
+}
+
+template <typename Func>
+static void rasterFan(const NVGvertex *verts, int count, const SWRect &clip, const Func &shade) {
+    for (int i = 2; i < count; ++i) {
+        const NVGvertex &a = verts[0], &b = verts[i - 1], &c = verts[i];
+        int sign = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) > 0 ? 1 : -1;
+        rasterTriangle(a, b, c, clip,
+            [&](int index, int, int, float, float) { shade(index, sign); });
+    }
+}
+
+template <typename Func>
+static void rasterStrip(const NVGvertex *verts, int count, const SWRect &clip, const Func &shade) {
+    for (int i = 2; i < count; ++i)
+        rasterTriangle(verts[i - 2], verts[i - 1], verts[i], clip, shade);
+}
+
+// ----------------------------------------------------------------------------
+
+struct SoftwareRenderer::Backend {
+    std::vector<uint32_t> framebuffer;
+    int width = 0, height = 0;
+    float scale = 1.f;          /* Framebuffer pixels per NanoVG unit */
+    bool antialias = true;
+    int threadCount = 0;
+    double rasterTime = 0;
+
+    std::map<int, std::unique_ptr<SWTexture>> textures;
+    std::vector<std::unique_ptr<SWTexture>> deletedTextures;
+    int textureId = 0;
+
+    std::vector<SWCall> calls;
+    std::vector<SWPath> paths;
+    std::vector<NVGvertex> verts;
+
+    int createTexture(int type, int w, int h, int imageFlags, const unsigned char *data) {
+        std::unique_ptr<SWTexture> tex(new SWTexture());
+        tex->width = w;
+        tex->height = h;
+        tex->type = type;
+        tex->flags = imageFlags;
+        size_t bytes = (size_t) w * h * (type == NVG_TEXTURE_RGBA ? 4 : 1);
+        if (data)
+            tex->data.assign(data, data + bytes);
+        else
+            tex->data.resize(bytes, 0);
+        textures[++textureId] = std::move(tex);
+        return textureId;
+    }
+
+    int deleteTexture(int image) {
+        auto it = textures.find(image);
+        if (it == textures.end())
+            return 0;
+        /* Pending draw calls may still reference the texture */
+        deletedTextures.push_back(std::move(it->second));
+        textures.erase(it);
+        return 1;
+    }
+
+    int updateTexture(int image, int x, int y, int w, int h, const unsigned char *data) {
+        SWTexture *tex = findTexture(image);
+        if (!tex)
+            return 0;
+        /* Like glTexSubImage2D with GL_UNPACK_ROW_LENGTH: 'data' is the whole image */
+        int channels = tex->type == NVG_TEXTURE_RGBA ? 4 : 1;
+        for (int row = y; row < y + h; ++row) {
+            size_t offset = ((size_t) row * tex->width + x) * channels;
+            memcpy(tex->data.data() + offset, data + offset, (size_t) w * channels);
+        }
+        return 1;
+    }
+
+    SWTexture *findTexture(int id) {
+        auto it = textures.find(id);
+        return it == textures.end() ? nullptr : it->second.get();
+    }
+
+    /* Append vertices, converting them to framebuffer coordinates */
+    int addVertices(const NVGvertex *v, int count) {
+        int offset = (int) verts.size();
+        for (int i = 0; i < count; ++i)
+            verts.push_back(NVGvertex{ v[i].x * scale, v[i].y * scale, v[i].u, v[i].v });
+        return offset;
+    }
+
+    /* Counterpart of glnvg__convertPaint() */
+    void convertPaint(SWPaint &p, const NVGpaint *paint, const NVGscissor *scissor,
+                      float width, float fringe) {
+        premultiply(p.innerCol, paint->innerColor);
+        premultiply(p.outerCol, paint->outerColor);
+
+        p.scissor = scissor->extent[0] >= -0.5f && scissor->extent[1] >= -0.5f;
+        if (p.scissor) {
+            nvgTransformInverse(p.scissorMat, scissor->xform);
+            scaleInput(p.scissorMat, 1.f / scale);
+            p.scissorExt[0] = scissor->extent[0];
+            p.scissorExt[1] = scissor->extent[1];
+            p.scissorScale[0] = std::sqrt(scissor->xform[0] * scissor->xform[0] +
+                                          scissor->xform[2] * scissor->xform[2]) / fringe;
+            p.scissorScale[1] = std::sqrt(scissor->xform[1] * scissor->xform[1] +
+                                          scissor->xform[3] * scissor->xform[3]) / fringe;
+        }
+
+        p.extent[0] = paint->extent[0];
+        p.extent[1] = paint->extent[1];
+        p.strokeMult = (width * 0.5f + fringe * 0.5f) / fringe;
+        p.edgeAA = antialias;
+        p.texture = nullptr;
+        p.texType = 0;
+        p.radius = paint->radius;
+        p.feather = paint->feather;
+
+        float invxform[6];
+        if (paint->image != 0) {
+            p.texture = findTexture(paint->image);
+            if (p.texture) {
+                if (p.texture->type == NVG_TEXTURE_RGBA)
+                    p.texType = (p.texture->flags & NVG_IMAGE_PREMULTIPLIED) ? 0 : 1;
+                else
+                    p.texType = 2;
+            }
+        }
+        nvgTransformInverse(invxform, paint->xform);
+        memcpy(p.paintMat, invxform, sizeof(invxform));
+        scaleInput(p.paintMat, 1.f / scale);
+
+        p.solid = paint->image == 0 &&
+                  memcmp(p.innerCol, p.outerCol, sizeof(p.innerCol)) == 0;
+        if (paint->image != 0 && !p.texture) {
+            /* Missing texture: draw nothing, like an incomplete GL texture */
+            p.solid = true;
+            std::fill(p.innerCol, p.innerCol + 4, 0.f);
+        }
+    }
+
+    /* Restrict the bounds of a call to the framebuffer and scissor rectangle */
+    void setBounds(SWCall &call, float x0, float y0, float x1, float y1,
+                   const NVGscissor *scissor) {
+        if (scissor->extent[0] >= -0.5f && scissor->extent[1] >= -0.5f) {
+            const float *m = scissor->xform;
+            float ex = std::abs(m[0]) * scissor->extent[0] + std::abs(m[2]) * scissor->extent[1];
+            float ey = std::abs(m[1]) * scissor->extent[0] + std::abs(m[3]) * scissor->extent[1];
+            x0 = std::max(x0, (m[4] - ex) * scale - 1.f);
+            y0 = std::max(y0, (m[5] - ey) * scale - 1.f);
+            x1 = std::min(x1, (m[4] + ex) * scale + 1.f);
+            y1 = std::min(y1, (m[5] + ey) * scale + 1.f);
+        }
+        call.bounds[0] = std::max(0, (int) std::floor(x0 - 1.f));
+        call.bounds[1] = std::max(0, (int) std::floor(y0 - 1.f));
+        call.bounds[2] = std::min(width, (int) std::ceil(x1 + 1.f));
+        call.bounds[3] = std::min(height, (int) std::ceil(y1 + 1.f));
+    }
+
+    void boundsOf(int offset, int count, float &x0, float &y0, float &x1, float &y1) {
+        for (int i = offset; i < offset + count; ++i) {
+            x0 = std::min(x0, verts[i].x); y0 = std::min(y0, verts[i].y);
+            x1 = std::max(x1, verts[i].x); y1 = std::max(y1, verts[i].y);
+        }
+    }
+
+    void addCall(SWCall &call, const NVGcompositeOperationState &op) {
+        call.blend = op;
+        call.sourceOver = op.srcRGB == NVG_ONE && op.srcAlpha == NVG_ONE &&
+                          op.dstRGB == NVG_ONE_MINUS_SRC_ALPHA &&
+                          op.dstAlpha == NVG_ONE_MINUS_SRC_ALPHA;
+        if (call.bounds[0] < call.bounds[2] && call.bounds[1] < call.bounds[3])
+            calls.push_back(call);
+    }
+
+    void fill(const NVGpaint *paint, NVGcompositeOperationState op, const NVGscissor *scissor,
+              float fringe, const float *bounds, const NVGpath *npaths, int npathCount) {
+        SWCall call;
+        call.type = (npathCount == 1 && npaths[0].convex) ? SWCall::ConvexFill : SWCall::Fill;
+        call.pathOffset = (int) paths.size();
+        call.pathCount = npathCount;
+        call.triangleOffset = call.triangleCount = 0;
+        for (int i = 0; i < npathCount; ++i) {
+            const NVGpath &path = npaths[i];
+            SWPath p;
+            p.fillOffset = addVertices(path.fill, path.nfill);
+            p.fillCount = path.nfill;
+            p.strokeOffset = addVertices(path.stroke, path.nstroke);
+            p.strokeCount = antialias ? path.nstroke : 0;
+            paths.push_back(p);
+        }
+        convertPaint(call.paint, paint, scissor, fringe, fringe);
+        setBounds(call, bounds[0] * scale, bounds[1] * scale,
+                  bounds[2] * scale, bounds[3] * scale, scissor);
+        addCall(call, op);
+    }
+
+    void stroke(const NVGpaint *paint, NVGcompositeOperationState op, const NVGscissor *scissor,
+                float fringe, float strokeWidth, const NVGpath *npaths, int npathCount) {
+        SWCall call;
+        call.type = SWCall::Stroke;
+        call.pathOffset = (int) paths.size();
+        call.pathCount = npathCount;
+        call.triangleOffset = call.triangleCount = 0;
+        float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+        for (int i = 0; i < npathCount; ++i) {
+            const NVGpath &path = npaths[i];
+            SWPath p;
+            p.fillOffset = p.fillCount = 0;
+            p.strokeOffset = addVertices(path.stroke, path.nstroke);
+            p.strokeCount = path.nstroke;
+            boundsOf(p.strokeOffset, p.strokeCount, x0, y0, x1, y1);
+            paths.push_back(p);
+        }
+        convertPaint(call.paint, paint, scissor, strokeWidth, fringe);
+        setBounds(call, x0, y0, x1, y1, scissor);
+        addCall(call, op);
+    }
+
+    void triangles(const NVGpaint *paint, NVGcompositeOperationState op, const NVGscissor *scissor,
+                   const NVGvertex *v, int count, float fringe) {
+        SWCall call;
+        call.type = SWCall::Triangles;
+        call.pathOffset = call.pathCount = 0;
+        call.triangleOffset = addVertices(v, count);
+        call.triangleCount = count;
+        convertPaint(call.paint, paint, scissor, 1.f, fringe);
+        /* Texture coordinates come from the vertices; only the color is used */
+        call.paint.solid = true;
+        float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+        boundsOf(call.triangleOffset, count, x0, y0, x1, y1);
+        setBounds(call, x0, y0, x1, y1, scissor);
+        addCall(call, op);
+    }
+
+    inline void blend(const SWCall &call, uint32_t *dst, const float *color, float alpha) {
+        if (call.sourceOver)
+            blendOver(dst, color, alpha);
+        else
+            blendGeneric(dst, color, alpha, call.blend);
+    }
+
+    /* Rasterize a single call into 'tile'. Nothing outside of the call's
+       bounds is touched, which keeps the scratch buffers clean */
+    void rasterCall(const SWCall &call, const SWRect &tile, SWTileBuffers &buf) {
+        SWRect clip = tile;
+        clip.x0 = std::max(tile.x0, call.bounds[0]); clip.x1 = std::min(tile.x1, call.bounds[2]);
+        clip.y0 = std::max(tile.y0, call.bounds[1]); clip.y1 = std::min(tile.y1, call.bounds[3]);
+        const SWPaint &paint = call.paint;
+        float *cov = buf.coverage;
+        int *wind = buf.winding;
+
+        if (call.type == SWCall::Triangles) {
+            const NVGvertex *v = verts.data() + call.triangleOffset;
+            for (int i = 0; i + 2 < call.triangleCount; i += 3) {
+                rasterTriangle(v[i], v[i + 1], v[i + 2], clip,
+                    [&](int, int x, int y, float u, float tv) {
+                        float color[4] = { 1.f, 1.f, 1.f, 1.f };
+                        if (paint.texture)
+                            sampleTexture(*paint.texture, paint.texType, u, tv, color);
+                        float alpha = scissorMask(paint, x + 0.5f, y + 0.5f);
+                        if (alpha <= 0.f)
+                            return;
+                        for (int k = 0; k < 4; ++k)
+                            color[k] *= paint.innerCol[k];
+                        blend(call, framebuffer.data() + (size_t) y * width + x, color, alpha);
+                    });
+            }
+            return;
+        }
+
+        auto fringe = [&](int index, int, int, float u, float v) {
+            cov[index] = std::max(cov[index], strokeMask(paint, u, v));
+        };
+
+        for (int i = 0; i < call.pathCount; ++i) {
+            const SWPath &path = paths[call.pathOffset + i];
+            const NVGvertex *fillVerts = verts.data() + path.fillOffset;
+            const NVGvertex *strokeVerts = verts.data() + path.strokeOffset;
+
+            switch (call.type) {
+                case SWCall::ConvexFill:
+                    rasterFan(fillVerts, path.fillCount, clip,
+                              [&](int index, int) { cov[index] = 1.f; });
+                    rasterStrip(strokeVerts, path.strokeCount, clip, fringe);
+                    break;
+
+                case SWCall::Fill:
+                    /* Accumulate winding numbers like the stencil pass of the GL backend */
+                    rasterFan(fillVerts, path.fillCount, clip,
+                              [&](int index, int sign) { wind[index] += sign; });
+                    break;
+
+                case SWCall::Stroke:
+                    rasterStrip(strokeVerts, path.strokeCount, clip, fringe);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (call.type == SWCall::Fill) {
+            /* Anti-aliased fringes only affect pixels outside of the shape */
+            for (int i = 0; i < call.pathCount; ++i) {
+                const SWPath &path = paths[call.pathOffset + i];
+                rasterStrip(verts.data() + path.strokeOffset, path.strokeCount, clip,
+                    [&](int index, int x, int y, float u, float v) {
+                        if (wind[index] == 0)
+                            fringe(index, x, y, u, v);
+                    });
+            }
+        }
+
+        /* Resolve coverage, shade and blend, and reset the scratch buffers */
+        bool fillWinding = call.type == SWCall::Fill;
+        float color[4];
+        if (paint.solid)
+            memcpy(color, paint.innerCol, sizeof(color));
+
+        for (int y = clip.y0; y < clip.y1; ++y) {
+            int index = (y - clip.oy) * TileSize + (clip.x0 - clip.ox);
+            uint32_t *dst = framebuffer.data() + (size_t) y * width + clip.x0;
+            for (int x = clip.x0; x < clip.x1; ++x, ++index, ++dst) {
+                float c = cov[index];
+                if (fillWinding && wind[index] != 0) {
+                    c = 1.f;
+                    wind[index] = 0;
+                }
+                if (c <= 0.f)
+                    continue;
+                cov[index] = 0.f;
+
+                float px = x + 0.5f, py = y + 0.5f;
+                float alpha = c * scissorMask(paint, px, py);
+                if (alpha <= 0.f)
+                    continue;
+                if (!paint.solid)
+                    evalPaint(paint, px, py, color);
+                blend(call, dst, color, alpha);
+            }
+        }
+    }
+
+    void rasterTile(int tile, SWTileBuffers &buf) {
+        int tilesX = (width + TileSize - 1) / TileSize;
+        SWRect clip;
+        clip.x0 = (tile % tilesX) * TileSize;
+        clip.y0 = (tile / tilesX) * TileSize;
+        clip.x1 = std::min(clip.x0 + TileSize, width);
+        clip.y1 = std::min(clip.y0 + TileSize, height);
+        clip.ox = clip.x0;
+        clip.oy = clip.y0;
+
+        for (const SWCall &call : calls) {
+            if (call.bounds[0] >= clip.x1 || call.bounds[2] <= clip.x0 ||
+                call.bounds[1] >= clip.y1 || call.bounds[3] <= clip.y0)
+                continue;
+            rasterCall(call, clip, buf);
+        }
+    }
+
+    /* Tiles are independent; the calling thread and helper jobs on the worker
+       pool take them from a shared counter until none are left */
+    struct FlushJob {
+        Backend *backend;
+        int tileCount;
+        std::atomic<int> nextTile { 0 };
+        std::mutex mutex;
+        std::condition_variable cond;
+        int active = 0;
+        bool closed = false;
+
+        void work() {
+            std::unique_ptr<SWTileBuffers> buf(new SWTileBuffers());
+            int tile;
+            while ((tile = nextTile.fetch_add(1)) < tileCount)
+                backend->rasterTile(tile, *buf);
+        }
+    };
+
+    void flush() {
+        auto start = std::chrono::steady_clock::now();
+        int tileCount = ((width + TileSize - 1) / TileSize) *
+                        ((height + TileSize - 1) / TileSize);
+
+        if (!calls.empty() && tileCount > 0) {
+            int threads = threadCount > 0 ? threadCount
+                                          : (int) std::max(std::thread::hardware_concurrency(), 1u);
+            threads = std::min(threads, tileCount);
+
+            auto job = std::make_shared<FlushJob>();
+            job->backend = this;
+            job->tileCount = tileCount;
+
+            for (int i = 1; i < threads; ++i) {
+                background([job] {
+                    {
+                        std::lock_guard<std::mutex> guard(job->mutex);
+                        if (job->closed)
+                            return;
+                        job->active++;
+                    }
+                    job->work();
+                    std::lock_guard<std::mutex> guard(job->mutex);
+                    if (--job->active == 0)
+                        job->cond.notify_all();
+                });
+            }
+
+            /* Helpers that have not started yet when the calling thread is
+               done are not waited for; they find the job closed */
+            job->work();
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->closed = true;
+            job->cond.wait(lock, [&] { return job->active == 0; });
+        }
+
+        rasterTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        reset();
+    }
+
+    void reset() {
+        calls.clear();
+        paths.clear();
+        verts.clear();
+        deletedTextures.clear();
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+SoftwareRenderer::SoftwareRenderer(const Vector2i &size, float pixelRatio,
+                                   int threadCount, bool antialias)
+    : mBackend(new Backend()), mNVGContext(nullptr), mThreadCount(threadCount) {
+    mBackend->antialias = antialias;
+    mBackend->threadCount = threadCount;
+    setSize(size, pixelRatio);
+
+    NVGparams params;
+    memset(&params, 0, sizeof(params));
+    params.userPtr = mBackend.get();
+    params.edgeAntiAlias = antialias ? 1 : 0;
+
+    params.renderCreate = [](void *) { return 1; };
+
+    params.renderCreateTexture = [](void *uptr, int type, int w, int h, int imageFlags,
+                                    const unsigned char *data) {
+        return ((Backend *) uptr)->createTexture(type, w, h, imageFlags, data);
+    };
+
+    params.renderDeleteTexture = [](void *uptr, int image) {
+        return ((Backend *) uptr)->deleteTexture(image);
+    };
+
+    params.renderUpdateTexture = [](void *uptr, int image, int x, int y, int w, int h,
+                                    const unsigned char *data) {
+        return ((Backend *) uptr)->updateTexture(image, x, y, w, h, data);
+    };
+
+    params.renderGetTextureSize = [](void *uptr, int image, int *w, int *h) {
+        SWTexture *tex = ((Backend *) uptr)->findTexture(image);
+        if (!tex)
+            return 0;
+        *w = tex->width;
+        *h = tex->height;
+        return 1;
+    };
+
+    params.renderViewport = [](void *uptr, float width, float, float) {
+        Backend *backend = (Backend *) uptr;
+        if (width > 0)
+            backend->scale = backend->width / width;
+    };
+
+    params.renderCancel = [](void *uptr) { ((Backend *) uptr)->reset(); };
+    params.renderFlush = [](void *uptr) { ((Backend *) uptr)->flush(); };
+
+    params.renderFill = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                           NVGscissor *scissor, float fringe, const float *bounds,
+                           const NVGpath *paths, int npaths) {
+        ((Backend *) uptr)->fill(paint, op, scissor, fringe, bounds, paths, npaths);
+    };
+
+    params.renderStroke = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                             NVGscissor *scissor, float fringe, float strokeWidth,
+                             const NVGpath *paths, int npaths) {
+        ((Backend *) uptr)->stroke(paint, op, scissor, fringe, strokeWidth, paths, npaths);
+    };
+
+    params.renderTriangles = [](void *uptr, NVGpaint *paint, NVGcompositeOperationState op,
+                                NVGscissor *scissor, const NVGvertex *verts, int nverts,
+                                float fringe) {
+        ((Backend *) uptr)->triangles(paint, op, scissor, verts, nverts, fringe);
+    };
+
+    /* The backend is owned by the SoftwareRenderer instance */
+    params.renderDelete = [](void *) { };
+
+    mNVGContext = nvgCreateInternal(&params);
+    if (mNVGContext == nullptr)
+        throw std::runtime_error("Could not initialize NanoVG!");
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    if (mNVGContext)
+        nvgDeleteInternal(mNVGContext);
+}
+
+void SoftwareRenderer::setSize(const Vector2i &size, float pixelRatio) {
+    mSize = size;
+    mPixelRatio = pixelRatio;
+    mFBSize = (size.cast<float>() * pixelRatio).cast<int>();
+    mBackend->width = mFBSize.x();
+    mBackend->height = mFBSize.y();
+    mBackend->scale = pixelRatio;
+    mBackend->framebuffer.resize((size_t) mFBSize.prod());
+}
+
+void SoftwareRenderer::setThreadCount(int threadCount) {
+    mThreadCount = threadCount;
+    mBackend->threadCount = threadCount;
+}
+
+void SoftwareRenderer::clear(const Color &color) {
+    uint8_t rgba[4];
+    for (int i = 0; i < 4; ++i) {
+        float value = i < 3 ? color[i] * color.w() : color.w();
+        rgba[i] = (uint8_t) (clamp01(value) * 255.f + 0.5f);
+    }
+    uint32_t pixel;
+    memcpy(&pixel, rgba, sizeof(pixel));
+    std::fill(mBackend->framebuffer.begin(), mBackend->framebuffer.end(), pixel);
+}
+
+void SoftwareRenderer::render(Widget *widget, const Color &background) {
+    clear(background);
+    /* Register the fonts in the same order as Theme::loadFonts(), so that
+       font ids looked up in a GL context also work here */
+    createFontResource(mNVGContext, "sans", "roboto_regular_ttf");
+    createFontResource(mNVGContext, "sans-bold", "roboto_bold_ttf");
+    createFontResource(mNVGContext, "icons", "entypo_ttf");
+    if (widget->theme())
+        widget->theme()->loadFonts(mNVGContext);
+    nvgBeginFrame(mNVGContext, mSize.x(), mSize.y(), mPixelRatio);
+    widget->draw(mNVGContext);
+    nvgEndFrame(mNVGContext);
+}
+
+const uint8_t *SoftwareRenderer::data() const {
+    return (const uint8_t *) mBackend->framebuffer.data();
+}
+
+double SoftwareRenderer::rasterTime() const {
+    return mBackend->rasterTime;
+}
+
+void SoftwareRenderer::downloadTGA(const std::string &filename) const {
+    FILE *tga = fopen(filename.c_str(), "wb");
+    if (tga == nullptr)
+        throw std::runtime_error("SoftwareRenderer::downloadTGA(): Could not open output file");
+    fputc(0, tga); /* ID */
+    fputc(0, tga); /* Color map */
+    fputc(2, tga); /* Image type */
+    fputc(0, tga); fputc(0, tga); /* First entry of color map (unused) */
+    fputc(0, tga); fputc(0, tga); /* Length of color map (unused) */
+    fputc(0, tga); /* Color map entry size (unused) */
+    fputc(0, tga); fputc(0, tga);  /* X offset */
+    fputc(0, tga); fputc(0, tga);  /* Y offset */
+    fputc(mFBSize.x() % 256, tga); /* Width */
+    fputc(mFBSize.x() / 256, tga); /* continued */
+    fputc(mFBSize.y() % 256, tga); /* Height */
+    fputc(mFBSize.y() / 256, tga); /* continued */
+    fputc(32, tga);   /* Bits per pixel */
+    fputc(0x20, tga); /* Scan from top left */
+    /* TGA stores BGRA */
+    const uint8_t *pixels = data();
+    for (int i = 0; i < mFBSize.prod(); ++i) {
+        const uint8_t *p = pixels + 4 * i;
+        uint8_t bgra[4] = { p[2], p[1], p[0], p[3] };
+        fwrite(bgra, 4, 1, tga);
+    }
+    fclose(tga);
+}
+
+NAMESPACE_END(nanogui)
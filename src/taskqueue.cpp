@@ -0,0 +1,140 @@
+/*
+    src/taskqueue.cpp -- Lock-free queue for handing work from arbitrary
+    threads to the main loop
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/taskqueue.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+NAMESPACE_BEGIN(nanogui)
+
+struct TaskQueue::Node {
+    std::atomic<Node *> next { nullptr };
+    std::function<void()> task;
+    std::chrono::steady_clock::time_point time;
+};
+
+TaskQueue::TaskQueue()
+    : mHead(nullptr), mTail(nullptr), mStub(new Node()), mSize(0),
+      mPeakSize(0), mPushed(0), mExecuted(0), mLastBatch(0),
+      mLastLatency(0), mMaxLatency(0), mTotalLatency(0) {
+    mHead.store(mStub);
+    mTail = mStub;
+}
+
+TaskQueue::~TaskQueue() {
+    while (Node *node = pop())
+        delete node;
+    delete mStub;
+}
+
+void TaskQueue::pushNode(Node *node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node *prev = mHead.exchange(node, std::memory_order_acq_rel);
+    /* Between the exchange and this store, the list is briefly disconnected;
+       the consumer treats this state as empty and retries on the next run */
+    prev->next.store(node, std::memory_order_release);
+}
+
+bool TaskQueue::push(const std::function<void()> &task) {
+    Node *node = new Node();
+    node->task = task;
+    node->time = std::chrono::steady_clock::now();
+    pushNode(node);
+    mPushed.fetch_add(1, std::memory_order_relaxed);
+
+    size_t size = mSize.fetch_add(1, std::memory_order_acq_rel) + 1;
+    size_t peak = mPeakSize.load(std::memory_order_relaxed);
+    while (size > peak &&
+           !mPeakSize.compare_exchange_weak(peak, size, std::memory_order_relaxed))
+        ;
+    return size == 1;
+}
+
+TaskQueue::Node *TaskQueue::pop() {
+    Node *tail = mTail;
+    Node *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == mStub) {
+        if (!next)
+            return nullptr;
+        mTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+
+    /* 'tail' is the last node: unless a push is in progress, re-insert the
+       stub node so that 'tail' can be detached from the list */
+    if (tail != mHead.load(std::memory_order_acquire))
+        return nullptr;
+
+    pushNode(mStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+size_t TaskQueue::run() {
+    size_t count = size(), executed = 0;
+    double batchLatency = 0;
+
+    while (executed < count) {
+        Node *node = pop();
+        if (!node)
+            break;
+        mSize.fetch_sub(1, std::memory_order_acq_rel);
+
+        double latency = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - node->time).count();
+        batchLatency = std::max(batchLatency, latency);
+        mTotalLatency += latency;
+        ++executed;
+
+        try {
+            node->task();
+        } catch (const std::exception &e) {
+            std::cerr << "Caught exception in queued task: " << e.what() << std::endl;
+        }
+        delete node;
+    }
+
+    mExecuted += executed;
+    mLastBatch = executed;
+    if (executed > 0) {
+        mLastLatency = batchLatency;
+        mMaxLatency = std::max(mMaxLatency, batchLatency);
+    }
+    return executed;
+}
+
+TaskQueue::Statistics TaskQueue::statistics() const {
+    Statistics stats;
+    stats.pushed = mPushed.load(std::memory_order_relaxed);
+    stats.executed = mExecuted;
+    stats.depth = size();
+    stats.peakDepth = mPeakSize.load(std::memory_order_relaxed);
+    stats.lastBatch = mLastBatch;
+    stats.lastLatency = mLastLatency;
+    stats.maxLatency = mMaxLatency;
+    stats.meanLatency = mExecuted > 0 ? mTotalLatency / mExecuted : 0.0;
+    return stats;
+}
+
+NAMESPACE_END(nanogui)
@@ -18,8 +18,6 @@
 #include <nanogui/opengl.h>
 #include <nanogui/theme.h>
 #include <nanogui/serializer/core.h>
-#include <regex>
-#include <iostream>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -53,6 +51,13 @@ void TextBox::setEditable(bool editable) {
     setCursor(editable ? Cursor::IBeam : Cursor::Arrow);
 }
 
+void TextBox::setFormat(const std::string &format) {
+    if (format == mFormat)
+        return;
+    mValidator = Validator::fromFormat(format);
+    mFormat = format;
+}
+
 void TextBox::setTheme(Theme *theme) {
     Widget::setTheme(theme);
     if (mTheme)
@@ -293,8 +298,8 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
             mMouseDownPos = p;
             mMouseDownModifier = modifiers;
 
-            double time = glfwGetTime();
-            if (time - mLastClick < 0.25) {
+            double time = getTime();
+            if (time >= mLastClick && time - mLastClick < 0.25) {
                 /* Double-click: select all text */
                 mSelectionPos = 0;
                 mCursorPos = (int) mValueTemp.size();
@@ -312,8 +317,8 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
                 mMouseDownPos = p;
                 mMouseDownModifier = modifiers;
 
-                double time = glfwGetTime();
-                if (time - mLastClick < 0.25) {
+                double time = getTime();
+                if (time >= mLastClick && time - mLastClick < 0.25) {
                     /* Double-click: reset to default value */
                     mValue = mDefaultValue;
                     if (mCallback)
@@ -392,7 +397,7 @@ bool TextBox::focusEvent(bool focused) {
             mTextOffset = 0;
         }
 
-        mValidFormat = (mValueTemp == "") || checkFormat(mValueTemp, mFormat);
+        updateValidity();
     }
 
     return true;
@@ -401,6 +406,7 @@ bool TextBox::focusEvent(bool focused) {
 bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifiers) {
     if (mEditable && focused()) {
         if (action == GLFW_PRESS || action == GLFW_REPEAT) {
+            bool edited = false;
             if (key == GLFW_KEY_LEFT) {
                 if (modifiers == GLFW_MOD_SHIFT) {
                     if (mSelectionPos == -1)
@@ -440,6 +446,7 @@ bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifie
 
                 mCursorPos = (int) mValueTemp.size();
             } else if (key == GLFW_KEY_BACKSPACE) {
+                edited = true;
                 if (!deleteSelection()) {
                     if (mCursorPos > 0) {
                         mValueTemp.erase(mValueTemp.begin() + mCursorPos - 1);
@@ -447,6 +454,7 @@ bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifie
                     }
                 }
             } else if (key == GLFW_KEY_DELETE) {
+                edited = true;
                 if (!deleteSelection()) {
                     if (mCursorPos < (int) mValueTemp.length())
                         mValueTemp.erase(mValueTemp.begin() + mCursorPos);
@@ -459,16 +467,18 @@ bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifie
                 mSelectionPos = 0;
             } else if (key == GLFW_KEY_X && modifiers == SYSTEM_COMMAND_MOD) {
                 copySelection();
-                deleteSelection();
+                edited = deleteSelection();
             } else if (key == GLFW_KEY_C && modifiers == SYSTEM_COMMAND_MOD) {
                 copySelection();
             } else if (key == GLFW_KEY_V && modifiers == SYSTEM_COMMAND_MOD) {
                 deleteSelection();
                 pasteFromClipboard();
+                edited = true;
             }
 
-            mValidFormat =
-                (mValueTemp == "") || checkFormat(mValueTemp, mFormat);
+            /* Cursor movement and copying leave the text unchanged */
+            if (edited)
+                updateValidity();
         }
 
         return true;
@@ -479,14 +489,11 @@ bool TextBox::keyboardEvent(int key, int /* scancode */, int action, int modifie
 
 bool TextBox::keyboardCharacterEvent(unsigned int codepoint) {
     if (mEditable && focused()) {
-        std::ostringstream convert;
-        convert << (char) codepoint;
-
         deleteSelection();
-        mValueTemp.insert(mCursorPos, convert.str());
+        mValueTemp.insert(mValueTemp.begin() + mCursorPos, (char) codepoint);
         mCursorPos++;
 
-        mValidFormat = (mValueTemp == "") || checkFormat(mValueTemp, mFormat);
+        updateValidity();
 
         return true;
     }
@@ -495,19 +502,14 @@ bool TextBox::keyboardCharacterEvent(unsigned int codepoint) {
 }
 
 bool TextBox::checkFormat(const std::string &input, const std::string &format) {
-    if (format.empty())
-        return true;
-    try {
-        std::regex regex(format);
-        return regex_match(input, regex);
-    } catch (const std::regex_error &) {
-#if __GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
-        std::cerr << "Warning: cannot validate text field due to lacking regular expression support. please compile with GCC >= 4.9" << std::endl;
-        return true;
-#else
-        throw;
-#endif
-    }
+    /* Validators are compiled once per format and shared between text boxes */
+    ref<Validator> validator =
+        format == mFormat ? mValidator : Validator::fromFormat(format);
+    return !validator || validator->validate(input);
+}
+
+void TextBox::updateValidity() {
+    mValidFormat = mValueTemp.empty() || !mValidator || mValidator->validate(mValueTemp);
 }
 
 bool TextBox::copySelection() {
@@ -655,7 +657,9 @@ bool TextBox::load(Serializer &s) {
     if (!s.get("defaultValue", mDefaultValue)) return false;
     if (!s.get("alignment", mAlignment)) return false;
     if (!s.get("units", mUnits)) return false;
-    if (!s.get("format", mFormat)) return false;
+    std::string format;
+    if (!s.get("format", format)) return false;
+    setFormat(format);
     if (!s.get("unitsImage", mUnitsImage)) return false;
     if (!s.get("validFormat", mValidFormat)) return false;
     if (!s.get("valueTemp", mValueTemp)) return false;
@@ -0,0 +1,667 @@
+/*
+    src/texteditor.cpp -- Multi-line text editor for large documents
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/texteditor.h>
+#include <nanogui/screen.h>
+#include <nanogui/opengl.h>
+#include <nanogui/theme.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const float Padding = 4.f;
+static const float ScrollbarWidth = 12.f;
+
+TextEditor::TextEditor(Widget *parent, const std::string &text)
+    : Widget(parent), mRowOffsetValid(0), mWrapWidth(-1.f), mEditable(true),
+      mCursorPos(0), mSelectionPos(NoSelection), mPendingRows(0),
+      mPreferredX(-1.f), mScrollToCursor(false), mScroll(0.f),
+      mLineHeight(0.f), mContentHeight(0.f), mDragScrollbar(false),
+      mMouseDownPos(Vector2i::Constant(-1)), mMouseDragPos(Vector2i::Constant(-1)),
+      mMouseDownModifier(0), mLastClick(0) {
+    if (mTheme) mFontSize = mTheme->mTextBoxFontSize;
+    setCursor(Cursor::IBeam);
+    setText(text);
+}
+
+void TextEditor::setTheme(Theme *theme) {
+    Widget::setTheme(theme);
+    if (mTheme)
+        mFontSize = mTheme->mTextBoxFontSize;
+    mWrapWidth = -1.f;
+}
+
+void TextEditor::setEditable(bool editable) {
+    mEditable = editable;
+    setCursor(editable ? Cursor::IBeam : Cursor::Arrow);
+}
+
+void TextEditor::setText(const std::string &text) {
+    mBuffer.assign(text);
+    mLineStart.assign(1, 0);
+    for (size_t pos = mBuffer.find('\n', 0); pos < text.size();
+         pos = mBuffer.find('\n', pos + 1))
+        mLineStart.push_back(pos + 1);
+    mLineRows.assign(mLineStart.size(), 0);
+    mRowOffsetValid = 0;
+    mCursorPos = 0;
+    mSelectionPos = NoSelection;
+    mPendingRows = 0;
+    mScroll = 0.f;
+}
+
+size_t TextEditor::lineOf(size_t pos) const {
+    return (size_t) (std::upper_bound(mLineStart.begin(), mLineStart.end(), pos) -
+                     mLineStart.begin()) - 1;
+}
+
+size_t TextEditor::lineEnd(size_t index) const {
+    return index + 1 < mLineStart.size() ? mLineStart[index + 1] - 1 : mBuffer.size();
+}
+
+void TextEditor::insertText(size_t pos, const char *str, size_t length) {
+    if (length == 0)
+        return;
+    size_t index = lineOf(pos);
+    mBuffer.insert(pos, str, length);
+    for (size_t i = index + 1; i < mLineStart.size(); ++i)
+        mLineStart[i] += length;
+
+    size_t breaks = (size_t) std::count(str, str + length, '\n');
+    if (breaks > 0) {
+        mLineStart.insert(mLineStart.begin() + index + 1, breaks, 0);
+        mLineRows.insert(mLineRows.begin() + index + 1, breaks, 0);
+        size_t next = index + 1;
+        for (size_t i = 0; i < length; ++i)
+            if (str[i] == '\n')
+                mLineStart[next++] = pos + i + 1;
+    }
+    mLineRows[index] = 0;
+    invalidateRows(index);
+}
+
+void TextEditor::eraseText(size_t pos, size_t length) {
+    length = std::min(length, mBuffer.size() - std::min(pos, mBuffer.size()));
+    if (length == 0)
+        return;
+    size_t first = lineOf(pos), last = lineOf(pos + length);
+    mBuffer.erase(pos, length);
+    mLineStart.erase(mLineStart.begin() + first + 1, mLineStart.begin() + last + 1);
+    mLineRows.erase(mLineRows.begin() + first + 1, mLineRows.begin() + last + 1);
+    for (size_t i = first + 1; i < mLineStart.size(); ++i)
+        mLineStart[i] -= length;
+    mLineRows[first] = 0;
+    invalidateRows(first);
+}
+
+void TextEditor::insert(size_t pos, const std::string &str) {
+    pos = std::min(pos, mBuffer.size());
+    insertText(pos, str.data(), str.size());
+    if (mCursorPos >= pos)
+        mCursorPos += str.size();
+    if (hasSelection() && mSelectionPos >= pos)
+        mSelectionPos += str.size();
+}
+
+void TextEditor::erase(size_t pos, size_t length) {
+    pos = std::min(pos, mBuffer.size());
+    length = std::min(length, mBuffer.size() - pos);
+    eraseText(pos, length);
+    auto adjust = [&](size_t &p) {
+        if (p >= pos + length)
+            p -= length;
+        else if (p > pos)
+            p = pos;
+    };
+    adjust(mCursorPos);
+    if (hasSelection()) {
+        adjust(mSelectionPos);
+        if (mSelectionPos == mCursorPos)
+            mSelectionPos = NoSelection;
+    }
+}
+
+void TextEditor::setCursorPosition(size_t pos) {
+    mCursorPos = std::min(pos, mBuffer.size());
+    mSelectionPos = NoSelection;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+void TextEditor::select(size_t begin, size_t end) {
+    mSelectionPos = std::min(begin, mBuffer.size());
+    mCursorPos = std::min(end, mBuffer.size());
+    if (mSelectionPos == mCursorPos)
+        mSelectionPos = NoSelection;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+std::string TextEditor::selectedText() const {
+    if (!hasSelection())
+        return std::string();
+    return mBuffer.substr(std::min(mCursorPos, mSelectionPos),
+                          std::max(mCursorPos, mSelectionPos));
+}
+
+bool TextEditor::copySelection() {
+    Screen *sc = mAncestorScreen;
+    if (!hasSelection() || !sc)
+        return false;
+    glfwSetClipboardString(sc->glfwWindow(), selectedText().c_str());
+    return true;
+}
+
+void TextEditor::pasteFromClipboard() {
+    Screen *sc = mAncestorScreen;
+    if (!sc)
+        return;
+    const char *cbstr = glfwGetClipboardString(sc->glfwWindow());
+    if (!cbstr)
+        return;
+    size_t length = std::strlen(cbstr);
+    insertText(mCursorPos, cbstr, length);
+    mCursorPos += length;
+}
+
+bool TextEditor::deleteSelection() {
+    if (!hasSelection())
+        return false;
+    size_t begin = std::min(mCursorPos, mSelectionPos),
+           end = std::max(mCursorPos, mSelectionPos);
+    eraseText(begin, end - begin);
+    mCursorPos = begin;
+    mSelectionPos = NoSelection;
+    return true;
+}
+
+void TextEditor::moveCursor(size_t pos, bool select) {
+    if (select) {
+        if (!hasSelection())
+            mSelectionPos = mCursorPos;
+    } else {
+        mSelectionPos = NoSelection;
+    }
+    mCursorPos = pos;
+    if (mCursorPos == mSelectionPos)
+        mSelectionPos = NoSelection;
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+}
+
+size_t TextEditor::previousCharacter(size_t pos) const {
+    if (pos == 0)
+        return 0;
+    do {
+        pos--;
+    } while (pos > 0 && (mBuffer[pos] & 0xC0) == 0x80);
+    return pos;
+}
+
+size_t TextEditor::nextCharacter(size_t pos) const {
+    size_t size = mBuffer.size();
+    if (pos >= size)
+        return size;
+    do {
+        pos++;
+    } while (pos < size && (mBuffer[pos] & 0xC0) == 0x80);
+    return pos;
+}
+
+void TextEditor::modified() {
+    mPreferredX = -1.f;
+    mScrollToCursor = true;
+    if (mCallback)
+        mCallback();
+}
+
+void TextEditor::updateRowOffsets() {
+    size_t count = mLineStart.size();
+    mRowOffset.resize(count + 1);
+    mRowOffsetValid = std::min(mRowOffsetValid, count + 1);
+    if (mRowOffsetValid == 0) {
+        mRowOffset[0] = 0;
+        mRowOffsetValid = 1;
+    }
+    for (size_t i = mRowOffsetValid; i <= count; ++i)
+        mRowOffset[i] = mRowOffset[i - 1] + std::max(mLineRows[i - 1], 1);
+    mRowOffsetValid = count + 1;
+}
+
+size_t TextEditor::lineAtRow(int row) const {
+    size_t index = (size_t) (std::upper_bound(mRowOffset.begin(), mRowOffset.end(), row) -
+                             mRowOffset.begin());
+    return std::min(index == 0 ? 0 : index - 1, mLineStart.size() - 1);
+}
+
+const char *TextEditor::layoutLine(NVGcontext *ctx, size_t index, RowVector &rows) {
+    size_t begin = mLineStart[index], end = lineEnd(index);
+    const char *text = mBuffer.data(begin, end);
+    const char *textEnd = text + (end - begin);
+    if (textEnd > text && textEnd[-1] == '\r')
+        textEnd--;
+
+    const int batchSize = 32;
+    NVGtextRow batch[batchSize];
+    rows.clear();
+    for (const char *it = text; it < textEnd; ) {
+        int count = nvgTextBreakLines(ctx, it, textEnd, mWrapWidth, batch, batchSize);
+        rows.insert(rows.end(), batch, batch + count);
+        if (count < batchSize)
+            break;
+        it = batch[count - 1].next;
+    }
+
+    if (rows.empty()) {
+        NVGtextRow row;
+        row.start = row.end = row.next = textEnd;
+        row.width = row.minx = row.maxx = 0.f;
+        rows.push_back(row);
+    }
+    /* NanoVG skips leading white space, which would hide indentation */
+    rows[0].start = text;
+
+    int count = (int) rows.size();
+    if (mLineRows[index] != count) {
+        mLineRows[index] = count;
+        invalidateRows(index);
+    }
+    return text;
+}
+
+size_t TextEditor::rowIndex(const RowVector &rows, const char *ptr) const {
+    size_t index = 0;
+    while (index + 1 < rows.size() && rows[index + 1].start <= ptr)
+        index++;
+    return index;
+}
+
+/* Horizontal position of a character within a row */
+static float rowX(NVGcontext *ctx, const NVGtextRow &row, const char *ptr, float x0) {
+    ptr = std::min(ptr, row.end);
+    if (ptr <= row.start)
+        return x0;
+    return x0 + nvgTextBounds(ctx, 0, 0, row.start, ptr, nullptr);
+}
+
+size_t TextEditor::positionAt(NVGcontext *ctx, int row, float x, RowVector &rows) {
+    updateRowOffsets();
+    row = std::max(0, std::min(row, mRowOffset.back() - 1));
+    size_t index = lineAtRow(row);
+    const char *text = layoutLine(ctx, index, rows);
+    updateRowOffsets();
+
+    const NVGtextRow &r = rows[std::min((size_t) std::max(row - mRowOffset[index], 0),
+                                        rows.size() - 1)];
+    size_t count = (size_t) (r.end - r.start);
+    frame_vector<NVGglyphPosition> glyphs(count + 1);
+    int nglyphs = count > 0 ? nvgTextGlyphPositions(ctx, 0, 0, r.start, r.end,
+                                                    glyphs.data(), (int) count) : 0;
+
+    /* Pick the closest character boundary, as TextBox does */
+    const char *best = r.start;
+    float bestDistance = std::abs(x);
+    for (int i = 1; i < nglyphs; ++i) {
+        float distance = std::abs(glyphs[i].x - x);
+        if (distance < bestDistance) {
+            best = glyphs[i].str;
+            bestDistance = distance;
+        }
+    }
+    if (std::abs(rowX(ctx, r, r.end, 0) - x) < bestDistance)
+        best = r.end;
+    return mLineStart[index] + (size_t) (best - text);
+}
+
+bool TextEditor::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    if (button != GLFW_MOUSE_BUTTON_1)
+        return Widget::mouseButtonEvent(p, button, down, modifiers);
+
+    if (down && p.x() >= mPos.x() + mSize.x() - ScrollbarWidth &&
+        mContentHeight > mSize.y() - 2 * Padding) {
+        mDragScrollbar = true;
+        return true;
+    }
+
+    if (down && !mFocused)
+        requestFocus();
+
+    if (down) {
+        mMouseDownPos = p;
+        mMouseDownModifier = modifiers;
+
+        double time = getTime();
+        if (time >= mLastClick && time - mLastClick < 0.25) {
+            /* Double-click: select all text */
+            select(0, mBuffer.size());
+            mMouseDownPos = Vector2i::Constant(-1);
+        }
+        mLastClick = time;
+    } else {
+        mMouseDownPos = mMouseDragPos = Vector2i::Constant(-1);
+        mDragScrollbar = false;
+    }
+    return true;
+}
+
+bool TextEditor::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
+                                int /* button */, int /* modifiers */) {
+    if (mDragScrollbar) {
+        float visible = mSize.y() - 2 * Padding;
+        float scrollh = (mSize.y() - 8) * std::min(1.f, visible / mContentHeight);
+        float track = mSize.y() - 8 - scrollh;
+        if (track > 0)
+            mScroll += rel.y() * (mContentHeight - visible) / track;
+        return true;
+    }
+    mMouseDragPos = p;
+    return true;
+}
+
+bool TextEditor::scrollEvent(const Vector2i &/* p */, const Vector2f &rel) {
+    float lineh = mLineHeight > 0 ? mLineHeight : fontSize() * 1.2f;
+    mScroll -= rel.y() * lineh * 3;
+    return true;
+}
+
+bool TextEditor::keyboardEvent(int key, int /* scancode */, int action, int modifiers) {
+    if (!focused() || (action != GLFW_PRESS && action != GLFW_REPEAT))
+        return false;
+
+    bool shift = (modifiers & GLFW_MOD_SHIFT) != 0;
+    bool command = (modifiers & SYSTEM_COMMAND_MOD) != 0;
+    int visibleRows = std::max(1, (int) ((mSize.y() - 2 * Padding) /
+                                         (mLineHeight > 0 ? mLineHeight : fontSize() * 1.2f)));
+
+    auto moveVertically = [&](int rows) {
+        if (shift) {
+            if (!hasSelection())
+                mSelectionPos = mCursorPos;
+        } else {
+            mSelectionPos = NoSelection;
+        }
+        mPendingRows += rows;
+    };
+
+    if (key == GLFW_KEY_LEFT) {
+        if (hasSelection() && !shift)
+            moveCursor(std::min(mCursorPos, mSelectionPos), false);
+        else
+            moveCursor(previousCharacter(mCursorPos), shift);
+    } else if (key == GLFW_KEY_RIGHT) {
+        if (hasSelection() && !shift)
+            moveCursor(std::max(mCursorPos, mSelectionPos), false);
+        else
+            moveCursor(nextCharacter(mCursorPos), shift);
+    } else if (key == GLFW_KEY_UP) {
+        moveVertically(-1);
+    } else if (key == GLFW_KEY_DOWN) {
+        moveVertically(1);
+    } else if (key == GLFW_KEY_PAGE_UP) {
+        moveVertically(-visibleRows);
+    } else if (key == GLFW_KEY_PAGE_DOWN) {
+        moveVertically(visibleRows);
+    } else if (key == GLFW_KEY_HOME) {
+        moveCursor(command ? 0 : mLineStart[lineOf(mCursorPos)], shift);
+    } else if (key == GLFW_KEY_END) {
+        moveCursor(command ? mBuffer.size() : lineEnd(lineOf(mCursorPos)), shift);
+    } else if (key == GLFW_KEY_A && modifiers == SYSTEM_COMMAND_MOD) {
+        select(0, mBuffer.size());
+    } else if (key == GLFW_KEY_C && modifiers == SYSTEM_COMMAND_MOD) {
+        copySelection();
+    } else if (!mEditable) {
+        return true;
+    } else if (key == GLFW_KEY_BACKSPACE) {
+        if (!deleteSelection() && mCursorPos > 0) {
+            size_t pos = previousCharacter(mCursorPos);
+            eraseText(pos, mCursorPos - pos);
+            mCursorPos = pos;
+        }
+        modified();
+    } else if (key == GLFW_KEY_DELETE) {
+        if (!deleteSelection() && mCursorPos < mBuffer.size())
+            eraseText(mCursorPos, nextCharacter(mCursorPos) - mCursorPos);
+        modified();
+    } else if (key == GLFW_KEY_ENTER || key == GLFW_KEY_KP_ENTER) {
+        deleteSelection();
+        insertText(mCursorPos, "\n", 1);
+        mCursorPos++;
+        modified();
+    } else if (key == GLFW_KEY_X && modifiers == SYSTEM_COMMAND_MOD) {
+        if (copySelection()) {
+            deleteSelection();
+            modified();
+        }
+    } else if (key == GLFW_KEY_V && modifiers == SYSTEM_COMMAND_MOD) {
+        deleteSelection();
+        pasteFromClipboard();
+        modified();
+    }
+
+    return true;
+}
+
+bool TextEditor::keyboardCharacterEvent(unsigned int codepoint) {
+    if (!mEditable || !focused())
+        return false;
+
+    deleteSelection();
+    auto encoded = utf8((int) codepoint);
+    size_t length = std::strlen(encoded.data());
+    insertText(mCursorPos, encoded.data(), length);
+    mCursorPos += length;
+    modified();
+    return true;
+}
+
+Vector2i TextEditor::preferredSize(NVGcontext *) const {
+    return Vector2i(fontSize() * 20, (int) (fontSize() * 1.2f * 8 + 2 * Padding));
+}
+
+void TextEditor::draw(NVGcontext* ctx) {
+    Widget::draw(ctx);
+
+    NVGpaint bg = nvgBoxGradient(ctx,
+        mPos.x() + 1, mPos.y() + 1 + 1.0f, mSize.x() - 2, mSize.y() - 2,
+        3, 4, Color(255, 32), Color(32, 32));
+    NVGpaint fg = nvgBoxGradient(ctx,
+        mPos.x() + 1, mPos.y() + 1 + 1.0f, mSize.x() - 2, mSize.y() - 2,
+        3, 4, Color(150, 32), Color(32, 32));
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + 1, mPos.y() + 1 + 1.0f, mSize.x() - 2,
+                   mSize.y() - 2, 3);
+    nvgFillPaint(ctx, mEditable && focused() ? fg : bg);
+    nvgFill(ctx);
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + 0.5f, mPos.y() + 0.5f, mSize.x() - 1,
+                   mSize.y() - 1, 2.5f);
+    nvgStrokeColor(ctx, Color(0, 48));
+    nvgStroke(ctx);
+
+    nvgFontSize(ctx, fontSize());
+    nvgFontFace(ctx, "sans");
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+    float ascender, descender, lineh;
+    nvgTextMetrics(ctx, &ascender, &descender, &lineh);
+    mLineHeight = lineh;
+
+    float x0 = mPos.x() + Padding, y0 = mPos.y() + Padding;
+    float width = mSize.x() - 2 * Padding - ScrollbarWidth,
+          height = mSize.y() - 2 * Padding;
+
+    /* A new width invalidates the wrapping of all lines */
+    if (width != mWrapWidth) {
+        mWrapWidth = width;
+        std::fill(mLineRows.begin(), mLineRows.end(), 0);
+        mRowOffsetValid = 0;
+    }
+
+    RowVector rows;
+
+    /* Resolve mouse and vertical cursor motion, which need the layout */
+    if (mMouseDownPos.x() != -1 || mMouseDragPos.x() != -1) {
+        bool drag = mMouseDownPos.x() == -1;
+        Vector2i p = drag ? mMouseDragPos : mMouseDownPos;
+        int row = (int) std::floor((p.y() - y0 + mScroll) / lineh);
+        size_t pos = positionAt(ctx, row, p.x() - x0, rows);
+        moveCursor(pos, drag || mMouseDownModifier == GLFW_MOD_SHIFT);
+        mMouseDownPos = Vector2i::Constant(-1);
+    }
+
+    if (mPendingRows != 0) {
+        size_t index = lineOf(mCursorPos);
+        const char *text = layoutLine(ctx, index, rows);
+        updateRowOffsets();
+        const char *ptr = text + (mCursorPos - mLineStart[index]);
+        size_t row = rowIndex(rows, ptr);
+        if (mPreferredX < 0)
+            mPreferredX = rowX(ctx, rows[row], ptr, 0);
+        float preferredX = mPreferredX;
+        size_t pos = positionAt(ctx, mRowOffset[index] + (int) row + mPendingRows,
+                                preferredX, rows);
+        mPendingRows = 0;
+        mCursorPos = pos;
+        if (mCursorPos == mSelectionPos)
+            mSelectionPos = NoSelection;
+        mPreferredX = preferredX;
+        mScrollToCursor = true;
+    }
+
+    if (mScrollToCursor) {
+        size_t index = lineOf(mCursorPos);
+        const char *text = layoutLine(ctx, index, rows);
+        updateRowOffsets();
+        float top = (mRowOffset[index] + rowIndex(rows, text + (mCursorPos - mLineStart[index]))) * lineh;
+        if (top < mScroll)
+            mScroll = top;
+        else if (top + lineh > mScroll + height)
+            mScroll = top + lineh - height;
+        mScrollToCursor = false;
+    }
+
+    updateRowOffsets();
+    mContentHeight = mRowOffset.back() * lineh;
+    mScroll = std::max(0.f, std::min(mScroll, mContentHeight - height));
+
+    size_t selBegin = NoSelection, selEnd = NoSelection;
+    if (hasSelection()) {
+        selBegin = std::min(mCursorPos, mSelectionPos);
+        selEnd = std::max(mCursorPos, mSelectionPos);
+    }
+    bool caret = mEditable && focused();
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x() + 1, mPos.y() + 1,
+                        mSize.x() - ScrollbarWidth - 1, mSize.y() - 2);
+
+    /* Only lay out and draw the lines in view */
+    size_t index = lineAtRow((int) (mScroll / lineh));
+    float y = y0 + mRowOffset[index] * lineh - mScroll;
+    for (; index < mLineStart.size() && y < y0 + height; ++index) {
+        const char *text = layoutLine(ctx, index, rows);
+        size_t begin = mLineStart[index], end = lineEnd(index);
+
+        for (size_t i = 0; i < rows.size(); ++i, y += lineh) {
+            const NVGtextRow &row = rows[i];
+            if (y + lineh < y0)
+                continue;
+            size_t rowBegin = begin + (size_t) (row.start - text);
+            size_t rowEnd = i + 1 < rows.size() ? begin + (size_t) (rows[i + 1].start - text) : end;
+
+            bool lastRow = i + 1 == rows.size();
+
+            if (selBegin != NoSelection) {
+                size_t a = std::max(selBegin, rowBegin), b = std::min(selEnd, rowEnd);
+                bool lineBreak = lastRow && selBegin <= end && selEnd > end;
+                if (a < b || lineBreak) {
+                    float sx0 = rowX(ctx, row, text + (a - begin), x0);
+                    float sx1 = rowX(ctx, row, text + (std::max(a, b) - begin), x0);
+                    if (lineBreak)
+                        sx1 += fontSize() * 0.3f;
+                    nvgBeginPath(ctx);
+                    nvgFillColor(ctx, nvgRGBA(255, 255, 255, 80));
+                    nvgRect(ctx, sx0, y, sx1 - sx0, lineh);
+                    nvgFill(ctx);
+                }
+            }
+
+            nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+            if (row.end > row.start)
+                nvgText(ctx, x0, y, row.start, row.end);
+
+            if (caret && mCursorPos >= rowBegin &&
+                (mCursorPos < rowEnd || (lastRow && mCursorPos == rowEnd))) {
+                float cx = rowX(ctx, row, text + (mCursorPos - begin), x0);
+                nvgBeginPath(ctx);
+                nvgMoveTo(ctx, cx, y);
+                nvgLineTo(ctx, cx, y + lineh);
+                nvgStrokeColor(ctx, nvgRGBA(255, 192, 0, 255));
+                nvgStrokeWidth(ctx, 1.0f);
+                nvgStroke(ctx);
+            }
+        }
+    }
+    nvgRestore(ctx);
+
+    if (mContentHeight <= height)
+        return;
+
+    float scrollh = (mSize.y() - 8) * std::min(1.f, height / mContentHeight);
+    float scroll = mScroll / (mContentHeight - height);
+
+    NVGpaint paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 + 1, mPos.y() + 4 + 1, 8,
+        mSize.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12, mPos.y() + 4, 8,
+                   mSize.y() - 8, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 - 1,
+        mPos.y() + 4 + (mSize.y() - 8 - scrollh) * scroll - 1, 8, scrollh,
+        3, 4, Color(220, 100), Color(128, 100));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12 + 1,
+                   mPos.y() + 4 + 1 + (mSize.y() - 8 - scrollh) * scroll, 8 - 2,
+                   scrollh - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+}
+
+void TextEditor::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("text", mBuffer.str());
+    s.set("editable", mEditable);
+    s.set("scroll", mScroll);
+}
+
+bool TextEditor::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    std::string text;
+    if (!s.get("text", text)) return false;
+    if (!s.get("editable", mEditable)) return false;
+    float scroll;
+    if (!s.get("scroll", scroll)) return false;
+    setText(text);
+    mScroll = scroll;
+    mWrapWidth = -1.f;
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -14,11 +14,11 @@
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/entypo.h>
-#include <nanogui_resources.h>
+#include <nanogui/resources.h>
 
 NAMESPACE_BEGIN(nanogui)
 
-Theme::Theme(NVGcontext *ctx) {
+Theme::Theme(NVGcontext *) {
     mStandardFontSize                 = 16;
     mButtonFontSize                   = 20;
     mTextBoxFontSize                  = 20;
@@ -80,13 +80,14 @@ Theme::Theme(NVGcontext *ctx) {
     mTextBoxUpIcon                    = ENTYPO_ICON_CHEVRON_UP;
     mTextBoxDownIcon                  = ENTYPO_ICON_CHEVRON_DOWN;
 
-    mFontNormal = nvgCreateFontMem(ctx, "sans", roboto_regular_ttf,
-                                   roboto_regular_ttf_size, 0);
-    mFontBold = nvgCreateFontMem(ctx, "sans-bold", roboto_bold_ttf,
-                                 roboto_bold_ttf_size, 0);
-    mFontIcons = nvgCreateFontMem(ctx, "icons", entypo_ttf,
-                                  entypo_ttf_size, 0);
-    if (mFontNormal == -1 || mFontBold == -1 || mFontIcons == -1)
+}
+
+void Theme::loadFonts(NVGcontext *ctx) {
+    /* A theme may be shared by screens that draw on different threads, so
+       this only touches 'ctx' (faces that it already has are reused) */
+    if (createFontResource(ctx, "sans", "roboto_regular_ttf") == -1 ||
+        createFontResource(ctx, "sans-bold", "roboto_bold_ttf") == -1 ||
+        createFontResource(ctx, "icons", "entypo_ttf") == -1)
         throw std::runtime_error("Could not load fonts!");
 }
 
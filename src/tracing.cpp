@@ -0,0 +1,162 @@
+/*
+    src/tracing.cpp -- Lightweight timeline tracing of the event and
+    rendering path with export to the Chrome/Perfetto trace format
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tracing.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+NAMESPACE_BEGIN(detail)
+std::atomic<bool> tracing_active { false };
+NAMESPACE_END(detail)
+
+struct TraceRecord {
+    const char *name;
+    uint64_t start, end; /* end == 0: instantaneous event */
+};
+
+/* Ring buffer of a single thread. Only the owning thread writes records;
+   'count' is published with release semantics for saveTrace() */
+struct TraceBuffer {
+    static const uint64_t Capacity = 16384;
+
+    std::unique_ptr<TraceRecord[]> records { new TraceRecord[Capacity] };
+    std::atomic<uint64_t> count { 0 };
+    std::atomic<uint64_t> first { 0 }; /* Records before this index were cleared */
+    std::string name;
+    uint32_t id = 0;
+
+    void push(const char *name_, uint64_t start, uint64_t end) {
+        uint64_t index = count.load(std::memory_order_relaxed);
+        TraceRecord &record = records[index % Capacity];
+        record.name = name_;
+        record.start = start;
+        record.end = end;
+        count.store(index + 1, std::memory_order_release);
+    }
+};
+
+/* Buffers outlive their threads so that their events can still be exported */
+static std::mutex trace_mutex;
+static std::vector<std::unique_ptr<TraceBuffer>> trace_buffers;
+static thread_local TraceBuffer *trace_buffer = nullptr;
+static thread_local std::string trace_thread_name;
+
+static TraceBuffer *thread_buffer() {
+    if (!trace_buffer) {
+        std::lock_guard<std::mutex> guard(trace_mutex);
+        trace_buffers.emplace_back(new TraceBuffer());
+        trace_buffer = trace_buffers.back().get();
+        trace_buffer->id = (uint32_t) trace_buffers.size();
+        trace_buffer->name = trace_thread_name.empty()
+            ? "Thread " + std::to_string(trace_buffer->id) : trace_thread_name;
+    }
+    return trace_buffer;
+}
+
+void setTracing(bool enabled) {
+    detail::tracing_active.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t traceTimestamp() {
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void traceEvent(const char *name, uint64_t start, uint64_t end) {
+    if (tracing())
+        thread_buffer()->push(name, start, std::max(end, start + 1));
+}
+
+void traceInstant(const char *name) {
+    if (tracing())
+        thread_buffer()->push(name, traceTimestamp(), 0);
+}
+
+void setTraceThreadName(const std::string &name) {
+    /* The buffer is only allocated once the thread records an event */
+    trace_thread_name = name;
+    if (trace_buffer) {
+        std::lock_guard<std::mutex> guard(trace_mutex);
+        trace_buffer->name = name;
+    }
+}
+
+void clearTrace() {
+    std::lock_guard<std::mutex> guard(trace_mutex);
+    for (auto &buffer : trace_buffers)
+        buffer->first.store(buffer->count.load(std::memory_order_acquire));
+}
+
+static std::string json_escape(const std::string &str) {
+    std::string result;
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if ((unsigned char) c >= 0x20)
+            result += c;
+    }
+    return result;
+}
+
+void saveTrace(const std::string &filename) {
+    std::ofstream os(filename);
+    if (!os)
+        throw std::runtime_error("saveTrace(): could not open \"" + filename + "\"!");
+
+    std::lock_guard<std::mutex> guard(trace_mutex);
+
+    /* Timestamps are written in microseconds relative to the earliest event */
+    uint64_t origin = std::numeric_limits<uint64_t>::max();
+    for (auto &buffer : trace_buffers) {
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t first = std::max(buffer->first.load(), count > TraceBuffer::Capacity
+                                  ? count - TraceBuffer::Capacity : 0);
+        for (uint64_t i = first; i < count; ++i)
+            origin = std::min(origin, buffer->records[i % TraceBuffer::Capacity].start);
+    }
+
+    os << "{\"traceEvents\":[\n";
+    bool separator = false;
+    os.precision(3);
+    os << std::fixed;
+    for (auto &buffer : trace_buffers) {
+        if (separator)
+            os << ",\n";
+        separator = true;
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+           << ",\"args\":{\"name\":\"" << json_escape(buffer->name) << "\"}}";
+
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t first = std::max(buffer->first.load(), count > TraceBuffer::Capacity
+                                  ? count - TraceBuffer::Capacity : 0);
+        for (uint64_t i = first; i < count; ++i) {
+            const TraceRecord &r = buffer->records[i % TraceBuffer::Capacity];
+            os << ",\n{\"name\":\"" << json_escape(r.name) << "\",\"cat\":\"nanogui\",\"pid\":1,\"tid\":"
+               << buffer->id << ",\"ts\":" << (r.start - origin) / 1000.0;
+            if (r.end)
+                os << ",\"ph\":\"X\",\"dur\":" << (r.end - r.start) / 1000.0 << "}";
+            else
+                os << ",\"ph\":\"i\",\"s\":\"t\"}";
+        }
+    }
+    os << "\n]}\n";
+}
+
+NAMESPACE_END(nanogui)
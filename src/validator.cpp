@@ -0,0 +1,142 @@
+/*
+    src/validator.cpp -- Shared, precompiled validators for the input
+    formats of text boxes
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/validator.h>
+#include <iostream>
+#include <mutex>
+#include <regex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+NAMESPACE_BEGIN(detail)
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+/* Skip a run of digits and return the number of digits seen */
+static inline size_t skip_digits(const char *&it, const char *end) {
+    const char *start = it;
+    while (it != end && is_digit(*it))
+        ++it;
+    return (size_t) (it - start);
+}
+
+/// Equivalent to "[-]?[0-9]*" (signed) and "[0-9]*" (unsigned)
+class IntegerValidator : public Validator {
+public:
+    IntegerValidator(bool isSigned) : mSigned(isSigned) { }
+
+    bool validate(const std::string &input) const override {
+        const char *it = input.data(), *end = it + input.size();
+        if (mSigned && it != end && *it == '-')
+            ++it;
+        skip_digits(it, end);
+        return it == end;
+    }
+
+protected:
+    bool mSigned;
+};
+
+/// Equivalent to "[-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?"
+class FloatValidator : public Validator {
+public:
+    bool validate(const std::string &input) const override {
+        const char *it = input.data(), *end = it + input.size();
+        if (it != end && (*it == '-' || *it == '+'))
+            ++it;
+
+        /* The mantissa must end with a digit */
+        size_t digits = skip_digits(it, end);
+        if (it != end && *it == '.') {
+            ++it;
+            digits = skip_digits(it, end);
+        }
+        if (digits == 0)
+            return false;
+
+        if (it != end && (*it == 'e' || *it == 'E')) {
+            ++it;
+            if (it != end && (*it == '-' || *it == '+'))
+                ++it;
+            if (skip_digits(it, end) == 0)
+                return false;
+        }
+        return it == end;
+    }
+};
+
+/// Matches the complete input against a compiled regular expression
+class RegexValidator : public Validator {
+public:
+    RegexValidator(const std::string &format) : mRegex(format) { }
+
+    bool validate(const std::string &input) const override {
+        return std::regex_match(input, mRegex);
+    }
+
+protected:
+    std::regex mRegex;
+};
+
+/// Used when the standard library lacks regular expression support
+class AcceptAllValidator : public Validator {
+public:
+    bool validate(const std::string &) const override { return true; }
+};
+
+static std::mutex validator_mutex;
+static std::unordered_map<std::string, ref<Validator>> validator_cache;
+static size_t validator_compiled = 0;
+
+NAMESPACE_END(detail)
+
+ref<Validator> Validator::fromFormat(const std::string &format) {
+    if (format.empty())
+        return nullptr;
+
+    std::lock_guard<std::mutex> guard(detail::validator_mutex);
+    auto it = detail::validator_cache.find(format);
+    if (it != detail::validator_cache.end())
+        return it->second;
+
+    ref<Validator> validator;
+    if (format == "[-]?[0-9]*")
+        validator = new detail::IntegerValidator(true);
+    else if (format == "[0-9]*")
+        validator = new detail::IntegerValidator(false);
+    else if (format == "[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?")
+        validator = new detail::FloatValidator();
+    else {
+        try {
+            validator = new detail::RegexValidator(format);
+            detail::validator_compiled++;
+        } catch (const std::regex_error &) {
+#if __GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+            std::cerr << "Warning: cannot validate text field due to lacking regular expression support. please compile with GCC >= 4.9" << std::endl;
+            validator = new detail::AcceptAllValidator();
+#else
+            throw;
+#endif
+        }
+    }
+
+    detail::validator_cache[format] = validator;
+    return validator;
+}
+
+size_t Validator::compiledCount() {
+    std::lock_guard<std::mutex> guard(detail::validator_mutex);
+    return detail::validator_compiled;
+}
+
+NAMESPACE_END(nanogui)
@@ -16,13 +16,52 @@
 #include <nanogui/opengl.h>
 #include <nanogui/screen.h>
 #include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <limits>
 
 NAMESPACE_BEGIN(nanogui)
 
+/* Screen-space rectangle (x0, y0, x1, y1) that bounds what the widget being
+   drawn on this thread can still affect, see Widget::draw() */
+static thread_local float clip_rect[4] = {
+    -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+     std::numeric_limits<float>::infinity(),  std::numeric_limits<float>::infinity()
+};
+static thread_local size_t culled_count = 0;
+
+/* Restores the clip rectangle when drawing of a widget finishes */
+struct ClipScope {
+    float saved[4];
+    ClipScope() { std::copy(clip_rect, clip_rect + 4, saved); }
+    ~ClipScope() { std::copy(saved, saved + 4, clip_rect); }
+};
+
+/* Intersect 'clip' with the screen-space bounding box of the rectangle
+   (pos, size) under the transformation 'xform'. Returns false when the
+   intersection is empty */
+static bool clipBounds(const float *xform, const Vector2i &pos, const Vector2i &size,
+                       const float *clip, float *result) {
+    float x0 = std::numeric_limits<float>::infinity(), y0 = x0, x1 = -x0, y1 = -x0;
+    for (int i = 0; i < 4; ++i) {
+        float px = (float) (pos.x() + ((i & 1) ? size.x() : 0)),
+              py = (float) (pos.y() + ((i & 2) ? size.y() : 0)), tx, ty;
+        nvgTransformPoint(&tx, &ty, xform, px, py);
+        x0 = std::min(x0, tx); x1 = std::max(x1, tx);
+        y0 = std::min(y0, ty); y1 = std::max(y1, ty);
+    }
+    result[0] = std::max(x0, clip[0]);
+    result[1] = std::max(y0, clip[1]);
+    result[2] = std::min(x1, clip[2]);
+    result[3] = std::min(y1, clip[3]);
+    return result[0] < result[2] && result[1] < result[3];
+}
+
 Widget::Widget(Widget *parent)
-    : mParent(nullptr), mTheme(nullptr), mLayout(nullptr),
+    : mParent(nullptr), mKind(0), mAncestorWindow(nullptr), mAncestorScreen(nullptr),
+      mTheme(nullptr), mLayout(nullptr),
       mPos(Vector2i::Zero()), mSize(Vector2i::Zero()),
-      mFixedSize(Vector2i::Zero()), mVisible(true), mEnabled(true),
+      mFixedSize(Vector2i::Zero()), mAbsolutePos(Vector2i::Zero()),
+      mAbsolutePosDirty(true), mVisible(true), mEnabled(true),
       mFocused(false), mMouseFocus(false), mTooltip(""), mFontSize(-1.0f),
       mIconExtraScale(1.0f), mCursor(Cursor::Arrow) {
     if (parent)
@@ -152,8 +191,9 @@ void Widget::addChild(Widget * widget) {
 }
 
 void Widget::removeChild(const Widget *widget) {
-    mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), widget), mChildren.end());
-    widget->decRef();
+    auto it = std::find(mChildren.begin(), mChildren.end(), widget);
+    if (it != mChildren.end())
+        removeChild((int) (it - mChildren.begin()));
 }
 
 void Widget::removeChild(int index) {
@@ -170,29 +210,45 @@ int Widget::childIndex(Widget *widget) const {
 }
 
 Window *Widget::window() {
-    Widget *widget = this;
-    while (true) {
-        if (!widget)
-            throw std::runtime_error(
-                "Widget:internal error (could not find parent window)");
-        Window *window = dynamic_cast<Window *>(widget);
-        if (window)
-            return window;
-        widget = widget->parent();
-    }
+    Window *window = hasKind(WindowKind) ? static_cast<Window *>(this) : mAncestorWindow;
+    if (!window)
+        throw std::runtime_error(
+            "Widget:internal error (could not find parent window)");
+    return window;
 }
 
 Screen *Widget::screen() {
-    Widget *widget = this;
-    while (true) {
-        if (!widget)
-            throw std::runtime_error(
-                "Widget:internal error (could not find parent screen)");
-        Screen *screen = dynamic_cast<Screen *>(widget);
-        if (screen)
-            return screen;
-        widget = widget->parent();
+    Screen *screen = hasKind(ScreenKind) ? static_cast<Screen *>(this) : mAncestorScreen;
+    if (!screen)
+        throw std::runtime_error(
+            "Widget:internal error (could not find parent screen)");
+    return screen;
+}
+
+void Widget::updateAncestors() {
+    if (mParent) {
+        mAncestorWindow = mParent->hasKind(WindowKind)
+            ? static_cast<Window *>(mParent) : mParent->mAncestorWindow;
+        mAncestorScreen = mParent->hasKind(ScreenKind)
+            ? static_cast<Screen *>(mParent) : mParent->mAncestorScreen;
+    } else {
+        mAncestorWindow = nullptr;
+        mAncestorScreen = nullptr;
     }
+    mAbsolutePosDirty = true;
+    for (auto child : mChildren)
+        child->updateAncestors();
+}
+
+void Widget::invalidateAbsolutePositionRecursive() {
+    mAbsolutePosDirty = true;
+    for (auto child : mChildren)
+        child->invalidateAbsolutePosition();
+}
+
+void Widget::updateAbsolutePosition() const {
+    mAbsolutePos = mParent ? (mParent->absolutePosition() + mPos) : mPos;
+    mAbsolutePosDirty = false;
 }
 
 void Widget::requestFocus() {
@@ -216,17 +272,39 @@ void Widget::draw(NVGcontext *ctx) {
 
     nvgSave(ctx);
     nvgTranslate(ctx, mPos.x(), mPos.y());
+
+    float xform[6];
+    nvgCurrentTransform(ctx, xform);
+    ClipScope scope;
+
+    /* A widget is scissored to its bounds by its parent; the bounds of a
+       screen are those of its window */
+    float clip[4];
+    if (mParent || hasKind(ScreenKind))
+        clipBounds(xform, Vector2i::Zero(), mSize, scope.saved, clip);
+    else
+        std::copy(scope.saved, scope.saved + 4, clip);
+
     for (auto child : mChildren) {
-        if (child->visible()) {
-            nvgSave(ctx);
-            nvgIntersectScissor(ctx, child->mPos.x(), child->mPos.y(), child->mSize.x(), child->mSize.y());
-            child->draw(ctx);
-            nvgRestore(ctx);
+        if (!child->visible())
+            continue;
+        if (!clipBounds(xform, child->mPos, child->mSize, clip, clip_rect)) {
+            /* Entirely clipped away: skip the child and its descendants */
+            culled_count++;
+            continue;
         }
+        nvgSave(ctx);
+        nvgIntersectScissor(ctx, child->mPos.x(), child->mPos.y(), child->mSize.x(), child->mSize.y());
+        child->draw(ctx);
+        nvgRestore(ctx);
     }
     nvgRestore(ctx);
 }
 
+size_t Widget::culledCount() {
+    return culled_count;
+}
+
 void Widget::save(Serializer &s) const {
     s.set("position", mPos);
     s.set("size", mSize);
@@ -241,6 +319,7 @@ void Widget::save(Serializer &s) const {
 
 bool Widget::load(Serializer &s) {
     if (!s.get("position", mPos)) return false;
+    invalidateAbsolutePosition();
     if (!s.get("size", mSize)) return false;
     if (!s.get("fixedSize", mFixedSize)) return false;
     if (!s.get("visible", mVisible)) return false;
@@ -19,7 +19,11 @@
 NAMESPACE_BEGIN(nanogui)
 
 Window::Window(Widget *parent, const std::string &title)
-    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false) { }
+    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false) {
+    mKind |= WindowKind;
+    if (parent && parent->hasKind(ScreenKind))
+        static_cast<Screen *>(parent)->trackWindow(this);
+}
 
 Vector2i Window::preferredSize(NVGcontext *ctx) const {
     if (mButtonPanel)
@@ -161,6 +165,7 @@ bool Window::mouseDragEvent(const Vector2i &, const Vector2i &rel,
         mPos += rel;
         mPos = mPos.cwiseMax(Vector2i::Zero());
         mPos = mPos.cwiseMin(parent()->size() - mSize);
+        invalidateAbsolutePosition();
         return true;
     }
     return false;
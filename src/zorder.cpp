@@ -0,0 +1,144 @@
+/*
+    src/zorder.cpp -- Stacking order of the windows and popups of a screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/zorder.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+ZOrder::ZOrder() : mCounter(0) { }
+
+void ZOrder::insert(Window *window) {
+    if (contains(window))
+        return;
+    Entry &entry = mEntries[window];
+    entry.key = Key(0, mCounter++);
+    mOrder[entry.key] = window;
+}
+
+void ZOrder::remove(Window *window) {
+    auto it = mEntries.find(window);
+    if (it == mEntries.end())
+        return;
+    Entry &entry = it->second;
+    if (entry.owner)
+        setOwner(window, nullptr);
+    for (Window *popup : entry.popups)
+        mEntries[popup].owner = nullptr;
+    mOrder.erase(entry.key);
+    mEntries.erase(it);
+}
+
+void ZOrder::setOwner(Window *popup, Window *owner) {
+    auto it = mEntries.find(popup);
+    if (it == mEntries.end() || it->second.owner == owner)
+        return;
+    Entry &entry = it->second;
+
+    /* Only tracked windows can own popups; reject cycles */
+    auto ownerIt = mEntries.find(owner);
+    if (ownerIt != mEntries.end()) {
+        for (Window *w = owner; w; w = mEntries[w].owner)
+            if (w == popup)
+                return;
+    }
+
+    if (entry.owner) {
+        auto &siblings = mEntries[entry.owner].popups;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), popup), siblings.end());
+        entry.owner = nullptr;
+    }
+
+    if (ownerIt == mEntries.end())
+        return;
+
+    entry.owner = owner;
+    ownerIt->second.popups.push_back(popup);
+
+    /* Popups live in the layer of their owner */
+    if (entry.key.first != ownerIt->second.key.first)
+        setLayer(popup, ownerIt->second.key.first);
+}
+
+Window *ZOrder::owner(const Window *window) const {
+    auto it = mEntries.find(window);
+    return it != mEntries.end() ? it->second.owner : nullptr;
+}
+
+int ZOrder::layer(const Window *window) const {
+    auto it = mEntries.find(window);
+    return it != mEntries.end() ? it->second.key.first : 0;
+}
+
+void ZOrder::reorder(Window *window, Entry &entry, Key key) {
+    mOrder.erase(entry.key);
+    entry.key = key;
+    mOrder[key] = window;
+}
+
+void ZOrder::collect(Window *window, std::vector<Window *> &result) const {
+    result.push_back(window);
+    std::vector<Window *> popups = mEntries.at(window).popups;
+    std::sort(popups.begin(), popups.end(), [&](const Window *a, const Window *b) {
+        return mEntries.at(a).key < mEntries.at(b).key;
+    });
+    for (Window *popup : popups)
+        collect(popup, result);
+}
+
+void ZOrder::setLayer(Window *window, int layer) {
+    if (!contains(window))
+        return;
+    std::vector<Window *> group;
+    collect(window, group);
+    for (Window *w : group) {
+        Entry &entry = mEntries[w];
+        reorder(w, entry, Key(layer, entry.key.second));
+    }
+}
+
+void ZOrder::raise(Window *window) {
+    if (!contains(window))
+        return;
+
+    /* Owners precede their popups, siblings keep their relative order */
+    std::vector<Window *> group;
+    collect(window, group);
+
+    int layer = mEntries[window].key.first;
+    for (Window *w : group)
+        reorder(w, mEntries[w], Key(layer, mCounter++));
+}
+
+std::vector<Window *> ZOrder::group(Window *window) const {
+    std::vector<Window *> result;
+    if (contains(window))
+        collect(window, result);
+    return result;
+}
+
+Window *ZOrder::above(const Window *window) const {
+    auto it = mEntries.find(window);
+    if (it == mEntries.end())
+        return nullptr;
+    auto next = mOrder.upper_bound(it->second.key);
+    return next != mOrder.end() ? next->second : nullptr;
+}
+
+std::vector<Window *> ZOrder::windows() const {
+    std::vector<Window *> result;
+    result.reserve(mOrder.size());
+    for (const auto &kv : mOrder)
+        result.push_back(kv.second);
+    return result;
+}
+
+NAMESPACE_END(nanogui)